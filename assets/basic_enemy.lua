@@ -1,161 +1,154 @@
-RoamingState = {}
+-- one copy of this script drives many enemies, so everything about an enemy lives in its own table (looked up by the id
+-- passed to each function) rather than in globals
+enemies = {}
+
+math.randomseed(os.time())
+
+function change_state(enemy, state)
+    enemy.state = state
+    state.enter(enemy)
+end
 
-function RoamingState:new()
-    next_animation = 'Walk'
-    change_animation = true
+RoamingState = {}
 
-    local o = {}
-    setmetatable(o, RoamingState)
-    RoamingState.__index = RoamingState
-    return o
+function RoamingState.enter(enemy)
+    enemy.next_animation = 'Walk'
+    enemy.change_animation = true
 end
 
-function RoamingState:update(enemy_position, player_position)
-    if (find_target == nil or find_target == true) then
-        target = Vector3(math.random(bounds_min_x, bounds_max_x), 0.0, math.random(bounds_min_z, bounds_max_z))
-        local dx = target:x() - enemy_position:x()
-        local dz = target:z() - enemy_position:z()
+function RoamingState.update(enemy, enemy_position, player_position)
+    if (enemy.find_target) then
+        enemy.target = Vector3(
+            math.random(enemy.bounds_min_x, enemy.bounds_max_x),
+            0.0,
+            math.random(enemy.bounds_min_z, enemy.bounds_max_z))
+        local dx = enemy.target:x() - enemy_position:x()
+        local dz = enemy.target:z() - enemy_position:z()
         local theta = math.atan(dx, dz)
 
-        orientation = Quaternion(Vector3(0.0, 1.0, 0.0), theta)
+        enemy.orientation = Quaternion(Vector3(0.0, 1.0, 0.0), theta)
 
-        find_target = false
+        enemy.find_target = false
     end
 
-    local walk_dir = target - enemy_position
+    local walk_dir = enemy.target - enemy_position
     walk_dir:normalise()
-    walk_direction = walk_dir
+    enemy.walk_direction = walk_dir
 
-    if ((target - enemy_position):magnitude() < 1.0) then
-        find_target = true
+    if ((enemy.target - enemy_position):magnitude() < 1.0) then
+        enemy.find_target = true
     end
 
-    local enemy_to_target = target - enemy_position
+    local enemy_to_target = enemy.target - enemy_position
     local enemy_to_player = player_position - enemy_position
     local theta = math.acos(enemy_to_target:dot(enemy_to_player) /
                                 (enemy_to_target:magnitude() * enemy_to_player:magnitude()))
 
     if (math.abs(theta) < math.pi / 4.0) then
-        state = HuntingState:new{}
+        change_state(enemy, HuntingState)
     end
 end
 
 HuntingState = {}
 
-function HuntingState:new()
-    find_target = true
-
-    local o = {}
-    setmetatable(o, HuntingState)
-    HuntingState.__index = HuntingState
-    return o
+function HuntingState.enter(enemy)
+    enemy.find_target = true
 end
 
-function HuntingState:update(enemy_position, player_position)
-    local walk_dir = player_position - enemy_position
-    local distance = walk_dir:magnitude()
-    walk_dir:normalise()
-    walk_direction = walk_dir
+function HuntingState.update(enemy, enemy_position, player_position, steering)
+    -- steering leads round walls, rather than straight at the player
+    local distance = (player_position - enemy_position):magnitude()
+    enemy.walk_direction = steering
 
     local dx = player_position:x() - enemy_position:x()
     local dz = player_position:z() - enemy_position:z()
     local theta = math.atan(dx, dz)
 
-    orientation = Quaternion(Vector3(0.0, 1.0, 0.0), theta)
+    enemy.orientation = Quaternion(Vector3(0.0, 1.0, 0.0), theta)
 
     local px = player_position:x()
     local pz = player_position:z()
 
-    if (px < bounds_min_x or px > bounds_max_x or pz < bounds_min_z or pz > bounds_max_z) then
-        state = RoamingState:new{}
+    if (px < enemy.bounds_min_x or px > enemy.bounds_max_x or pz < enemy.bounds_min_z or pz > enemy.bounds_max_z) then
+        change_state(enemy, RoamingState)
     elseif (distance < attack_distance) then
-        state = AttackingState:new{}
+        change_state(enemy, AttackingState)
     end
 end
 
 AttackingState = {}
 
-function AttackingState:new()
-    next_animation = 'Bite_Front'
-    change_animation = true
-    next_attack = elapsed_us + attack_rate
-
-    local o = {}
-    setmetatable(o, AttackingState)
-    AttackingState.__index = AttackingState
-    return o
+function AttackingState.enter(enemy)
+    enemy.next_animation = 'Bite_Front'
+    enemy.change_animation = true
+    enemy.next_attack = enemy.elapsed_us + attack_rate
 end
 
-function AttackingState:update(enemy_position, player_position)
+function AttackingState.update(enemy, enemy_position, player_position)
     local dx = player_position:x() - enemy_position:x()
     local dz = player_position:z() - enemy_position:z()
     local theta = math.atan(dx, dz)
 
-    orientation = Quaternion(Vector3(0.0, 1.0, 0.0), theta)
-    walk_direction = Vector3(0.0, 0.0, 0.0)
+    enemy.orientation = Quaternion(Vector3(0.0, 1.0, 0.0), theta)
+    enemy.walk_direction = Vector3(0.0, 0.0, 0.0)
 
     local distance = (player_position - enemy_position):magnitude()
     if (distance >= attack_distance) then
-        state = HuntingState:new{}
-    elseif (elapsed_us > next_attack) then
-        has_attacked = true
-        next_attack = elapsed_us + attack_rate
+        change_state(enemy, HuntingState)
+    elseif (enemy.elapsed_us > enemy.next_attack) then
+        enemy.has_attacked = true
+        enemy.next_attack = enemy.elapsed_us + attack_rate
     end
 end
 
-function init(bounds_min, bounds_max)
-    walk_direction = Vector3(-1.0, 0.0, 0.0)
-    orientation = Quaternion(Vector3(0.0, 1.0, 0.0), 0.0)
-    state = RoamingState.new()
-
-    bounds_min_x = bounds_min:x()
-    bounds_max_x = bounds_max:x()
-    bounds_min_z = bounds_min:z()
-    bounds_max_z = bounds_max:z()
-
-    change_animation = false
-    next_animation = ''
-
-    attack_distance = 2.5
-    has_attacked = false
-
-    elapsed_us = 0
-    attack_rate = 500000
-    next_attack = 0
+attack_distance = 2.5
+attack_rate = 500000
+
+function init(id, bounds_min, bounds_max)
+    local enemy = {
+        walk_direction = Vector3(-1.0, 0.0, 0.0),
+        orientation = Quaternion(Vector3(0.0, 1.0, 0.0), 0.0),
+        bounds_min_x = bounds_min:x(),
+        bounds_max_x = bounds_max:x(),
+        bounds_min_z = bounds_min:z(),
+        bounds_max_z = bounds_max:z(),
+        find_target = true,
+        change_animation = false,
+        next_animation = '',
+        has_attacked = false,
+        elapsed_us = 0,
+        next_attack = 0,
+        -- enemies start out walking, so there's no need to enter the state and change animation
+        state = RoamingState
+    }
+
+    enemies[id] = enemy
+end
 
-    math.randomseed(os.time())
+function release(id)
+    enemies[id] = nil
 end
 
-function update(enemy_position, player_position, elapsed, health)
-    elapsed_us = elapsed
+function tick(id, enemy_position, player_position, steering, elapsed, health)
+    local enemy = enemies[id]
+    enemy.elapsed_us = elapsed
 
     if (health <= 0.0) then
-        next_animation = 'Death_Back'
-        change_animation = true
-        walk_direction = Vector3(0.0, 0.0, 0.0)
+        enemy.next_animation = 'Death_Back'
+        enemy.change_animation = true
+        enemy.walk_direction = Vector3(0.0, 0.0, 0.0)
     else
-        state:update(enemy_position, player_position)
+        enemy.state.update(enemy, enemy_position, player_position, steering)
     end
-end
-
-function get_walk_direction()
-    return walk_direction
-end
 
-function get_orientation()
-    return orientation
-end
-
-function get_animation_change()
-    local change = change_animation
-    change_animation = false
-
-    return change, next_animation
-end
+    local animation = ''
+    if (enemy.change_animation) then
+        animation = enemy.next_animation
+        enemy.change_animation = false
+    end
 
-function attack_player()
-    local attack = has_attacked
-    has_attacked = false
+    local attack = enemy.has_attacked
+    enemy.has_attacked = false
 
-    return attack
+    return enemy.walk_direction, enemy.orientation, animation, attack
 end
@@ -0,0 +1,189 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "iris/core/vector3.h"
+
+#include "game_object.h"
+
+namespace trinket
+{
+
+/**
+ * Class for spreading the AI updates of a zone's enemies across ticks by their distance from the player:
+ *   - near enemies are updated every tick
+ *   - mid distance enemies are updated every N ticks, staggered (by a slot each enemy is given when first scheduled)
+ *     so the same share of them is updated each tick
+ *   - far enemies are updated round robin, as many each tick as fit in a fixed time budget
+ *
+ * Only objects in the AI phase with a cull position (i.e. enemies) are scheduled. A skipped enemy isn't updated at all,
+ * so its animation is throttled by the same rule, but isn't deactivated either so it keeps walking in the direction its
+ * AI last gave it.
+ *
+ * The cost of an enemy update is measured from the AI phase (see record_update_time), so the far budget is in frame
+ * time rather than cpu time and already accounts for enemies being updated in parallel.
+ */
+class AiScheduler
+{
+  public:
+    /**
+     * Number of enemies in, and updated from, each band in a single tick.
+     */
+    struct TickCounts
+    {
+        /** Number of near enemies (all of which are updated). */
+        std::size_t near;
+
+        /** Number of mid distance enemies updated. */
+        std::size_t mid;
+
+        /** Number of mid distance enemies. */
+        std::size_t mid_candidates;
+
+        /** Number of far enemies updated. */
+        std::size_t far;
+
+        /** Number of far enemies. */
+        std::size_t far_candidates;
+    };
+
+    /**
+     * Construct a new AiScheduler.
+     *
+     * @param near_distance
+     *   Distance from player within which enemies are updated every tick.
+     *
+     * @param far_distance
+     *   Distance from player beyond which enemies are updated within the far budget.
+     *
+     * @param mid_interval
+     *   Number of ticks between updates of enemies between the near and far distance.
+     *
+     * @param far_budget
+     *   Time each tick can spend updating far enemies (at least one far enemy is always updated).
+     *
+     * @param enabled
+     *   True if scheduling is enabled, otherwise every enemy is updated every tick.
+     */
+    AiScheduler(
+        float near_distance,
+        float far_distance,
+        std::uint32_t mid_interval,
+        std::chrono::microseconds far_budget,
+        bool enabled);
+
+    /**
+     * Remove the enemies which aren't due an update this tick, should be called once a tick. The order of the
+     * remaining objects is kept.
+     *
+     * @param objects
+     *   Objects to be updated this tick, sorted by update phase.
+     *
+     * @param player_position
+     *   Position of player.
+     */
+    void schedule(std::vector<GameObject *> &objects, const iris::Vector3 &player_position);
+
+    /**
+     * Record how long the AI phase took, to estimate how many far enemies fit in the budget.
+     *
+     * @param duration
+     *   Time taken to update objects.
+     *
+     * @param count
+     *   Number of objects updated.
+     */
+    void record_update_time(std::chrono::nanoseconds duration, std::size_t count);
+
+    /**
+     * Get the number of enemies updated in each band at the last schedule. These are also recorded every tick as
+     * profiler counters, so they can be lined up against slow frames in a trace.
+     *
+     * @returns
+     *   Counts for last tick.
+     */
+    const TickCounts &last_tick() const;
+
+    /**
+     * Log the number of enemies updated in each band averaged over all ticks, and the most updated in a single tick.
+     */
+    void log_stats() const;
+
+  private:
+    /**
+     * Enumeration of distance bands, in the order objects are classified.
+     */
+    enum class Band : std::uint8_t
+    {
+        UNSCHEDULED,
+        NEAR,
+        MID,
+        FAR
+    };
+
+    /** Squared distance within which enemies are near. */
+    float near_distance_sq_;
+
+    /** Squared distance beyond which enemies are far. */
+    float far_distance_sq_;
+
+    /** Number of ticks between mid distance updates. */
+    std::uint32_t mid_interval_;
+
+    /** Time each tick can spend updating far enemies. */
+    std::chrono::nanoseconds far_budget_;
+
+    /** Flag indicating if scheduling is enabled. */
+    bool enabled_;
+
+    /** Band of each object at the last schedule, reused to avoid allocating every tick. */
+    std::vector<Band> bands_;
+
+    /** Tick offset (in [0, mid_interval_)) of each enemy which has been in the mid band. */
+    std::unordered_map<const GameObject *, std::uint32_t> slots_;
+
+    /** Slot to give the next enemy to enter the mid band. */
+    std::uint32_t next_slot_;
+
+    /** Moving average of the frame time of a single AI update. */
+    std::chrono::nanoseconds update_cost_;
+
+    /** Number of far enemies passed by the round robin. */
+    std::size_t far_cursor_;
+
+    /** Number of times schedule has been called. */
+    std::uint64_t ticks_;
+
+    /** Counts for the last tick. */
+    TickCounts last_tick_;
+
+    /** Most enemies updated (in all bands) in a single tick. */
+    std::size_t peak_updated_;
+
+    /** Sum of near enemies updated across all ticks. */
+    std::uint64_t near_total_;
+
+    /** Sum of mid distance enemies updated across all ticks. */
+    std::uint64_t mid_total_;
+
+    /** Sum of mid distance enemies across all ticks. */
+    std::uint64_t mid_candidates_total_;
+
+    /** Sum of far enemies updated across all ticks. */
+    std::uint64_t far_total_;
+
+    /** Sum of far enemies across all ticks. */
+    std::uint64_t far_candidates_total_;
+};
+
+}
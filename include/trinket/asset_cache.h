@@ -0,0 +1,231 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <variant>
+
+#include "iris/core/colour.h"
+#include "iris/graphics/cube_map.h"
+#include "iris/graphics/mesh_manager.h"
+#include "iris/graphics/texture_manager.h"
+
+namespace trinket
+{
+
+/**
+ * Enumeration of asset kinds held by the AssetCache.
+ */
+enum class AssetKind : std::uint8_t
+{
+    MESH,
+    TEXTURE,
+    SKY_BOX,
+};
+
+/**
+ * Singleton class for caching assets across zones, so moving between zones (or restarting one) doesn't decode and
+ * upload the same assets again.
+ *
+ * Every asset acquired whilst a zone is running holds a reference until end_zone is called, as all of a zone's objects
+ * are destroyed together. Unreferenced assets stay cached until the total estimated size exceeds the budget, at which
+ * point the least recently used are released. Referenced assets are never evicted, so the budget can be exceeded if a
+ * single zone needs more.
+ *
+ * Skinned meshes are not cached as every instance needs its own skeleton to animate.
+ *
+ * Must only be used from the main thread.
+ */
+class AssetCache
+{
+  public:
+    /**
+     * Get the single instance of this class.
+     *
+     * @returns
+     *   Single instance.
+     */
+    static AssetCache &instance();
+
+    AssetCache(const AssetCache &) = delete;
+    AssetCache &operator=(const AssetCache &) = delete;
+
+    /**
+     * Set the size unreferenced assets are evicted down to.
+     *
+     * @param bytes
+     *   Budget in bytes.
+     */
+    void set_budget(std::size_t bytes);
+
+    /**
+     * Get a mesh (and any animations and skeleton), loading it if needed.
+     *
+     * @param name
+     *   Mesh resource to load.
+     *
+     * @returns
+     *   Loaded mesh data.
+     */
+    iris::MeshLoadData mesh(const std::string &name);
+
+    /**
+     * Get a texture, loading it if needed. Textures are cached per sampler, so requesting the same texture with a
+     * different sampler loads it again.
+     *
+     * @param name
+     *   Texture resource to load.
+     *
+     * @param sampler
+     *   Sampler to load texture with, nullptr for default.
+     *
+     * @returns
+     *   Loaded texture.
+     */
+    const iris::Texture *texture(const std::string &name, const iris::Sampler *sampler = nullptr);
+
+    /**
+     * Get a generated gradient sky box, creating it if needed.
+     *
+     * @param top
+     *   Colour at top of sky box.
+     *
+     * @param bottom
+     *   Colour at bottom of sky box.
+     *
+     * @param width
+     *   Width of each face.
+     *
+     * @param height
+     *   Height of each face.
+     *
+     * @returns
+     *   Sky box.
+     */
+    const iris::CubeMap *sky_box(
+        const iris::Colour &top,
+        const iris::Colour &bottom,
+        std::uint32_t width,
+        std::uint32_t height);
+
+    /**
+     * Release all references held by the current zone and evict least recently used assets until within budget.
+     */
+    void end_zone();
+
+    /**
+     * Log hit and miss statistics.
+     */
+    void log_stats() const;
+
+  private:
+    /**
+     * Internal struct for a cached asset.
+     */
+    struct Entry
+    {
+        /** The asset. */
+        std::variant<iris::MeshLoadData, const iris::Texture *, const iris::CubeMap *> asset;
+
+        /** Kind of asset. */
+        AssetKind kind;
+
+        /** Estimated size in bytes. */
+        std::size_t bytes;
+
+        /** Number of times asset was acquired in the current zone. */
+        std::uint32_t references;
+
+        /** Position in lru_. */
+        std::list<std::string>::iterator lru_position;
+    };
+
+    /**
+     * Internal struct for statistics about an asset kind.
+     */
+    struct KindStats
+    {
+        /** Number of requests for an asset already cached. */
+        std::uint64_t hits;
+
+        /** Number of requests which had to load the asset. */
+        std::uint64_t misses;
+
+        /** Number of assets evicted. */
+        std::uint64_t evictions;
+    };
+
+    /**
+     * Construct a new AssetCache.
+     */
+    AssetCache();
+
+    /**
+     * Look up an asset, recording a hit and reference if found.
+     *
+     * @param key
+     *   Key of asset.
+     *
+     * @param kind
+     *   Kind of asset (for statistics).
+     *
+     * @returns
+     *   Entry if found, otherwise nullptr.
+     */
+    Entry *find(const std::string &key, AssetKind kind);
+
+    /**
+     * Add a newly loaded asset, recording a miss and reference.
+     *
+     * @param key
+     *   Key of asset.
+     *
+     * @param kind
+     *   Kind of asset.
+     *
+     * @param asset
+     *   Loaded asset.
+     *
+     * @param bytes
+     *   Estimated size of asset.
+     *
+     * @returns
+     *   New entry.
+     */
+    Entry &insert(
+        const std::string &key,
+        AssetKind kind,
+        std::variant<iris::MeshLoadData, const iris::Texture *, const iris::CubeMap *> asset,
+        std::size_t bytes);
+
+    /**
+     * Evict least recently used unreferenced assets until within budget (or there is nothing left to evict).
+     */
+    void evict();
+
+    /** Cached assets, keyed on kind and name. */
+    std::unordered_map<std::string, Entry> entries_;
+
+    /** Keys of cached assets, most recently used at the front. */
+    std::list<std::string> lru_;
+
+    /** Statistics for each asset kind. */
+    std::array<KindStats, 3u> stats_;
+
+    /** Estimated size of all cached assets. */
+    std::size_t bytes_;
+
+    /** Size to evict unreferenced assets down to. */
+    std::size_t budget_;
+};
+
+}
@@ -0,0 +1,231 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "iris/core/vector3.h"
+#include "iris/graphics/render_pipeline.h"
+#include "iris/graphics/scene.h"
+#include "iris/physics/physics_system.h"
+
+#include "game_object.h"
+#include "job_system.h"
+#include "mapped_file.h"
+#include "nav_grid.h"
+#include "player.h"
+#include "script_pool.h"
+#include "third_person_camera.h"
+#include "zone_cells.h"
+#include "zone_format.h"
+#include "zone_loader.h"
+
+namespace trinket
+{
+
+/**
+ * Implementation of ZoneLoader for cooked zone files (see zone_format.h). The file is mapped into memory and used in
+ * place, so there is no parsing, string comparisons or mesh processing when loading.
+ */
+class BinaryZoneLoader : public ZoneLoader
+{
+  public:
+    /**
+     * Create a new BinaryZoneLoader.
+     *
+     * @param zone_file
+     *   Path of cooked zone file.
+     *
+     * @param merge_static_bodies
+     *   True if touching static boxes should be merged into single bodies.
+     */
+    BinaryZoneLoader(const std::filesystem::path &zone_file, bool merge_static_bodies);
+
+    /**
+     * Get the name of the zone.
+     *
+     * @returns
+     *   Zone name.
+     */
+    std::string name() override;
+
+    /**
+     * Get player start position.
+     *
+     * @returns
+     *   Player start position.
+     */
+    iris::Vector3 player_start_position() override;
+
+    /**
+     * Load static geometry.
+     *
+     * @param ps
+     *   Physics system.
+     *
+     * @param scene
+     *   Scene to load into, nullptr if headless (only physics data will be loaded).
+     *
+     * @param render_pipeline
+     *   Render pipeline to use, nullptr if headless.
+     *
+     * @param cells
+     *   Cells to add static instances to, they create the render entities.
+     *
+     * @param nav
+     *   Navigation grid to add static bodies to.
+     *
+     * @param jobs
+     *   Job system for stages of loading which can run in parallel.
+     */
+    void load_static_geometry(
+        iris::PhysicsSystem *ps,
+        iris::Scene *scene,
+        iris::RenderPipeline *render_pipeline,
+        ZoneCells &cells,
+        NavGrid &nav,
+        JobSystem &jobs) override;
+
+    /**
+     * Load enemies.
+     *
+     * @param ps
+     *   Physics system.
+     *
+     * @param scene
+     *   Scene to load into, nullptr if headless (only physics data will be loaded).
+     *
+     * @param render_pipeline
+     *   Render pipeline to use, nullptr if headless.
+     *
+     * @param game_objects
+     *   Collection of game objects to add enemies to.
+     *
+     * @param player
+     *   Pointer to player object.
+     *
+     * @param camera
+     *   Pointer to camera object, nullptr if headless.
+     *
+     * @param nav
+     *   Navigation grid enemies steer towards the player with.
+     *
+     * @param scripts
+     *   Pool to load and create enemy scripts from.
+     *
+     * @param jobs
+     *   Job system for stages of loading which can run in parallel.
+     */
+    void load_enemies(
+        iris::PhysicsSystem *ps,
+        iris::Scene *scene,
+        iris::RenderPipeline *render_pipeline,
+        std::vector<std::unique_ptr<GameObject>> &game_objects,
+        Player *player,
+        ThirdPersonCamera *camera,
+        const NavGrid &nav,
+        ScriptPool &scripts,
+        JobSystem &jobs) override;
+
+    /**
+     * Get portal data.
+     *
+     * @returns
+     *   Tuple of portal transform and name of next zone.
+     */
+    std::tuple<iris::Transform, std::string> portal() override;
+
+    /**
+     * Get all resource files used by the zone, so they can be read ahead of the zone being loaded. This only parses
+     * zone data so is cheap to call.
+     *
+     * @returns
+     *   Collection of resource files (relative to resource root).
+     */
+    std::vector<std::string> resource_files() override;
+
+    /**
+     * Start preloading the zone from its first step, must be called before preload_step.
+     */
+    void begin_preload() override;
+
+    /**
+     * Perform the next step of preloading the zone, this warms engine caches (e.g. decoding and uploading a mesh) so
+     * they are hits when the zone is actually loaded. Each step is small enough to be run during a frame.
+     *
+     * Must be called from the main thread.
+     *
+     * @returns
+     *   True if there are more steps to perform, false if preloading is complete.
+     */
+    bool preload_step() override;
+
+  private:
+    /**
+     * Check every index, span and string in the file refers to a record in its section, throws if not. Sections must
+     * already have been checked to lie within the file.
+     */
+    void validate() const;
+
+    /**
+     * Get the records of a section.
+     *
+     * @param section
+     *   Section to get.
+     *
+     * @returns
+     *   Span of records.
+     */
+    template <class T>
+    std::span<const T> records(const ZoneSection &section) const
+    {
+        return {reinterpret_cast<const T *>(file_.data() + section.offset), section.count};
+    }
+
+    /**
+     * Get a string from the string section.
+     *
+     * @param str
+     *   String to get.
+     *
+     * @returns
+     *   View of string data.
+     */
+    std::string_view string(const ZoneString &str) const;
+
+    /**
+     * Load the meshes for every part in the zone.
+     *
+     * @returns
+     *   Mesh for each part, indexed by ZoneMesh::first_part + part.
+     */
+    std::vector<const iris::Mesh *> load_parts() const;
+
+    /** Mapped zone file. */
+    MappedFile file_;
+
+    /** Header of zone file. */
+    const ZoneFileHeader *header_;
+
+    /** Flag indicating if touching static boxes should be merged. */
+    bool merge_static_bodies_;
+
+    /** Preloading steps, created on first call to preload_step. */
+    std::vector<std::function<void()>> preload_steps_;
+
+    /** Index of next preloading step. */
+    std::size_t next_preload_step_;
+};
+
+}
@@ -75,8 +75,8 @@ class CharacterController : public iris::BasicCharacterController
     /** Flag indicating if character is currently being shunted. */
     bool is_being_shunted_;
 
-    /** Time when character can be shunted again. */
-    std::chrono::system_clock::time_point shunt_end_;
+    /** Simulation time left before character can be shunted again. */
+    std::chrono::milliseconds shunt_remaining_;
 
     /** Store of movement direction. */
     iris::Vector3 saved_movement_direction_;
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <cstdint>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -67,6 +68,17 @@ class Config
      *   Option as a collection of strings.
      */
     virtual std::vector<std::string> string_array_option(ConfigOption option) = 0;
+
+    /**
+     * Get option as a map of strings to strings.
+     *
+     * @param option
+     *   Option to get.
+     *
+     * @returns
+     *   Option as a map of strings.
+     */
+    virtual std::map<std::string, std::string> string_map_option(ConfigOption option) = 0;
 };
 
 }
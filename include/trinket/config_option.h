@@ -20,6 +20,28 @@ enum class ConfigOption
     PHYSICS_DEBUG_DRAW,
     ZONE_LOADERS,
     STARTING_ZONE,
+    QUEUED_MESSAGES,
+    MESSAGE_STATS,
+    COALESCE_INPUT,
+    WORKER_THREADS,
+    TICK_RATE,
+    HEADLESS,
+    HEADLESS_REALTIME,
+    HEADLESS_TICKS,
+    PROFILER,
+    ASSET_CACHE_MB,
+    MERGE_STATIC_BODIES,
+    CELL_CULLING,
+    CELL_SIZE,
+    ACTIVE_CELL_RADIUS,
+    AI_LOD,
+    AI_NEAR_DISTANCE,
+    AI_FAR_DISTANCE,
+    AI_MID_INTERVAL,
+    AI_FAR_BUDGET_US,
+    NAVIGATION,
+    NAV_CELL_SIZE,
+    NAV_MAX_DISTANCE,
 };
 
 }
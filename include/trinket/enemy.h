@@ -6,9 +6,9 @@
 
 #pragma once
 
-#include <any>
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -19,15 +19,20 @@
 #include "iris/graphics/single_entity.h"
 #include "iris/physics/physics_system.h"
 #include "iris/physics/rigid_body.h"
-#include "iris/scripting/script_runner.h"
 
 #include "character_controller.h"
+#include "enemy_ai.h"
+#include "enemy_decision.h"
 #include "game_object.h"
+#include "message_data.h"
 #include "message_type.h"
+#include "nav_grid.h"
 #include "player.h"
 #include "publisher.h"
 #include "subscriber.h"
 #include "third_person_camera.h"
+#include "transform_interpolator.h"
+#include "update_phase.h"
 
 namespace trinket
 {
@@ -35,7 +40,7 @@ namespace trinket
 /**
  * Implementation of GameObject for an enemy, logic is driven via a lua script.
  */
-class Enemy : public GameObject, Subscriber, Publisher
+class Enemy : public GameObject, public Subscriber, Publisher
 {
   public:
     /**
@@ -44,43 +49,51 @@ class Enemy : public GameObject, Subscriber, Publisher
      * @param ps
      *   Physis system.
      *
-     * @param script_file
-     *   Path to script resource.
+     * @param ai
+     *   AI for enemy.
+     *
+     * @param start_position
+     *   Position to start enemy at.
      *
      * @param render_entity
-     *   Render entity of enemy.
+     *   Render entity of enemy, nullptr if headless.
      *
      * @param health_bar
-     *   Render entity o health bar.
+     *   Render entity o health bar, nullptr if headless.
      *
      * @param animations
-     *   Collection of animations for enemy.
-     *
-     * @param bounds_min
-     *   Minimum bounds of enemy patrol zone.
-     *
-     * @param bounds_max
-     *   Maximum bounds of enemy patrol zone.
+     *   Collection of animations for enemy, ignored if headless.
      *
      * @param player
      *   Pointer to player object.
      *
+     * @param nav
+     *   Navigation grid to steer towards the player with.
+     *
      * @param camera
-     *   Pointer to camera object.
+     *   Pointer to camera object, nullptr if headless.
      */
     Enemy(
         iris::PhysicsSystem *ps,
-        const std::string &script_file,
+        std::unique_ptr<EnemyAi> ai,
+        const iris::Vector3 &start_position,
         iris::SingleEntity *render_entity,
         iris::SingleEntity *health_bar,
         std::vector<iris::Animation> animations,
-        const iris::Vector3 &bounds_min,
-        const iris::Vector3 &bounds_max,
         const Player *player,
+        const NavGrid &nav,
         const ThirdPersonCamera *camera);
 
     /**
-     * Update object.
+     * Run the enemy's AI, may be called from any thread.
+     *
+     * @param elapsed
+     *   Time since last update.
+     */
+    void prepare(std::chrono::microseconds elapsed) override;
+
+    /**
+     * Update object, applying the decision made in prepare.
      *
      * @param elapsed
      *   Time since last update.
@@ -88,15 +101,36 @@ class Enemy : public GameObject, Subscriber, Publisher
     void update(std::chrono::microseconds elapsed) override;
 
     /**
-     * Message handler.
+     * Get the phase of the frame this object should be updated in.
+     *
+     * @returns
+     *   Update phase.
+     */
+    UpdatePhase update_phase() const override;
+
+    /**
+     * Add anything this object renders, and which moves, to an interpolator so it is rendered smoothly between ticks.
+     *
+     * @param interpolator
+     *   Interpolator to add to.
+     */
+    void add_interpolated(TransformInterpolator &interpolator) override;
+
+    /**
+     * Check if this object can be updated at the same time as other parallel objects in its phase.
      *
-     * @param message_type
-     *   Type of message being sent.
+     * @returns
+     *   True, the AI decision only reads shared state (shared scripts are locked by EnemyScript).
+     */
+    bool is_parallel() const override;
+
+    /**
+     * Handle weapon collision message.
      *
-     * @param data
-     *   Any data for the message.
+     * @param message
+     *   Message data.
      */
-    void handle_message(MessageType message_type, const std::any &data) override;
+    void handle_message(const Message<MessageType::WEAPON_COLLISION> &message);
 
     /**
      * Get position on enemy.
@@ -106,9 +140,25 @@ class Enemy : public GameObject, Subscriber, Publisher
      */
     iris::Vector3 position() const;
 
+    /**
+     * Get the position used to decide if this object is near enough to the player (or in view) to be updated.
+     *
+     * @returns
+     *   Enemy position.
+     */
+    std::optional<iris::Vector3> cull_position() const override;
+
+    /**
+     * Set whether the enemy is being updated, an inactive enemy stops walking.
+     *
+     * @param active
+     *   True if enemy will be updated this tick.
+     */
+    void set_active(bool active) override;
+
   private:
-    /** Script runner for enemy AI. */
-    iris::ScriptRunner script_;
+    /** AI for enemy. */
+    std::unique_ptr<EnemyAi> ai_;
 
     /** Render entity for enemy. */
     iris::SingleEntity *render_entity_;
@@ -125,20 +175,35 @@ class Enemy : public GameObject, Subscriber, Publisher
     /** Pointer to player object. */
     const Player *player_;
 
+    /** Navigation grid to steer towards the player with. */
+    const NavGrid &nav_;
+
+    /** Decision made by the AI in prepare, applied in update. */
+    EnemyDecision decision_;
+
     /** Pointer to camera object. */
     const ThirdPersonCamera *camera_;
 
-    /** Cooldown timer between being hit. */
-    std::chrono::system_clock::time_point hit_cooldown_;
+    /** Simulation time when enemy can next be hit. */
+    std::chrono::microseconds hit_cooldown_;
+
+    /** Simulation time of last update. */
+    std::chrono::microseconds sim_time_;
 
     /** Scale of health bar entity. */
     iris::Vector3 health_bar_scale_;
 
+    /** Position of enemy. */
+    iris::Vector3 position_;
+
     /** Health of enemy. */
     float health_;
 
     /** Flag indicating if enemy is dead. */
     bool is_dead_;
+
+    /** Flag indicating if enemy is being updated. */
+    bool active_;
 };
 
 }
@@ -0,0 +1,65 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+
+#include "iris/core/vector3.h"
+
+#include "enemy_decision.h"
+
+namespace trinket
+{
+
+/**
+ * Interface for the AI driving a single enemy, either a lua script (see ScriptPool) or native code (see NativeAi).
+ */
+class EnemyAi
+{
+  public:
+    virtual ~EnemyAi() = default;
+
+    /**
+     * Decide what the enemy does this tick. May be called from any thread.
+     *
+     * @param position
+     *   Position of enemy.
+     *
+     * @param player_position
+     *   Position of player.
+     *
+     * @param steering
+     *   Direction to walk to reach the player around static geometry.
+     *
+     * @param elapsed
+     *   Simulation time.
+     *
+     * @param health
+     *   Health of enemy.
+     *
+     * @returns
+     *   Decision for this tick.
+     */
+    virtual EnemyDecision tick(
+        const iris::Vector3 &position,
+        const iris::Vector3 &player_position,
+        const iris::Vector3 &steering,
+        std::chrono::microseconds elapsed,
+        float health) = 0;
+
+    /**
+     * Called after the enemy has moved in a tick, with the position it will pass to its next tick.
+     *
+     * @param position
+     *   New position of enemy.
+     */
+    virtual void moved(const iris::Vector3 &)
+    {
+    }
+};
+
+}
@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "iris/core/quaternion.h"
+#include "iris/core/vector3.h"
+#include "iris/scripting/script_runner.h"
+
+namespace trinket
+{
+
+/**
+ * Everything an enemy's AI decides in a single tick.
+ */
+struct EnemyDecision
+{
+    /** Direction to walk in, zero to stand still. */
+    iris::Vector3 walk_direction;
+
+    /** Orientation to face. */
+    iris::Quaternion orientation;
+
+    /** Animation to change to, empty if the animation shouldn't change. */
+    std::string animation;
+
+    /** Flag indicating if the enemy attacks the player this tick. */
+    bool attack;
+};
+
+/**
+ * Run one tick of an enemy script.
+ *
+ * Scripts implement a single function, called once per tick, so all inputs and outputs cross the lua boundary in one
+ * call:
+ *
+ *   function tick(id, enemy_position, player_position, steering, elapsed, health)
+ *       return walk_direction, orientation, animation, attack
+ *   end
+ *
+ * Where id identifies the enemy (as a script may be shared by many), steering is the direction to walk to reach the
+ * player around static geometry (see NavGrid) and animation is an empty string if the animation shouldn't change.
+ *
+ * @param script
+ *   Script to run.
+ *
+ * @param id
+ *   Id of enemy in script.
+ *
+ * @param position
+ *   Position of enemy.
+ *
+ * @param player_position
+ *   Position of player.
+ *
+ * @param steering
+ *   Direction to walk to reach the player around static geometry.
+ *
+ * @param elapsed
+ *   Simulation time.
+ *
+ * @param health
+ *   Health of enemy.
+ *
+ * @returns
+ *   Decision made by script.
+ */
+EnemyDecision tick_script(
+    iris::ScriptRunner &script,
+    std::int32_t id,
+    const iris::Vector3 &position,
+    const iris::Vector3 &player_position,
+    const iris::Vector3 &steering,
+    std::chrono::microseconds elapsed,
+    float health);
+
+}
@@ -6,18 +6,34 @@
 
 #pragma once
 
-#include <any>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "iris/graphics/window.h"
+#include "iris/physics/physics_system.h"
 #include "iris/physics/rigid_body.h"
 
+#include "ai_scheduler.h"
 #include "config.h"
+#include "game_object.h"
+#include "hud.h"
+#include "input_handler.h"
+#include "job_system.h"
+#include "message_broker.h"
+#include "message_data.h"
 #include "message_type.h"
+#include "nav_grid.h"
+#include "player.h"
+#include "script_pool.h"
 #include "subscriber.h"
+#include "third_person_camera.h"
 #include "zone_loader.h"
+#include "zone_cells.h"
+#include "zone_preloader.h"
+#include "zone_registry.h"
 
 namespace trinket
 {
@@ -43,10 +59,10 @@ class Game : public Subscriber
      * @param config
      *   Config to use for the game.
      *
-     * @param zone_loaders
-     *   Zone loaders for all possible zones.
+     * @param zones
+     *   Registry of all possible zones.
      */
-    Game(std::unique_ptr<Config> config, std::vector<std::unique_ptr<ZoneLoader>> &&zone_loaders);
+    Game(std::unique_ptr<Config> config, std::unique_ptr<ZoneRegistry> zones);
 
     /**
      * Blocks and runs the game. Will return when the game exits.
@@ -54,15 +70,28 @@ class Game : public Subscriber
     void run();
 
     /**
-     * Message handler.
+     * Handle quit message.
      *
-     * @param message_type
-     *   Type of message being sent.
+     * @param message
+     *   Message data.
+     */
+    void handle_message(const Message<MessageType::QUIT> &message);
+
+    /**
+     * Handle key press message.
+     *
+     * @param message
+     *   Message data.
+     */
+    void handle_message(const Message<MessageType::KEY_PRESS> &message);
+
+    /**
+     * Handle player died message.
      *
-     * @param data
-     *   Any data for the message.
+     * @param message
+     *   Message data.
      */
-    void handle_message(MessageType message_type, const std::any &data) override;
+    void handle_message(const Message<MessageType::PLAYER_DIED> &message);
 
   private:
     /**
@@ -70,14 +99,122 @@ class Game : public Subscriber
      */
     void run_zone();
 
+    /**
+     * Execute the game for the current selected zone without a window or renderer. The simulation is stepped with the
+     * same fixed tick as run_zone, either as fast as possible or in real time.
+     */
+    void run_headless_zone();
+
+    /**
+     * Create the objects which live across all zones (player, camera, HUD, input and quests). Only the player and
+     * quests are created when headless.
+     *
+     * @param hud_width
+     *   Width of HUD render target.
+     *
+     * @param hud_height
+     *   Height of HUD render target.
+     */
+    void create_persistent_objects(std::uint32_t hud_width, std::uint32_t hud_height);
+
+    /**
+     * Advance the simulation by one fixed tick: step physics, check the portal and update all game objects.
+     *
+     * @param objects
+     *   Objects to update, must be sorted by update phase.
+     *
+     * @param ps
+     *   Physics system for zone.
+     *
+     * @param player
+     *   Player, used to check for portal collisions.
+     *
+     * @param cells
+     *   Cells of zone, used to decide which objects are updated.
+     *
+     * @param ai
+     *   AI scheduler of zone, used to decide which active enemies are updated.
+     *
+     * @param nav
+     *   Navigation grid of zone, updated with the player's position.
+     *
+     * @param elapsed
+     *   Simulation time at the start of the tick.
+     *
+     * @param delta
+     *   Length of tick.
+     */
+    void simulate(
+        std::vector<GameObject *> &objects,
+        iris::PhysicsSystem *ps,
+        const Player *player,
+        ZoneCells &cells,
+        AiScheduler &ai,
+        NavGrid &nav,
+        std::chrono::microseconds elapsed,
+        std::chrono::microseconds delta);
+
+    /**
+     * Create the cells for a zone from the config.
+     *
+     * @param scene
+     *   Scene cells create entities in, nullptr if headless.
+     *
+     * @returns
+     *   Zone cells.
+     */
+    ZoneCells create_cells(iris::Scene *scene) const;
+
+    /**
+     * Create the AI scheduler for a zone from the config.
+     *
+     * @returns
+     *   AI scheduler.
+     */
+    AiScheduler create_ai_scheduler() const;
+
+    /**
+     * Create the navigation grid for a zone from the config.
+     *
+     * @returns
+     *   Navigation grid.
+     */
+    NavGrid create_nav_grid() const;
+
+    /**
+     * Get the length of a fixed simulation tick from the config.
+     *
+     * @returns
+     *   Tick length.
+     */
+    std::chrono::microseconds tick_length() const;
+
+    /**
+     * Update all game objects. Objects are updated in order, except runs of parallel objects in the same phase which
+     * are updated together on the job system.
+     *
+     * @param objects
+     *   Objects to update, must be sorted by update phase.
+     *
+     * @param ai
+     *   AI scheduler to report the time taken by the AI phase to.
+     *
+     * @param elapsed
+     *   Time since last update.
+     */
+    void update_objects(std::vector<GameObject *> &objects, AiScheduler &ai, std::chrono::microseconds elapsed);
+
     /** Flag indicating if the game should keep running or exit. */
     bool running_;
 
+    /** Flag indicating if the game is running without a window or renderer. */
+    bool headless_;
+
     /** Config for the game. */
     std::unique_ptr<Config> config_;
 
-    /** Loaders for all possible game zones. */
-    std::vector<std::unique_ptr<ZoneLoader>> zone_loaders_;
+    /** Registry of all possible game zones. */
+    std::unique_ptr<ZoneRegistry> zones_;
 
     /** Current game zone. */
     ZoneLoader *current_zone_;
@@ -94,6 +231,42 @@ class Game : public Subscriber
     /** Name of zone to load when colliding with portal. */
     std::string portal_destination_;
 
+    /** Job system for updating objects in parallel. */
+    std::unique_ptr<JobSystem> jobs_;
+
+    /** Compiled enemy scripts, shared across zones. */
+    std::unique_ptr<ScriptPool> scripts_;
+
+    /** Messages captured from each object in a parallel update, kept around to reuse allocations. */
+    std::vector<CapturedMessages> captured_messages_;
+
+    /** Objects being updated this tick, kept around to reuse allocations. */
+    std::vector<GameObject *> active_objects_;
+
+    /** Number of ticks simulated whilst headless, across all zones. */
+    std::uint64_t simulated_ticks_;
+
+    /** Simulation time not yet stepped by physics, which only steps in whole milliseconds. */
+    std::chrono::microseconds physics_remainder_;
+
+    /** Preloads the zone the portal leads to whilst the current zone is played. */
+    std::unique_ptr<ZonePreloader> preloader_;
+
+    /** Input handler, kept separate as queued input is delivered before updating everything else. */
+    std::unique_ptr<InputHandler> input_handler_;
+
+    /** Objects which live across all zones, so their state carries over. */
+    std::vector<std::unique_ptr<GameObject>> persistent_objects_;
+
+    /** Player (owned by persistent_objects_). */
+    Player *player_;
+
+    /** Camera following player, nullptr when headless (owned by persistent_objects_). */
+    ThirdPersonCamera *camera_;
+
+    /** HUD, nullptr when headless (owned by persistent_objects_). */
+    HUD *hud_;
+
     /** Current game state. */
     GameState state_;
 };
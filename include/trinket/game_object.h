@@ -7,6 +7,12 @@
 #pragma once
 
 #include <chrono>
+#include <optional>
+
+#include "iris/core/vector3.h"
+
+#include "transform_interpolator.h"
+#include "update_phase.h"
 
 namespace trinket
 {
@@ -26,6 +32,70 @@ class GameObject
      *   Time since last update.
      */
     virtual void update(std::chrono::microseconds elapsed) = 0;
+
+    /**
+     * Get the phase of the frame this object should be updated in.
+     *
+     * @returns
+     *   Update phase.
+     */
+    virtual UpdatePhase update_phase() const = 0;
+
+    /**
+     * Check if this object has work which can be done at the same time as other parallel objects in its phase. Such an
+     * object has prepare called on a worker thread, and then update called on the main thread in object order.
+     *
+     * @returns
+     *   True if object can be prepared in parallel, otherwise false.
+     */
+    virtual bool is_parallel() const
+    {
+        return false;
+    }
+
+    /**
+     * Do the part of this tick's update which can run in parallel, only called if is_parallel returns true. It must
+     * only read shared state and modify the object's own, the engine (physics, rendering) isn't thread safe so anything
+     * which touches it belongs in update (messages it publishes are captured and delivered afterwards).
+     *
+     * @param elapsed
+     *   Time since last update.
+     */
+    virtual void prepare(std::chrono::microseconds)
+    {
+    }
+
+    /**
+     * Add anything this object renders, and which moves, to an interpolator so it is rendered smoothly between ticks.
+     *
+     * @param interpolator
+     *   Interpolator to add to.
+     */
+    virtual void add_interpolated(TransformInterpolator &)
+    {
+    }
+
+    /**
+     * Get the position used to decide if this object is near enough to the player (or in view) to be updated.
+     *
+     * @returns
+     *   Position, or empty optional if the object should always be updated.
+     */
+    virtual std::optional<iris::Vector3> cull_position() const
+    {
+        return std::nullopt;
+    }
+
+    /**
+     * Called every tick, for objects with a cull position, with whether the object will be updated. An object that
+     * isn't being updated should stop anything it would otherwise keep doing (e.g. walking).
+     *
+     * @param active
+     *   True if object will be updated this tick.
+     */
+    virtual void set_active(bool)
+    {
+    }
 };
 
 }
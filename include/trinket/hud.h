@@ -6,7 +6,6 @@
 
 #pragma once
 
-#include <any>
 #include <chrono>
 #include <cstdint>
 
@@ -18,8 +17,10 @@
 #include "iris/graphics/single_entity.h"
 
 #include "game_object.h"
+#include "message_data.h"
 #include "message_type.h"
 #include "subscriber.h"
+#include "update_phase.h"
 
 namespace trinket
 {
@@ -27,7 +28,7 @@ namespace trinket
 /**
  * Game object for displaying a HUD (health and xp).
  */
-class HUD : public GameObject, Subscriber
+class HUD : public GameObject, public Subscriber
 {
   public:
     /**
@@ -41,11 +42,16 @@ class HUD : public GameObject, Subscriber
      *
      * @param height
      *   Screen height.
+     */
+    HUD(float starting_health, std::uint32_t width, std::uint32_t height);
+
+    /**
+     * Bind the HUD to a newly loaded zone, creating its elements to show the current health and level progress.
      *
      * @param scene
      *   Scene to create HUD elements in.
      */
-    HUD(float starting_health, std::uint32_t width, std::uint32_t height, iris::Scene *scene);
+    void bind(iris::Scene *scene);
 
     /**
      * Update object.
@@ -56,17 +62,40 @@ class HUD : public GameObject, Subscriber
     void update(std::chrono::microseconds) override;
 
     /**
-     * Message handler.
+     * Get the phase of the frame this object should be updated in.
      *
-     * @param message_type
-     *   Type of message being sent.
+     * @returns
+     *   Update phase.
+     */
+    UpdatePhase update_phase() const override;
+
+    /**
+     * Handle player health change message.
+     *
+     * @param message
+     *   Message data.
+     */
+    void handle_message(const Message<MessageType::PLAYER_HEALTH_CHANGE> &message);
+
+    /**
+     * Handle level progress message.
      *
-     * @param data
-     *   Any data for the message.
+     * @param message
+     *   Message data.
      */
-    void handle_message(MessageType message_type, const std::any &data) override;
+    void handle_message(const Message<MessageType::LEVEL_PROGRESS> &message);
 
   private:
+    /**
+     * Scale health bar to show current health.
+     */
+    void update_health_bar();
+
+    /**
+     * Scale level progress bar to show current progress.
+     */
+    void update_level_progress_bar();
+
     /** Entity for health bar. */
     iris::SingleEntity *health_bar_;
 
@@ -84,6 +113,12 @@ class HUD : public GameObject, Subscriber
 
     /** Starting health. */
     float starting_health_;
+
+    /** Current health. */
+    float health_;
+
+    /** Current level progress, in range [0, 1]. */
+    float level_progress_;
 };
 
 }
@@ -7,22 +7,37 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 
 #include "iris/graphics/window.h"
 
 #include "game_object.h"
 #include "publisher.h"
+#include "update_phase.h"
 
 namespace trinket
 {
 
 /**
  * Implementation of GameObject for handling user input.
+ *
+ * Input can optionally be coalesced, in which case all mouse movement and scroll wheel events received in an update
+ * are merged into a single event of each type. Key and mouse button events are never merged and are always published
+ * in the order they were received, before the merged movement.
  */
 class InputHandler : public GameObject, Publisher
 {
   public:
-    InputHandler(iris::Window *window);
+    /**
+     * Construct a new InputHandler.
+     *
+     * @param window
+     *   Window to get events from.
+     *
+     * @param coalesce
+     *   True if mouse movement and scroll wheel events should be merged each update, false to publish every event.
+     */
+    InputHandler(iris::Window *window, bool coalesce);
 
     /**
      * Update object.
@@ -32,9 +47,32 @@ class InputHandler : public GameObject, Publisher
      */
     void update(std::chrono::microseconds) override;
 
+    /**
+     * Get the phase of the frame this object should be updated in.
+     *
+     * @returns
+     *   Update phase.
+     */
+    UpdatePhase update_phase() const override;
+
+    /**
+     * Get the number of events that have been merged away i.e. not published because they were coalesced into
+     * another event.
+     *
+     * @returns
+     *   Number of merged events.
+     */
+    std::uint64_t merged_events() const;
+
   private:
     /** Window for game. */
     iris::Window *window_;
+
+    /** Flag indicating if events should be coalesced. */
+    bool coalesce_;
+
+    /** Number of events merged. */
+    std::uint64_t merged_events_;
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace trinket
+{
+
+/**
+ * A pool of worker threads for running jobs in parallel.
+ *
+ * Each thread (including the thread calling parallel_for) has its own queue of jobs. Threads take jobs from the back
+ * of their own queue and, when that is empty, steal from the front of another thread's queue. This keeps threads busy
+ * even when some jobs take much longer than others (e.g. an enemy running a complex script).
+ *
+ * parallel_for must only be called from a single thread (the thread that owns the pool) and must not be nested.
+ */
+class JobSystem
+{
+  public:
+    /**
+     * Construct a new JobSystem.
+     *
+     * @param worker_count
+     *   Number of worker threads to create, 0 will create one less than the number of hardware threads (as the calling
+     *   thread also runs jobs).
+     */
+    explicit JobSystem(std::uint32_t worker_count);
+
+    /**
+     * Stops and joins all worker threads.
+     */
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    /**
+     * Call a function for every index in [0, count), spread across all threads. Blocks until all calls have finished.
+     *
+     * @param count
+     *   Number of indices.
+     *
+     * @param batch_size
+     *   Number of indices in a single job, larger batches reduce scheduling overhead but make stealing less effective.
+     *
+     * @param job
+     *   Function to call with each index.
+     */
+    void parallel_for(std::size_t count, std::size_t batch_size, const std::function<void(std::size_t)> &job);
+
+    /**
+     * Get the number of worker threads (not including the calling thread).
+     *
+     * @returns
+     *   Number of worker threads.
+     */
+    std::uint32_t worker_count() const;
+
+  private:
+    /**
+     * Internal struct for a range of indices to run.
+     */
+    struct Job
+    {
+        /** Function to call. */
+        const std::function<void(std::size_t)> *function;
+
+        /** First index (inclusive). */
+        std::size_t begin;
+
+        /** Last index (exclusive). */
+        std::size_t end;
+
+        /** Counter of outstanding jobs, decremented when this job has finished. */
+        std::atomic<std::size_t> *remaining;
+    };
+
+    /**
+     * Internal struct for a thread's queue of jobs.
+     */
+    struct WorkQueue
+    {
+        /** Lock for queue. */
+        std::mutex mutex;
+
+        /** Queued jobs. */
+        std::deque<Job> jobs;
+    };
+
+    /**
+     * Main loop of a worker thread.
+     *
+     * @param index
+     *   Index of thread's queue.
+     */
+    void worker_loop(std::size_t index);
+
+    /**
+     * Try and get a job, first from the thread's own queue and then by stealing from other threads.
+     *
+     * @param index
+     *   Index of thread's queue.
+     *
+     * @returns
+     *   Job if one was available, otherwise empty optional.
+     */
+    std::optional<Job> take_job(std::size_t index);
+
+    /**
+     * Run a job.
+     *
+     * @param job
+     *   Job to run.
+     */
+    static void run_job(const Job &job);
+
+    /** Queues, index 0 is for the thread calling parallel_for and the rest are for workers. */
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+
+    /** Number of jobs queued but not yet taken. */
+    std::atomic<std::size_t> queued_jobs_;
+
+    /** Flag indicating workers should exit. */
+    std::atomic<bool> stop_;
+
+    /** Lock for sleeping workers. */
+    std::mutex wake_mutex_;
+
+    /** Used to wake workers when jobs are queued. */
+    std::condition_variable wake_;
+
+    /** Worker threads. */
+    std::vector<std::thread> workers_;
+};
+
+}
@@ -6,9 +6,9 @@
 
 #pragma once
 
-#include <any>
 #include <cstdint>
 
+#include "message_data.h"
 #include "message_type.h"
 #include "quest.h"
 #include "subscriber.h"
@@ -19,7 +19,7 @@ namespace trinket
 /**
  * Implementation of quest for killing a specific number of enemies.
  */
-class KillEnemyQuest : public Quest, Subscriber
+class KillEnemyQuest : public Quest, public Subscriber
 {
   public:
     /**
@@ -47,15 +47,12 @@ class KillEnemyQuest : public Quest, Subscriber
     std::uint32_t completion_xp() const override;
 
     /**
-     * Message handler.
+     * Handle killed enemy message.
      *
-     * @param message_type
-     *   Type of message being sent.
-     *
-     * @param data
-     *   Any data for the message.
+     * @param message
+     *   Message data.
      */
-    void handle_message(MessageType message_type, const std::any &data) override;
+    void handle_message(const Message<MessageType::KILLED_ENEMY> &message);
 
   private:
     /** Number of enemies to kill. */
@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace trinket
+{
+
+/**
+ * Class for a read only file mapped into memory. Pages are only read from disk when first accessed.
+ */
+class MappedFile
+{
+  public:
+    /**
+     * Map a file.
+     *
+     * @param path
+     *   Path of file to map.
+     */
+    explicit MappedFile(const std::filesystem::path &path);
+
+    /**
+     * Unmaps file.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * Get the mapped data.
+     *
+     * @returns
+     *   Pointer to start of file.
+     */
+    const std::byte *data() const;
+
+    /**
+     * Get the size of the file.
+     *
+     * @returns
+     *   Size in bytes.
+     */
+    std::size_t size() const;
+
+  private:
+    /** Start of mapping. */
+    const std::byte *data_;
+
+    /** Size of mapping. */
+    std::size_t size_;
+
+#if defined(_WIN32)
+    /**
+     * Unmap the view and close the handles, any of which may not have been opened.
+     */
+    void release();
+
+    /** File handle. */
+    void *file_;
+
+    /** File mapping handle. */
+    void *mapping_;
+#endif
+};
+
+}
@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+
+#include "iris/graphics/render_graph/render_graph.h"
+#include "iris/graphics/render_pipeline.h"
+#include "iris/graphics/texture_manager.h"
+
+namespace trinket
+{
+
+/**
+ * Class for sharing render graphs between static geometry with the same material, so identical geometry doesn't
+ * create a render graph (and shader) per instance.
+ *
+ * Render graphs belong to a render pipeline, so a cache should only live as long as the zone it is loading.
+ */
+class MaterialCache
+{
+  public:
+    /**
+     * Construct a new MaterialCache.
+     *
+     * @param render_pipeline
+     *   Render pipeline to create render graphs with.
+     */
+    explicit MaterialCache(iris::RenderPipeline *render_pipeline);
+
+    /**
+     * Get the render graph for a material, creating it if needed.
+     *
+     * @param texture
+     *   Colour texture.
+     *
+     * @param texture_scale
+     *   UV scale of colour texture, 0 if unscaled. Scaled textures are loaded with the default sampler.
+     *
+     * @param normal
+     *   Normal texture, empty if none.
+     *
+     * @param nearest
+     *   True if an unscaled colour texture should be sampled with nearest_sampler, otherwise the default sampler.
+     *
+     * @returns
+     *   Render graph for material.
+     */
+    iris::RenderGraph *material(
+        const std::string &texture,
+        float texture_scale,
+        const std::string &normal,
+        bool nearest);
+
+    /**
+     * Get the number of render graphs created.
+     *
+     * @returns
+     *   Number of render graphs.
+     */
+    std::uint32_t graphs() const;
+
+    /**
+     * Get the number of times a material was requested.
+     *
+     * @returns
+     *   Number of requests.
+     */
+    std::uint32_t requests() const;
+
+    /**
+     * Get the sampler used for unscaled static geometry textures. This is created once and shared, as the texture
+     * manager doesn't deduplicate samplers.
+     *
+     * @returns
+     *   Nearest neighbour sampler.
+     */
+    static const iris::Sampler *nearest_sampler();
+
+  private:
+    /** Key for a material: texture, texture scale, normal, nearest. */
+    using Key = std::tuple<std::string, float, std::string, bool>;
+
+    /** Render pipeline to create render graphs with. */
+    iris::RenderPipeline *render_pipeline_;
+
+    /** Created render graphs. */
+    std::map<Key, iris::RenderGraph *> materials_;
+
+    /** Number of requests. */
+    std::uint32_t requests_;
+};
+
+}
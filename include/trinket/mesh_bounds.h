@@ -0,0 +1,28 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <tuple>
+
+#include "iris/core/vector3.h"
+#include "iris/graphics/mesh.h"
+
+namespace trinket
+{
+
+/**
+ * Calculate the axis aligned bounds of a mesh, in mesh space. This is a single pass over the vertices.
+ *
+ * @param mesh
+ *   Mesh to get bounds of.
+ *
+ * @returns
+ *   Tuple of minimum and maximum corners, both zero if mesh has no vertices.
+ */
+std::tuple<iris::Vector3, iris::Vector3> mesh_bounds(const iris::Mesh *mesh);
+
+}
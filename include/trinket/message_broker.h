@@ -6,20 +6,112 @@
 
 #pragma once
 
-#include <any>
-#include <set>
-#include <unordered_map>
+#include <cstddef>
+#include <thread>
+#include <tuple>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 
+#include "message_data.h"
+#include "message_stats.h"
 #include "message_type.h"
+#include "mpsc_queue.h"
+#include "subscription_channel.h"
 
 namespace trinket
 {
 
-class Subscriber;
+/**
+ * Collection of messages captured from a thread, in the order they were published.
+ *
+ * Messages are stored by value in a buffer per message type, with the order of their types recorded separately, so
+ * once the buffers have grown capturing doesn't allocate.
+ */
+class CapturedMessages
+{
+  public:
+    /**
+     * Capture a message.
+     *
+     * @param key
+     *   Key message is addressed to.
+     *
+     * @param data
+     *   Data for the message.
+     */
+    template <MessageType T>
+    void add(MessageKey key, const MessageData<T> &data)
+    {
+        std::get<static_cast<std::size_t>(T)>(buffers_).messages.push_back({key, data});
+        order_.push_back(T);
+    }
+
+    /**
+     * Remove all captured messages, keeping the buffers' allocations.
+     */
+    void clear()
+    {
+        std::apply([](auto &...buffers) { (buffers.messages.clear(), ...); }, buffers_);
+        order_.clear();
+    }
+
+  private:
+    friend class MessageBroker;
+
+    /**
+     * Captured messages of a single message type.
+     */
+    template <MessageType T>
+    struct Buffer
+    {
+        /** Type of message captured. */
+        static constexpr MessageType type = T;
+
+        /**
+         * Internal struct for a captured message.
+         */
+        struct CapturedMessage
+        {
+            /** Key message is addressed to. */
+            MessageKey key;
+
+            /** Data for the message. */
+            MessageData<T> data;
+        };
+
+        /** Messages, in the order they were captured. */
+        std::vector<CapturedMessage> messages;
+    };
+
+    /**
+     * Helper to create a tuple with a buffer for every message type.
+     */
+    template <class>
+    struct BufferTable;
+
+    template <std::size_t... I>
+    struct BufferTable<std::index_sequence<I...>>
+    {
+        using type = std::tuple<Buffer<static_cast<MessageType>(I)>...>;
+    };
+
+    /** Captured messages, one buffer per message type. */
+    typename BufferTable<std::make_index_sequence<message_type_count>>::type buffers_;
+
+    /** Type of every captured message, in the order they were captured. */
+    std::vector<MessageType> order_;
+};
 
 /**
  * Singleton class that is responsible for sending messages i.e connecting publishers to subscribers.
+ *
+ * Each message type has its own statically typed channel, so publishing a message does not box the data or require
+ * any runtime type checks.
+ *
+ * All methods must be called from the thread that owns the broker (the thread which first calls instance, i.e. the
+ * main thread), except for post which can be called from any thread and publish which can be called from any thread
+ * that is capturing messages.
  */
 class MessageBroker
 {
@@ -38,41 +130,310 @@ class MessageBroker
      * @param subscriber
      *   Object wanting to subscribe.
      *
-     * @param message_type
-     *   Type of message to subscribe to.
+     * @param handler
+     *   Function to call to deliver message to subscriber.
+     *
+     * @param key
+     *   Only receive messages published with this key, nullptr to receive all messages of the type.
+     *
+     * @param subscriber_type
+     *   Type of the (most derived) subscriber, used to group handler times when recording stats.
+     *
+     * @returns
+     *   Handle to subscription, used to unsubscribe.
      */
-    void subscribe(Subscriber *subscriber, MessageType message_type);
+    template <MessageType T>
+    SubscriptionHandle subscribe(
+        Subscriber *subscriber,
+        MessageHandler<T> handler,
+        MessageKey key = nullptr,
+        const std::type_info &subscriber_type = typeid(Subscriber))
+    {
+        return channel<T>().add(subscriber, handler, key, stats_.register_class(subscriber_type));
+    }
 
     /**
-     * Unsubscribe a subscriber to a message type.
+     * Unsubscribe a subscription. This is safe to call whilst a message is being delivered.
      *
-     * @param subscriber
-     *   Object wanting to unsubscribe.
+     * @param handle
+     *   Handle of subscription to remove.
+     */
+    void unsubscribe(const SubscriptionHandle &handle);
+
+    /*
+     * Publish a message to all (broadcast) subscribers. If the broker is in queued mode then the message will be
+     * delivered at the next call to flush, otherwise it is delivered immediately.
      *
-     * @param message_type
-     *   Type of message to unsubscribe to.
+     * @param data
+     *   Data for the message.
      */
-    void unsubscribe(Subscriber *subscriber, MessageType message_type);
+    template <MessageType T>
+    void publish(const MessageData<T> &data)
+    {
+        publish<T>(nullptr, data);
+    }
 
     /*
-     * Publish a message to all subscribers.
+     * Publish a message addressed to a key. It will be delivered to the subscribers of that key as well as all
+     * broadcast subscribers. If the broker is in queued mode then the message will be delivered at the next call to
+     * flush, otherwise it is delivered immediately.
+     *
+     * @param key
+     *   Key message is addressed to.
+     *
+     * @param data
+     *   Data for the message.
+     */
+    template <MessageType T>
+    void publish(MessageKey key, const MessageData<T> &data)
+    {
+        if (capture_ != nullptr)
+        {
+            capture_->add<T>(key, data);
+        }
+        else if (queued_)
+        {
+            queue<T>().pending.push_back({key, data});
+        }
+        else
+        {
+            channel<T>().dispatch(key, data, stats_enabled_ ? &stats_ : nullptr);
+        }
+    }
+
+    /**
+     * Post a message to all (broadcast) subscribers from any thread. The message will be delivered on the thread that
+     * owns the broker at the next call to flush.
      *
-     * @param message_type
-     *   Type of message being sent (will be sent to subscribers of this type).
+     * From any other thread this is lock-free, unless the queue for the message type is full, in which case it will
+     * yield until the owning thread has drained it. The owning thread can't drain whilst it is posting, so its messages
+     * are queued as if published in queued mode.
      *
      * @param data
-     *   Any data for the message.
+     *   Data for the message.
+     */
+    template <MessageType T>
+    void post(const MessageData<T> &data)
+    {
+        post<T>(nullptr, data);
+    }
+
+    /**
+     * Post a message addressed to a key from any thread. The message will be delivered on the thread that owns the
+     * broker at the next call to flush.
+     *
+     * From any other thread this is lock-free, unless the queue for the message type is full, in which case it will
+     * yield until the owning thread has drained it. The owning thread can't drain whilst it is posting, so its messages
+     * are queued as if published in queued mode.
+     *
+     * @param key
+     *   Key message is addressed to.
+     *
+     * @param data
+     *   Data for the message.
+     */
+    template <MessageType T>
+    void post(MessageKey key, const MessageData<T> &data)
+    {
+        if (std::this_thread::get_id() == owner_)
+        {
+            queue<T>().pending.push_back({key, data});
+        }
+        else
+        {
+            queue<T>().posted.push({key, data});
+        }
+    }
+
+    /**
+     * Set (or clear) the collection that messages published from the calling thread are captured into, rather than
+     * being queued or delivered. This allows objects to publish from worker threads, the captured messages can then be
+     * published in a deterministic order by the owning thread by calling replay.
+     *
+     * @param captured
+     *   Collection to capture messages into, nullptr to stop capturing.
+     */
+    static void set_capture(CapturedMessages *captured);
+
+    /**
+     * Publish all captured messages, in the order they were captured, and then clear them.
+     *
+     * @param captured
+     *   Captured messages to publish.
+     */
+    void replay(CapturedMessages &captured);
+
+    /**
+     * Set whether messages should be queued until the next flush or delivered immediately.
+     *
+     * @param queued
+     *   True if messages should be queued, false if they should be delivered immediately.
+     */
+    void set_queued(bool queued);
+
+    /**
+     * Check if the broker is in queued mode.
+     *
+     * @returns
+     *   True if messages are queued, otherwise false.
+     */
+    bool is_queued() const;
+
+    /**
+     * Deliver all queued and posted messages, must be called from the thread that owns the broker. Messages are
+     * delivered in batches, one message type at a time and in the order they were published within a type (posted
+     * messages are delivered after published ones). Any messages published whilst flushing are queued for the next
+     * flush.
+     */
+    void flush();
+
+    /**
+     * Discard all queued messages without delivering them.
+     */
+    void clear();
+
+    /**
+     * Set whether stats should be recorded for delivered messages.
+     *
+     * @param enabled
+     *   True if stats should be recorded, otherwise false.
      */
-    void publish(MessageType message_type, const std::any &data) const;
+    void set_stats_enabled(bool enabled);
+
+    /**
+     * Check if stats are being recorded.
+     *
+     * @returns
+     *   True if stats are being recorded, otherwise false.
+     */
+    bool stats_enabled() const;
+
+    /**
+     * Mark the end of a frame, used to record per frame stats. Does nothing if stats are not being recorded.
+     */
+    void end_frame();
+
+    /**
+     * Get recorded stats.
+     *
+     * @returns
+     *   Recorded stats.
+     */
+    const MessageStats &stats() const;
 
   private:
+    /**
+     * Maximum number of messages of a single type that can be posted between flushes before posting blocks. Every
+     * message type has its own queue allocated up front, a cell is a sequence number plus a QueuedMessage (16 to 40
+     * bytes), so this costs about 90KB across all message types. Posting is for the odd message from a background
+     * thread, a few hundred of one type in a single frame means something should be publishing them in bulk instead.
+     */
+    static constexpr std::size_t posted_queue_capacity = 256u;
+
+    /**
+     * Double buffered queue of messages for a message type.
+     */
+    template <MessageType T>
+    struct MessageQueue
+    {
+        /** Type of message queued. */
+        static constexpr MessageType type = T;
+
+        /**
+         * Internal struct for a queued message.
+         */
+        struct QueuedMessage
+        {
+            /** Key message is addressed to. */
+            MessageKey key;
+
+            /** Data for the message. */
+            MessageData<T> data;
+        };
+
+        /** Messages published since the last flush. */
+        std::vector<QueuedMessage> pending;
+
+        /** Messages currently being delivered. */
+        std::vector<QueuedMessage> draining;
+
+        /** Messages posted from other threads since the last flush. */
+        MpscQueue<QueuedMessage, posted_queue_capacity> posted;
+    };
+
+    /**
+     * Helper to create a tuple with a collection of subscriptions for every message type.
+     */
+    template <class>
+    struct SubscriptionTable;
+
+    template <std::size_t... I>
+    struct SubscriptionTable<std::index_sequence<I...>>
+    {
+        using type = std::tuple<SubscriptionChannel<static_cast<MessageType>(I)>...>;
+    };
+
+    /**
+     * Helper to create a tuple with a message queue for every message type.
+     */
+    template <class>
+    struct QueueTable;
+
+    template <std::size_t... I>
+    struct QueueTable<std::index_sequence<I...>>
+    {
+        using type = std::tuple<MessageQueue<static_cast<MessageType>(I)>...>;
+    };
+
     /**
      * Private constructor to force access through singleton.
      */
     MessageBroker();
 
-    /** Collection of subscriptions. */
-    std::unordered_map<MessageType, std::vector<Subscriber *>> subscriptions_;
+    /**
+     * Get the subscriptions for a message type.
+     *
+     * @returns
+     *   Subscriptions for message type.
+     */
+    template <MessageType T>
+    SubscriptionChannel<T> &channel()
+    {
+        return std::get<static_cast<std::size_t>(T)>(subscriptions_);
+    }
+
+    /**
+     * Get the queue for a message type.
+     *
+     * @returns
+     *   Queue for message type.
+     */
+    template <MessageType T>
+    MessageQueue<T> &queue()
+    {
+        return std::get<static_cast<std::size_t>(T)>(queues_);
+    }
+
+    /** Collection of subscriptions, one channel per message type. */
+    typename SubscriptionTable<std::make_index_sequence<message_type_count>>::type subscriptions_;
+
+    /** Queued messages, one queue per message type. */
+    typename QueueTable<std::make_index_sequence<message_type_count>>::type queues_;
+
+    /** Flag indicating if messages are queued or delivered immediately. */
+    bool queued_;
+
+    /** Recorded stats. */
+    MessageStats stats_;
+
+    /** Flag indicating if stats are being recorded. */
+    bool stats_enabled_;
+
+    /** Thread that owns the broker, i.e. the thread that created it. */
+    std::thread::id owner_;
+
+    /** Collection messages published from this thread are captured into, nullptr if not capturing. */
+    static thread_local CapturedMessages *capture_;
 };
 
 }
@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "iris/core/vector3.h"
+#include "iris/events/keyboard_event.h"
+#include "iris/events/mouse_button_event.h"
+#include "iris/events/mouse_event.h"
+#include "iris/events/scroll_wheel_event.h"
+#include "iris/physics/rigid_body.h"
+
+#include "message_type.h"
+
+namespace trinket
+{
+
+class Enemy;
+
+/**
+ * Payload for messages that carry no data.
+ */
+struct EmptyMessage
+{
+};
+
+/**
+ * Payload for messages about a collision with a rigid body.
+ */
+struct CollisionMessage
+{
+    /** Body that was collided with. */
+    iris::RigidBody *body;
+
+    /** World space position of contact. */
+    iris::Vector3 position;
+};
+
+/**
+ * Payload for key press messages.
+ */
+struct KeyPressMessage
+{
+    /** Key that changed. */
+    iris::Key key;
+
+    /** New state of key. */
+    iris::KeyState state;
+
+    /** Time the event was received from the window. */
+    std::chrono::steady_clock::time_point timestamp;
+};
+
+/**
+ * Payload for mouse button press messages.
+ */
+struct MouseButtonMessage
+{
+    /** Button that changed. */
+    iris::MouseButton button;
+
+    /** New state of button. */
+    iris::MouseButtonState state;
+
+    /** Time the event was received from the window. */
+    std::chrono::steady_clock::time_point timestamp;
+};
+
+/**
+ * Compile time mapping of a MessageType to the type of data it carries. Every MessageType must have a specialisation.
+ */
+template <MessageType T>
+struct MessageTraits;
+
+template <>
+struct MessageTraits<MessageType::QUIT>
+{
+    using data_type = EmptyMessage;
+};
+
+template <>
+struct MessageTraits<MessageType::MOUSE_MOVE>
+{
+    using data_type = iris::MouseEvent;
+};
+
+template <>
+struct MessageTraits<MessageType::MOUSE_BUTTON_PRESS>
+{
+    using data_type = MouseButtonMessage;
+};
+
+template <>
+struct MessageTraits<MessageType::KEY_PRESS>
+{
+    using data_type = KeyPressMessage;
+};
+
+template <>
+struct MessageTraits<MessageType::SCROLL_WHEEL>
+{
+    using data_type = iris::ScrollWheelEvent;
+};
+
+template <>
+struct MessageTraits<MessageType::WEAPON_COLLISION>
+{
+    using data_type = CollisionMessage;
+};
+
+template <>
+struct MessageTraits<MessageType::ENEMY_ATTACK>
+{
+    using data_type = float;
+};
+
+template <>
+struct MessageTraits<MessageType::PLAYER_HEALTH_CHANGE>
+{
+    using data_type = float;
+};
+
+template <>
+struct MessageTraits<MessageType::KILLED_ENEMY>
+{
+    using data_type = Enemy *;
+};
+
+template <>
+struct MessageTraits<MessageType::LEVEL_PROGRESS>
+{
+    using data_type = float;
+};
+
+template <>
+struct MessageTraits<MessageType::OBJECT_COLLISION>
+{
+    using data_type = CollisionMessage;
+};
+
+template <>
+struct MessageTraits<MessageType::QUEST_COMPLETE>
+{
+    using data_type = std::uint32_t;
+};
+
+template <>
+struct MessageTraits<MessageType::PLAYER_DIED>
+{
+    using data_type = EmptyMessage;
+};
+
+/**
+ * Type of data carried by a MessageType.
+ */
+template <MessageType T>
+using MessageData = typename MessageTraits<T>::data_type;
+
+/**
+ * A message as delivered to a subscriber. This is a distinct type for each MessageType (even if they share the same
+ * data type) so subscribers can overload their handler for each message they are interested in.
+ */
+template <MessageType T>
+struct Message
+{
+    /** Data for the message. */
+    const MessageData<T> &data;
+};
+
+}
@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+#include "message_type.h"
+
+namespace trinket
+{
+
+/**
+ * Class for recording statistics about messages sent through the MessageBroker. For each message type it records the
+ * number of publishes per frame and the fan-out (number of subscribers a message was delivered to). It also records a
+ * histogram of how long each subscriber class spends in handle_message for each message type.
+ *
+ * Statistics are only recorded whilst the broker has stats enabled, so there is no cost when they are not needed.
+ */
+class MessageStats
+{
+  public:
+    /** Number of buckets in a latency histogram, bucket i counts durations in [2^i, 2^(i+1)) nanoseconds. */
+    static constexpr std::size_t histogram_buckets = 32u;
+
+    /**
+     * Construct a new empty MessageStats.
+     */
+    MessageStats();
+
+    /**
+     * Register a subscriber class.
+     *
+     * @param type
+     *   Type of subscriber.
+     *
+     * @returns
+     *   Id of subscriber class, the same type always gets the same id.
+     */
+    std::uint32_t register_class(const std::type_info &type);
+
+    /**
+     * Record a message being dispatched.
+     *
+     * @param message_type
+     *   Type of message dispatched.
+     *
+     * @param fan_out
+     *   Number of subscribers the message was delivered to.
+     */
+    void record_dispatch(MessageType message_type, std::uint32_t fan_out);
+
+    /**
+     * Record a subscriber handling a message.
+     *
+     * @param message_type
+     *   Type of message handled.
+     *
+     * @param class_id
+     *   Id of subscriber class (from register_class).
+     *
+     * @param duration
+     *   Time spent handling message.
+     */
+    void record_handler(MessageType message_type, std::uint32_t class_id, std::chrono::nanoseconds duration);
+
+    /**
+     * Mark the end of a frame, this rolls up the per frame publish counts.
+     */
+    void end_frame();
+
+    /**
+     * Discard all recorded statistics (registered classes are kept).
+     */
+    void reset();
+
+    /**
+     * Write all recorded statistics as json.
+     *
+     * @param path
+     *   Path of file to write to.
+     */
+    void write_json(const std::string &path) const;
+
+  private:
+    /**
+     * Internal struct for statistics about a message type.
+     */
+    struct TypeStats
+    {
+        /** Total number of messages dispatched. */
+        std::uint64_t publishes;
+
+        /** Number of messages dispatched in the current frame. */
+        std::uint32_t frame_publishes;
+
+        /** Largest number of messages dispatched in a single frame. */
+        std::uint32_t max_frame_publishes;
+
+        /** Sum of fan-out of all dispatched messages. */
+        std::uint64_t total_fan_out;
+
+        /** Largest fan-out of a single message. */
+        std::uint32_t max_fan_out;
+    };
+
+    /**
+     * Internal struct for a latency histogram of a subscriber class handling a message type.
+     */
+    struct HandlerStats
+    {
+        /** Number of durations in each bucket. */
+        std::array<std::uint64_t, histogram_buckets> buckets;
+
+        /** Number of times message was handled. */
+        std::uint64_t calls;
+
+        /** Total time spent handling message. */
+        std::chrono::nanoseconds total;
+
+        /** Longest time spent handling a single message. */
+        std::chrono::nanoseconds max;
+    };
+
+    /** Statistics for each message type. */
+    std::array<TypeStats, message_type_count> types_;
+
+    /** Handler statistics, keyed on message type and subscriber class id. */
+    std::unordered_map<std::uint64_t, HandlerStats> handlers_;
+
+    /** Map of subscriber type to class id. */
+    std::unordered_map<std::type_index, std::uint32_t> class_ids_;
+
+    /** Names of subscriber classes, indexed by class id. */
+    std::vector<std::string> class_names_;
+
+    /** Number of frames recorded. */
+    std::uint64_t frames_;
+};
+
+}
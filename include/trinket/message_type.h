@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <string_view>
 
 namespace trinket
 {
@@ -31,4 +33,37 @@ enum class MessageType : std::uint16_t
     PLAYER_DIED,
 };
 
+/** Number of message types, must be kept in sync with MessageType. */
+static constexpr std::size_t message_type_count = static_cast<std::size_t>(MessageType::PLAYER_DIED) + 1u;
+
+/**
+ * Get the name of a message type.
+ *
+ * @param message_type
+ *   Message type to get name of.
+ *
+ * @returns
+ *   Name of message type.
+ */
+constexpr std::string_view to_string(MessageType message_type)
+{
+    switch (message_type)
+    {
+        case MessageType::QUIT: return "QUIT";
+        case MessageType::MOUSE_MOVE: return "MOUSE_MOVE";
+        case MessageType::MOUSE_BUTTON_PRESS: return "MOUSE_BUTTON_PRESS";
+        case MessageType::KEY_PRESS: return "KEY_PRESS";
+        case MessageType::SCROLL_WHEEL: return "SCROLL_WHEEL";
+        case MessageType::WEAPON_COLLISION: return "WEAPON_COLLISION";
+        case MessageType::ENEMY_ATTACK: return "ENEMY_ATTACK";
+        case MessageType::PLAYER_HEALTH_CHANGE: return "PLAYER_HEALTH_CHANGE";
+        case MessageType::KILLED_ENEMY: return "KILLED_ENEMY";
+        case MessageType::LEVEL_PROGRESS: return "LEVEL_PROGRESS";
+        case MessageType::OBJECT_COLLISION: return "OBJECT_COLLISION";
+        case MessageType::QUEST_COMPLETE: return "QUEST_COMPLETE";
+        case MessageType::PLAYER_DIED: return "PLAYER_DIED";
+        default: return "UNKNOWN";
+    }
+}
+
 }
@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace trinket
+{
+
+/**
+ * Bounded lock-free multi-producer, single-consumer queue.
+ *
+ * Any number of threads may push concurrently, but only one thread may pop. Each cell carries a sequence number which
+ * tells producers and the consumer whether it is free or filled, so the only contention between producers is a single
+ * compare-and-swap on the write position.
+ */
+template <class T, std::size_t Capacity>
+class MpscQueue
+{
+    static_assert((Capacity >= 2u) && ((Capacity & (Capacity - 1u)) == 0u), "capacity must be a power of two");
+
+  public:
+    /**
+     * Construct a new empty MpscQueue.
+     */
+    MpscQueue()
+        : cells_(std::make_unique<Cell[]>(Capacity))
+        , write_position_(0u)
+        , read_position_(0u)
+    {
+        for (std::size_t i = 0u; i < Capacity; ++i)
+        {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpscQueue()
+    {
+        while (try_pop())
+        {
+        }
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    /**
+     * Try and push a value onto the queue, safe to call from any thread.
+     *
+     * @param value
+     *   Value to push.
+     *
+     * @returns
+     *   True if value was pushed, false if the queue was full.
+     */
+    bool try_push(const T &value)
+    {
+        auto position = write_position_.load(std::memory_order_relaxed);
+        Cell *cell = nullptr;
+
+        for (;;)
+        {
+            cell = &cells_[position & mask];
+            const auto sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+            if (diff == 0)
+            {
+                // cell is free, try and claim it
+                if (write_position_.compare_exchange_weak(position, position + 1u, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // cell still holds a value the consumer hasn't popped, so we are full
+                return false;
+            }
+            else
+            {
+                // another producer claimed the cell
+                position = write_position_.load(std::memory_order_relaxed);
+            }
+        }
+
+        ::new (static_cast<void *>(cell->storage)) T(value);
+        cell->sequence.store(position + 1u, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * Push a value onto the queue, safe to call from any thread. If the queue is full this will yield until the
+     * consumer has made space.
+     *
+     * @param value
+     *   Value to push.
+     */
+    void push(const T &value)
+    {
+        while (!try_push(value))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * Try and pop a value from the queue, must only be called from the consuming thread.
+     *
+     * @returns
+     *   Popped value if queue was not empty, otherwise empty optional.
+     */
+    std::optional<T> try_pop()
+    {
+        auto &cell = cells_[read_position_ & mask];
+        const auto sequence = cell.sequence.load(std::memory_order_acquire);
+
+        if (static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(read_position_ + 1u) != 0)
+        {
+            return std::nullopt;
+        }
+
+        auto *value = std::launder(reinterpret_cast<T *>(cell.storage));
+        std::optional<T> result{std::move(*value)};
+        value->~T();
+
+        // mark cell as free for the next lap of producers
+        cell.sequence.store(read_position_ + Capacity, std::memory_order_release);
+        ++read_position_;
+
+        return result;
+    }
+
+  private:
+    /** Mask for converting positions to cell indices. */
+    static constexpr std::size_t mask = Capacity - 1u;
+
+    /** Size to pad to, to avoid false sharing between producers and consumer. */
+    static constexpr std::size_t cache_line_size = 64u;
+
+    /**
+     * Internal struct for a single queue entry.
+     */
+    struct Cell
+    {
+        /** Sequence number, used to determine if cell is free or filled. */
+        std::atomic<std::size_t> sequence;
+
+        /** Storage for value. */
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    /** Ring buffer of cells. */
+    std::unique_ptr<Cell[]> cells_;
+
+    /** Next position to write to, shared by all producers. */
+    alignas(cache_line_size) std::atomic<std::size_t> write_position_;
+
+    /** Next position to read from, only used by consumer. */
+    alignas(cache_line_size) std::size_t read_position_;
+};
+
+}
@@ -0,0 +1,257 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "iris/core/quaternion.h"
+#include "iris/core/vector3.h"
+
+#include "enemy_ai.h"
+#include "enemy_decision.h"
+#include "nav_grid.h"
+
+namespace trinket
+{
+
+/** Prefix of an enemy script name which selects native AI rather than a lua file, e.g. "native:basic". */
+static constexpr std::string_view native_ai_prefix = "native:";
+
+/**
+ * Check if an enemy script name selects native AI.
+ *
+ * @param script
+ *   Script name, as given in zone data.
+ *
+ * @returns
+ *   True if script is native, otherwise false.
+ */
+constexpr bool is_native_ai(std::string_view script)
+{
+    return script.starts_with(native_ai_prefix);
+}
+
+/**
+ * Class for running the basic enemy state machine (roaming, hunting and attacking, as basic_enemy.lua) natively for a
+ * whole zone of enemies at once.
+ *
+ * Enemy data is stored as structure of arrays, and update runs the distance and vision tests for every enemy in branch
+ * free loops the compiler can vectorise, before stepping each enemy's state machine. Each enemy is driven by an
+ * EnemyAi (see create) which hands out the decision from the last update and reports where the enemy moved to, so
+ * update must be called every tick before any enemy is ticked (see NativeAiUpdater).
+ */
+class NativeAi
+{
+  public:
+    /**
+     * Construct a new NativeAi.
+     */
+    NativeAi();
+
+    /**
+     * Add an enemy.
+     *
+     * @param script
+     *   Script name, must be native (see is_native_ai).
+     *
+     * @param position
+     *   Start position of enemy.
+     *
+     * @param bounds_min
+     *   Minimum bounds of enemy patrol zone.
+     *
+     * @param bounds_max
+     *   Maximum bounds of enemy patrol zone.
+     *
+     * @returns
+     *   AI for enemy, only valid whilst this object is alive.
+     */
+    std::unique_ptr<EnemyAi> create(
+        std::string_view script,
+        const iris::Vector3 &position,
+        const iris::Vector3 &bounds_min,
+        const iris::Vector3 &bounds_max);
+
+    /**
+     * Make decisions for all enemies which moved since the last update.
+     *
+     * @param player_position
+     *   Position of player.
+     *
+     * @param nav
+     *   Navigation grid hunting enemies steer towards the player with.
+     *
+     * @param elapsed
+     *   Simulation time.
+     */
+    void update(const iris::Vector3 &player_position, const NavGrid &nav, std::chrono::microseconds elapsed);
+
+    /**
+     * Take the decision for an enemy. Different enemies may be ticked at the same time on different threads.
+     *
+     * @param index
+     *   Index of enemy.
+     *
+     * @param health
+     *   Health of enemy.
+     *
+     * @returns
+     *   Decision made at last update.
+     */
+    EnemyDecision tick(std::size_t index, float health);
+
+    /**
+     * Record where an enemy moved to, so it is decided for at the next update. Different enemies may be moved at the
+     * same time on different threads.
+     *
+     * @param index
+     *   Index of enemy.
+     *
+     * @param position
+     *   New position of enemy.
+     */
+    void moved(std::size_t index, const iris::Vector3 &position);
+
+    /**
+     * Get the number of enemies.
+     *
+     * @returns
+     *   Number of enemies.
+     */
+    std::size_t size() const;
+
+  private:
+    /**
+     * Enumeration of enemy states.
+     */
+    enum class State : std::uint8_t
+    {
+        ROAMING,
+        HUNTING,
+        ATTACKING
+    };
+
+    /**
+     * Enumeration of animations the state machine changes to.
+     */
+    enum class Animation : std::uint8_t
+    {
+        WALK,
+        BITE_FRONT
+    };
+
+    /**
+     * Move an enemy into a new state.
+     *
+     * @param index
+     *   Index of enemy.
+     *
+     * @param state
+     *   State to enter.
+     *
+     * @param elapsed
+     *   Simulation time.
+     */
+    void enter(std::size_t index, State state, std::chrono::microseconds elapsed);
+
+    /**
+     * Get the orientation an enemy is facing.
+     *
+     * @param index
+     *   Index of enemy.
+     *
+     * @returns
+     *   Orientation.
+     */
+    iris::Quaternion orientation(std::size_t index) const;
+
+    /** Random generator for roaming targets. */
+    std::mt19937 generator_;
+
+    /** Enemy x position. */
+    std::vector<float> x_;
+
+    /** Enemy y position. */
+    std::vector<float> y_;
+
+    /** Enemy z position. */
+    std::vector<float> z_;
+
+    /** Roaming target x position (targets are on the ground, y = 0). */
+    std::vector<float> target_x_;
+
+    /** Roaming target z position. */
+    std::vector<float> target_z_;
+
+    /** Minimum x of patrol zone. */
+    std::vector<float> min_x_;
+
+    /** Maximum x of patrol zone. */
+    std::vector<float> max_x_;
+
+    /** Minimum z of patrol zone. */
+    std::vector<float> min_z_;
+
+    /** Maximum z of patrol zone. */
+    std::vector<float> max_z_;
+
+    /** Walk direction x. */
+    std::vector<float> walk_x_;
+
+    /** Walk direction y. */
+    std::vector<float> walk_y_;
+
+    /** Walk direction z. */
+    std::vector<float> walk_z_;
+
+    /** Direction enemy faces on the xz plane, x (not normalised). */
+    std::vector<float> facing_x_;
+
+    /** Direction enemy faces on the xz plane, z (not normalised). */
+    std::vector<float> facing_z_;
+
+    /** Simulation time an attacking enemy can next attack. */
+    std::vector<std::chrono::microseconds> next_attack_;
+
+    /** Current state. */
+    std::vector<State> state_;
+
+    /** Animation to change to, if change_animation_ is set. */
+    std::vector<Animation> next_animation_;
+
+    /** Flag (0 or 1) indicating a new roaming target should be picked. */
+    std::vector<std::uint8_t> find_target_;
+
+    /** Flag (0 or 1) indicating the animation should change at the next tick. */
+    std::vector<std::uint8_t> change_animation_;
+
+    /** Flag (0 or 1) indicating the enemy attacks at the next tick. */
+    std::vector<std::uint8_t> has_attacked_;
+
+    /** Flag (0 or 1) indicating the enemy moved since the last update (culled enemies aren't moved). */
+    std::vector<std::uint8_t> moved_;
+
+    /** Result of vision test at last update, the player is within 45 degrees of the roaming target. */
+    std::vector<std::uint32_t> sees_player_;
+
+    /** Result of distance test at last update, the roaming target is reached. */
+    std::vector<std::uint32_t> near_target_;
+
+    /** Result of distance test at last update, the player is close enough to attack. */
+    std::vector<std::uint32_t> in_reach_;
+
+    /** Result of bounds test at last update, the player is inside the patrol zone. */
+    std::vector<std::uint32_t> player_in_bounds_;
+};
+
+}
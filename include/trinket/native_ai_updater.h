@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+
+#include "game_object.h"
+#include "native_ai.h"
+#include "nav_grid.h"
+#include "player.h"
+#include "update_phase.h"
+
+namespace trinket
+{
+
+/**
+ * Game object which owns a zone's NativeAi and makes decisions for all its enemies in one batch. It runs in the AI
+ * phase but isn't parallel, so it must be added before the enemies it drives to be updated ahead of them.
+ */
+class NativeAiUpdater : public GameObject
+{
+  public:
+    /**
+     * Construct a new NativeAiUpdater.
+     *
+     * @param player
+     *   Pointer to player object.
+     *
+     * @param nav
+     *   Navigation grid enemies steer towards the player with.
+     */
+    NativeAiUpdater(const Player *player, const NavGrid &nav);
+
+    /**
+     * Update object.
+     *
+     * @param elapsed
+     *   Time since last update.
+     */
+    void update(std::chrono::microseconds elapsed) override;
+
+    /**
+     * Get the phase of the frame this object should be updated in.
+     *
+     * @returns
+     *   Update phase.
+     */
+    UpdatePhase update_phase() const override;
+
+    /**
+     * Get the native AI to create enemies in.
+     *
+     * @returns
+     *   Native AI.
+     */
+    NativeAi &ai();
+
+  private:
+    /** Native AI for zone's enemies. */
+    NativeAi ai_;
+
+    /** Pointer to player object. */
+    const Player *player_;
+
+    /** Navigation grid enemies steer towards the player with. */
+    const NavGrid &nav_;
+};
+
+}
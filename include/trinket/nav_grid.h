@@ -0,0 +1,203 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "iris/core/quaternion.h"
+#include "iris/core/vector3.h"
+
+namespace trinket
+{
+
+/**
+ * Class for steering enemies around a zone's static geometry towards the player.
+ *
+ * The zone is divided into a uniform grid (on the xz plane) and any cell overlapped by a static body is blocked. Once a
+ * tick a single flow field is searched out from the player's cell, so every reachable cell knows which neighbour is on
+ * a shortest path to the player. Looking up the direction for an enemy is then a single read, however many enemies
+ * there are. The search is only run again when the player moves to a different cell, and doesn't go further than a
+ * maximum distance so its cost doesn't grow with the size of the zone: a search visits at most
+ * (2 * max_distance / cell_size + 1)^2 cells, 16641 with the default config.
+ *
+ * Only bodies which overlap the height an enemy walks at block cells, so the ground (and anything overhead) doesn't.
+ * Anywhere without a flow (outside the grid, in a blocked cell, out of range or in the player's cell) the direction is
+ * straight at the player.
+ */
+class NavGrid
+{
+  public:
+    /**
+     * Construct a new NavGrid.
+     *
+     * @param cell_size
+     *   Width and depth of a cell.
+     *
+     * @param max_distance
+     *   Maximum path distance from the player the flow field is searched to.
+     *
+     * @param enabled
+     *   True if navigation is enabled, otherwise the direction is always straight at the player.
+     */
+    NavGrid(float cell_size, float max_distance, bool enabled);
+
+    /**
+     * Check if navigation is enabled.
+     *
+     * @returns
+     *   True if enabled.
+     */
+    bool enabled() const;
+
+    /**
+     * Add a static box body.
+     *
+     * @param position
+     *   World position of box.
+     *
+     * @param orientation
+     *   Orientation of box.
+     *
+     * @param half_extents
+     *   Half extents of box.
+     */
+    void add(const iris::Vector3 &position, const iris::Quaternion &orientation, const iris::Vector3 &half_extents);
+
+    /**
+     * Finish adding bodies, the grid is sized to fit the ones which block and their cells are marked.
+     *
+     * @param walk_height
+     *   Height enemies walk at, bodies which don't reach it (or are entirely above it) don't block.
+     */
+    void build(float walk_height);
+
+    /**
+     * Search the flow field out from the player, if they have moved to a different cell since the last update (moving
+     * into a blocked cell keeps the last field). Should be called once a tick, before any enemy looks up a direction.
+     *
+     * @param player_position
+     *   Position of player.
+     */
+    void update(const iris::Vector3 &player_position);
+
+    /**
+     * Get the direction to walk to reach the player from a position. May be called from any thread.
+     *
+     * @param position
+     *   Position to walk from.
+     *
+     * @param player_position
+     *   Position of player, used when there is no flow at position.
+     *
+     * @returns
+     *   Normalised direction.
+     */
+    iris::Vector3 direction(const iris::Vector3 &position, const iris::Vector3 &player_position) const;
+
+    /**
+     * Get the number of cells reached by the last search.
+     *
+     * @returns
+     *   Number of cells with a path to the player.
+     */
+    std::size_t reached() const;
+
+    /**
+     * Log grid size and the number and average cost of searches.
+     */
+    void log_stats() const;
+
+  private:
+    /**
+     * Internal struct for the world bounds of a body.
+     */
+    struct Bounds
+    {
+        /** Minimum corner. */
+        iris::Vector3 min;
+
+        /** Maximum corner. */
+        iris::Vector3 max;
+    };
+
+    /**
+     * Get the index of the cell containing a position.
+     *
+     * @param position
+     *   Position to get cell of.
+     *
+     * @returns
+     *   Index of cell, or empty if position is outside the grid.
+     */
+    std::optional<std::size_t> cell_index(const iris::Vector3 &position) const;
+
+    /**
+     * Search the flow field out from a cell, replacing the last one.
+     *
+     * @param target
+     *   Index of cell to search from.
+     */
+    void search(std::size_t target);
+
+    /** Width and depth of a cell. */
+    float cell_size_;
+
+    /** Maximum path cost from the player the flow field is searched to. */
+    std::uint32_t max_cost_;
+
+    /** Flag indicating if navigation is enabled. */
+    bool enabled_;
+
+    /** World bounds of every body added, cleared once built. */
+    std::vector<Bounds> bodies_;
+
+    /** World x of the grid's minimum corner. */
+    float min_x_;
+
+    /** World z of the grid's minimum corner. */
+    float min_z_;
+
+    /** Number of cells along x, 0 if there is no grid. */
+    std::size_t width_;
+
+    /** Number of cells along z, 0 if there is no grid. */
+    std::size_t depth_;
+
+    /** Flag (0 or 1) for each cell indicating it is blocked. */
+    std::vector<std::uint8_t> blocked_;
+
+    /** Path cost of each cell to the player, only valid for cells in visited_. */
+    std::vector<std::uint32_t> cost_;
+
+    /** Neighbour (see the direction tables in nav_grid.cpp) of each cell on its path to the player, or no_flow. */
+    std::vector<std::uint8_t> flow_;
+
+    /** Cells reached by the last search, so only they need resetting for the next. */
+    std::vector<std::uint32_t> visited_;
+
+    /** Search queue, cells bucketed by path cost modulo the number of buckets. */
+    std::array<std::vector<std::uint32_t>, 15u> buckets_;
+
+    /** Cell the player was in at the last update, empty if outside the grid. */
+    std::optional<std::size_t> player_cell_;
+
+    /** Number of searches run. */
+    std::uint64_t searches_;
+
+    /** Sum of time taken by all searches. */
+    std::chrono::steady_clock::duration search_time_;
+
+    /** Sum of cells reached across all searches. */
+    std::uint64_t reached_total_;
+};
+
+}
@@ -6,7 +6,6 @@
 
 #pragma once
 
-#include <any>
 #include <chrono>
 #include <memory>
 #include <string>
@@ -16,6 +15,7 @@
 #include "iris/core/quaternion.h"
 #include "iris/core/vector3.h"
 #include "iris/graphics/animation/animation_controller.h"
+#include "iris/graphics/mesh_manager.h"
 #include "iris/graphics/render_pipeline.h"
 #include "iris/graphics/scene.h"
 #include "iris/graphics/single_entity.h"
@@ -24,9 +24,12 @@
 
 #include "character_controller.h"
 #include "game_object.h"
+#include "message_data.h"
 #include "message_type.h"
 #include "publisher.h"
 #include "subscriber.h"
+#include "transform_interpolator.h"
+#include "update_phase.h"
 
 namespace trinket
 {
@@ -34,14 +37,23 @@ namespace trinket
 /**
  * Implementation of GameObject for Player.
  */
-class Player : public GameObject, Publisher, Subscriber
+class Player : public GameObject, Publisher, public Subscriber
 {
   public:
     /**
-     * Construct a new player object.
+     * Construct a new player object, the player persists across zones so must be bound to a zone before use.
+     *
+     * @param headless
+     *   True if there is no renderer, in which case no meshes or animations are loaded.
+     */
+    explicit Player(bool headless);
+
+    /**
+     * Bind the player to a newly loaded zone. Render entities and physics bodies are recreated but the character rig
+     * (meshes, skeleton and animations) and player state (e.g. health and xp) are kept.
      *
      * @param scene
-     *   Scene player will be added to.
+     *   Scene player will be added to, nullptr if headless.
      *
      * @param ps
      *   Physics system.
@@ -50,13 +62,18 @@ class Player : public GameObject, Publisher, Subscriber
      *   World space coords of player spawn.
      *
      * @param render_pipeline
-     *   Render pipeline to use for player.
+     *   Render pipeline to use for player, nullptr if headless.
      */
-    Player(
+    void bind(
         iris::Scene *scene,
         iris::PhysicsSystem *ps,
         const iris::Vector3 &start_position,
-        iris::RenderPipeline &render_pipeline);
+        iris::RenderPipeline *render_pipeline);
+
+    /**
+     * Restore player to full health, e.g. after dying.
+     */
+    void respawn();
 
     /**
      * Update object.
@@ -64,7 +81,23 @@ class Player : public GameObject, Publisher, Subscriber
      * @param elapsed
      *   Time since last update.
      */
-    void update(std::chrono::microseconds) override;
+    void update(std::chrono::microseconds elapsed) override;
+
+    /**
+     * Get the phase of the frame this object should be updated in.
+     *
+     * @returns
+     *   Update phase.
+     */
+    UpdatePhase update_phase() const override;
+
+    /**
+     * Add anything this object renders, and which moves, to an interpolator so it is rendered smoothly between ticks.
+     *
+     * @param interpolator
+     *   Interpolator to add to.
+     */
+    void add_interpolated(TransformInterpolator &interpolator) override;
 
     /**
      * Set orientation oif player.
@@ -90,6 +123,15 @@ class Player : public GameObject, Publisher, Subscriber
      */
     iris::Vector3 position() const;
 
+    /**
+     * Get the position of the player as of its last update. Unlike position this doesn't query physics, so it is safe
+     * to call from any thread whilst objects in later update phases are prepared.
+     *
+     * @returns
+     *   Player position at last update.
+     */
+    iris::Vector3 tick_position() const;
+
     /**
      * Get player rigid body.
      *
@@ -99,17 +141,68 @@ class Player : public GameObject, Publisher, Subscriber
     const iris::RigidBody *rigid_body() const;
 
     /**
-     * Message handler.
+     * Handle mouse button press message.
      *
-     * @param message_type
-     *   Type of message being sent.
+     * @param message
+     *   Message data.
+     */
+    void handle_message(const Message<MessageType::MOUSE_BUTTON_PRESS> &message);
+
+    /**
+     * Handle key press message.
+     *
+     * @param message
+     *   Message data.
+     */
+    void handle_message(const Message<MessageType::KEY_PRESS> &message);
+
+    /**
+     * Handle enemy attack message.
      *
-     * @param data
-     *   Any data for the message.
+     * @param message
+     *   Message data.
      */
-    void handle_message(MessageType message_type, const std::any &data) override;
+    void handle_message(const Message<MessageType::ENEMY_ATTACK> &message);
+
+    /**
+     * Handle killed enemy message.
+     *
+     * @param message
+     *   Message data.
+     */
+    void handle_message(const Message<MessageType::KILLED_ENEMY> &message);
+
+    /**
+     * Handle quest complete message.
+     *
+     * @param message
+     *   Message data.
+     */
+    void handle_message(const Message<MessageType::QUEST_COMPLETE> &message);
 
   private:
+    /**
+     * Load the character rig (meshes, skeleton and animations), this only needs to happen once.
+     */
+    void load_rig();
+
+    /**
+     * Create all render entities for the player.
+     *
+     * @param scene
+     *   Scene to add entities to.
+     *
+     * @param start_position
+     *   World space coords of player spawn.
+     *
+     * @param render_pipeline
+     *   Render pipeline to use for player.
+     */
+    void create_render_entities(
+        iris::Scene *scene,
+        const iris::Vector3 &start_position,
+        iris::RenderPipeline &render_pipeline);
+
     /**
      * Internal struct for handling sub mesh data.
      */
@@ -132,8 +225,8 @@ class Player : public GameObject, Publisher, Subscriber
     /** Flag indicating if player is attacking. */
     bool attacking_;
 
-    /** Time point whe player will have stopped attacking. */
-    std::chrono::system_clock::time_point attack_stop_;
+    /** Simulation time when player will have stopped attacking. */
+    std::chrono::microseconds attack_stop_;
 
     /** Duration of player attack. */
     std::chrono::milliseconds attack_duration_;
@@ -141,8 +234,8 @@ class Player : public GameObject, Publisher, Subscriber
     /** Physics system. */
     iris::PhysicsSystem *ps_;
 
-    /** Time point to stop animation blending. */
-    std::chrono::system_clock::time_point blend_stop_;
+    /** Simulation time to stop animation blending. */
+    std::chrono::microseconds blend_stop_;
 
     /** Duration of animation blend. */
     std::chrono::milliseconds blend_time_;
@@ -150,6 +243,15 @@ class Player : public GameObject, Publisher, Subscriber
     /** Flag indicating if animation blending is occurring. */
     bool blending_;
 
+    /** Simulation time of last update. */
+    std::chrono::microseconds sim_time_;
+
+    /** Direction player last moved in. */
+    iris::Vector3 facing_;
+
+    /** Position of player at last update. */
+    iris::Vector3 tick_position_;
+
     /** Animation controller. */
     std::unique_ptr<iris::AnimationController> animation_controller_;
 
@@ -162,6 +264,9 @@ class Player : public GameObject, Publisher, Subscriber
     /** Player skeleton. */
     iris::Skeleton *skeleton_;
 
+    /** Player meshes, loaded once and used for every zone. */
+    iris::MeshLoadData rig_;
+
     /** Map of entities to sub mesh data. */
     std::unordered_map<iris::SingleEntity *, SubMesh> sub_meshes_;
 
@@ -0,0 +1,311 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#if defined(TRINKET_PROFILER)
+
+#define TRINKET_PROFILE_CONCAT_INNER(a, b) a##b
+#define TRINKET_PROFILE_CONCAT(a, b) TRINKET_PROFILE_CONCAT_INNER(a, b)
+
+/**
+ * Time the enclosing scope. Name must be a string literal (or otherwise outlive the profiler).
+ */
+#define TRINKET_PROFILE_SCOPE(name) const ::trinket::ScopedTimer TRINKET_PROFILE_CONCAT(trinket_timer_, __LINE__){name}
+
+/**
+ * Time the enclosing scope, named after the dynamic type of an object.
+ */
+#define TRINKET_PROFILE_TYPE(object)                                                                                   \
+    const ::trinket::ScopedTimer TRINKET_PROFILE_CONCAT(trinket_timer_, __LINE__){typeid(object)}
+
+/**
+ * Record the current value of a counter. Name must be a string literal (or otherwise outlive the profiler).
+ */
+#define TRINKET_PROFILE_COUNTER(name, value) ::trinket::Profiler::instance().counter(name, value)
+
+#else
+
+#define TRINKET_PROFILE_SCOPE(name)
+#define TRINKET_PROFILE_TYPE(object)
+#define TRINKET_PROFILE_COUNTER(name, value)
+
+#endif
+
+namespace trinket
+{
+
+/**
+ * Singleton class for recording how long scopes take.
+ *
+ * Each thread writes the scopes it completes into its own fixed size ring buffer, so recording never allocates or
+ * takes a lock. Once a frame the thread running the game loop calls end_frame, which rolls its outermost scopes up into
+ * per phase frame times (from which percentiles are calculated). Counters (e.g. how many enemies were updated) are
+ * recorded into the same buffers, so they appear alongside the scopes of the tick they were recorded in. The recorded
+ * buffers can be written out as Chrome trace_event json, which can be opened with chrome://tracing or
+ * https://ui.perfetto.dev.
+ *
+ * Scopes are only recorded when the profiler is enabled and when trinket is built with TRINKET_PROFILER, otherwise
+ * the TRINKET_PROFILE_* macros compile to nothing.
+ *
+ * end_frame, write_trace and log_summary must only be called from the game loop thread whilst no jobs are running.
+ */
+class Profiler
+{
+  public:
+    /** Number of scopes each thread can record before overwriting the oldest. */
+    static constexpr std::size_t buffer_capacity = 1u << 16u;
+
+    /** Number of frames kept for calculating phase percentiles. */
+    static constexpr std::size_t history_frames = 4096u;
+
+    /**
+     * Get single instance.
+     *
+     * @returns
+     *   Profiler.
+     */
+    static Profiler &instance();
+
+    Profiler(const Profiler &) = delete;
+    Profiler &operator=(const Profiler &) = delete;
+
+    /**
+     * Enable or disable recording.
+     *
+     * @param enabled
+     *   True if scopes should be recorded.
+     */
+    void set_enabled(bool enabled);
+
+    /**
+     * Check if recording is enabled.
+     *
+     * @returns
+     *   True if scopes are being recorded.
+     */
+    bool enabled() const;
+
+    /**
+     * Record a completed scope for the calling thread.
+     *
+     * @param name
+     *   Name of scope, nullptr if type is set.
+     *
+     * @param type
+     *   Type scope is named after, nullptr if name is set.
+     *
+     * @param start
+     *   Time scope started.
+     *
+     * @param end
+     *   Time scope ended.
+     *
+     * @param depth
+     *   Number of scopes enclosing this one on the calling thread.
+     */
+    void record(
+        const char *name,
+        const std::type_info *type,
+        std::chrono::steady_clock::time_point start,
+        std::chrono::steady_clock::time_point end,
+        std::uint32_t depth);
+
+    /**
+     * Record the current value of a counter for the calling thread. Does nothing if the profiler is disabled.
+     *
+     * @param name
+     *   Name of counter.
+     *
+     * @param value
+     *   Value of counter.
+     */
+    void counter(const char *name, std::int64_t value);
+
+    /**
+     * Mark the end of a frame, the outermost scopes recorded by the calling thread since the last call are summed
+     * into frame times for each phase.
+     */
+    void end_frame();
+
+    /**
+     * Write all recorded scopes as Chrome trace_event json.
+     *
+     * @param path
+     *   Path of file to write to.
+     */
+    void write_trace(const std::string &path) const;
+
+    /**
+     * Log p50, p95 and p99 frame times for each phase.
+     */
+    void log_summary() const;
+
+  private:
+    /**
+     * Internal struct for a completed scope or a counter value.
+     */
+    struct Event
+    {
+        /** Name of scope or counter. */
+        const char *name;
+
+        /** Type scope is named after. */
+        const std::type_info *type;
+
+        /** Start of scope (or time counter was recorded), relative to profiler creation. */
+        std::chrono::nanoseconds start;
+
+        /** Length of scope. */
+        std::chrono::nanoseconds duration;
+
+        /** Number of enclosing scopes. */
+        std::uint32_t depth;
+
+        /** Flag indicating if this is a counter rather than a scope. */
+        bool is_counter;
+
+        /** Value of counter. */
+        std::int64_t value;
+    };
+
+    /**
+     * Internal struct for a thread's ring buffer of scopes.
+     */
+    struct ThreadBuffer
+    {
+        /** Recorded scopes, indexed by count modulo capacity. */
+        std::vector<Event> events;
+
+        /** Total number of scopes recorded. */
+        std::uint64_t count;
+
+        /** Value of count at the end of the last frame. */
+        std::uint64_t frame_start;
+
+        /** Id of thread, in order of first record. */
+        std::uint32_t thread_id;
+    };
+
+    /**
+     * Internal struct for the frame times of a phase.
+     */
+    struct PhaseTimes
+    {
+        /** Name of phase. */
+        std::string name;
+
+        /** Frame times in milliseconds, ring buffer of the most recent frames the phase ran in. */
+        std::vector<float> samples;
+
+        /** Index to write next sample to. */
+        std::size_t next;
+    };
+
+    /**
+     * Construct a new Profiler.
+     */
+    Profiler();
+
+    /**
+     * Get the ring buffer for the calling thread, creating it on first use.
+     *
+     * @returns
+     *   Calling thread's buffer.
+     */
+    ThreadBuffer &thread_buffer();
+
+    /**
+     * Add a frame time sample to a phase.
+     *
+     * @param name
+     *   Name of phase.
+     *
+     * @param duration
+     *   Time spent in phase this frame.
+     */
+    void add_sample(const std::string &name, std::chrono::nanoseconds duration);
+
+    /** Calling thread's buffer (owned by buffers_). */
+    static thread_local ThreadBuffer *buffer_;
+
+    /** Flag indicating if scopes should be recorded. */
+    std::atomic<bool> enabled_;
+
+    /** Time profiler was created, all scopes are recorded relative to this. */
+    std::chrono::steady_clock::time_point epoch_;
+
+    /** Time of last end_frame call. */
+    std::chrono::steady_clock::time_point last_frame_;
+
+    /** Lock for buffers_. */
+    mutable std::mutex buffers_mutex_;
+
+    /** Buffers for every thread that has recorded a scope. */
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+
+    /** Frame times for each phase. */
+    std::vector<PhaseTimes> phases_;
+};
+
+/**
+ * RAII class for timing a scope, normally created with one of the TRINKET_PROFILE_* macros.
+ */
+class ScopedTimer
+{
+  public:
+    /**
+     * Start timing a named scope.
+     *
+     * @param name
+     *   Name of scope, must outlive the profiler.
+     */
+    explicit ScopedTimer(const char *name);
+
+    /**
+     * Start timing a scope named after a type.
+     *
+     * @param type
+     *   Type to name scope after.
+     */
+    explicit ScopedTimer(const std::type_info &type);
+
+    /**
+     * Stop timing and record the scope.
+     */
+    ~ScopedTimer();
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+  private:
+    /** Name of scope. */
+    const char *name_;
+
+    /** Type scope is named after. */
+    const std::type_info *type_;
+
+    /** Flag indicating if profiler was enabled when the scope started. */
+    bool active_;
+
+    /** Time scope started. */
+    std::chrono::steady_clock::time_point start_;
+
+    /** Number of active scopes on the calling thread. */
+    static thread_local std::uint32_t depth_;
+};
+
+}
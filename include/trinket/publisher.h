@@ -6,9 +6,10 @@
 
 #pragma once
 
-#include <any>
-
+#include "message_broker.h"
+#include "message_data.h"
 #include "message_type.h"
+#include "subscription_channel.h"
 
 namespace trinket
 {
@@ -26,13 +27,30 @@ class Publisher
     /*
      * Publish a message to all subscribers.
      *
-     * @param message_type
-     *   Type of message being sent (will be sent to subscribers of this type).
+     * @param data
+     *   Data for the message (will be sent to subscribers of this type).
+     */
+    template <MessageType T>
+    void publish(const MessageData<T> &data = {})
+    {
+        MessageBroker::instance().publish<T>(data);
+    }
+
+    /*
+     * Publish a message addressed to a key, it will only be delivered to subscribers of that key (and any subscribers
+     * of all messages of the type).
+     *
+     * @param key
+     *   Key message is addressed to.
      *
      * @param data
-     *   Any data for the message.
+     *   Data for the message.
      */
-    void publish(MessageType message_type, const std::any &data);
+    template <MessageType T>
+    void publish(MessageKey key, const MessageData<T> &data)
+    {
+        MessageBroker::instance().publish<T>(key, data);
+    }
 };
 
 }
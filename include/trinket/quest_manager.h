@@ -14,6 +14,7 @@
 #include "game_object.h"
 #include "publisher.h"
 #include "quest.h"
+#include "update_phase.h"
 
 namespace trinket
 {
@@ -47,6 +48,14 @@ class QuestManager : public GameObject, Publisher
      */
     void update(std::chrono::microseconds elapsed) override;
 
+    /**
+     * Get the phase of the frame this object should be updated in.
+     *
+     * @returns
+     *   Update phase.
+     */
+    UpdatePhase update_phase() const override;
+
   private:
     /** Collection of created quests. */
     std::vector<std::unique_ptr<Quest>> quests_;
@@ -0,0 +1,189 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "iris/core/vector3.h"
+#include "iris/scripting/script_runner.h"
+
+#include "enemy_ai.h"
+#include "enemy_decision.h"
+#include "job_system.h"
+
+namespace trinket
+{
+
+/**
+ * Implementation of EnemyAi for a single enemy's view of a shared script. The enemy's state lives in a table inside the
+ * script's lua state, keyed on an id, so scripts implement:
+ *
+ *   function init(id, bounds_min, bounds_max)
+ *   function tick(id, enemy_position, player_position, steering, elapsed, health) (see tick_script)
+ *   function release(id)
+ *
+ * Enemies sharing a lua state may be updated on different threads, so every call holds the lock of the lua state.
+ */
+class EnemyScript : public EnemyAi
+{
+  public:
+    /**
+     * Construct a new EnemyScript, calls init in the script.
+     *
+     * @param script
+     *   Shared script.
+     *
+     * @param mutex
+     *   Lock for shared script.
+     *
+     * @param id
+     *   Id of enemy, unique within the script.
+     *
+     * @param bounds_min
+     *   Minimum bounds of enemy patrol zone.
+     *
+     * @param bounds_max
+     *   Maximum bounds of enemy patrol zone.
+     */
+    EnemyScript(
+        iris::ScriptRunner &script,
+        std::mutex &mutex,
+        std::int32_t id,
+        const iris::Vector3 &bounds_min,
+        const iris::Vector3 &bounds_max);
+
+    /**
+     * Calls release in the script, so the enemy's state can be collected.
+     */
+    ~EnemyScript() override;
+
+    EnemyScript(const EnemyScript &) = delete;
+    EnemyScript &operator=(const EnemyScript &) = delete;
+
+    /**
+     * Run one tick of the script for this enemy.
+     *
+     * @param position
+     *   Position of enemy.
+     *
+     * @param player_position
+     *   Position of player.
+     *
+     * @param steering
+     *   Direction to walk to reach the player around static geometry.
+     *
+     * @param elapsed
+     *   Simulation time.
+     *
+     * @param health
+     *   Health of enemy.
+     *
+     * @returns
+     *   Decision made by script.
+     */
+    EnemyDecision tick(
+        const iris::Vector3 &position,
+        const iris::Vector3 &player_position,
+        const iris::Vector3 &steering,
+        std::chrono::microseconds elapsed,
+        float health) override;
+
+  private:
+    /** Shared script. */
+    iris::ScriptRunner &script_;
+
+    /** Lock for shared script. */
+    std::mutex &mutex_;
+
+    /** Id of enemy. */
+    std::int32_t id_;
+};
+
+/**
+ * Class for sharing compiled enemy scripts, so spawning an enemy only creates a table rather than reading, compiling
+ * and running a whole lua state.
+ *
+ * Each script file is compiled into a fixed number of lua states (one per thread which updates enemies, to limit how
+ * often parallel enemies wait on each other) and new enemies are spread across them. Scripts stay compiled for the
+ * lifetime of the pool, so moving between zones doesn't compile them again.
+ *
+ * Must only be used from the main thread, the EnemyScripts it creates may be ticked from any thread.
+ */
+class ScriptPool
+{
+  public:
+    /**
+     * Construct a new ScriptPool.
+     *
+     * @param state_count
+     *   Number of lua states to compile each script into.
+     */
+    explicit ScriptPool(std::uint32_t state_count);
+
+    /**
+     * Compile any scripts which haven't already been loaded, native scripts (see is_native_ai) are skipped. Files are
+     * read on the calling thread (as the resource loader isn't thread safe) but each lua state is compiled as a
+     * separate job.
+     *
+     * @param script_files
+     *   Paths to script resources, may contain duplicates.
+     *
+     * @param jobs
+     *   Job system to compile scripts with.
+     */
+    void load(const std::vector<std::string> &script_files, JobSystem &jobs);
+
+    /**
+     * Create the script for a new enemy.
+     *
+     * @param script_file
+     *   Path to script resource, must have been loaded.
+     *
+     * @param bounds_min
+     *   Minimum bounds of enemy patrol zone.
+     *
+     * @param bounds_max
+     *   Maximum bounds of enemy patrol zone.
+     *
+     * @returns
+     *   Enemy script, must not outlive the pool.
+     */
+    std::unique_ptr<EnemyAi> create(
+        const std::string &script_file,
+        const iris::Vector3 &bounds_min,
+        const iris::Vector3 &bounds_max);
+
+  private:
+    /**
+     * Internal struct for a compiled lua state.
+     */
+    struct State
+    {
+        /** Compiled script. */
+        std::unique_ptr<iris::ScriptRunner> script;
+
+        /** Lock for script. */
+        std::mutex mutex;
+    };
+
+    /** Number of lua states each script is compiled into. */
+    std::uint32_t state_count_;
+
+    /** Map of script file to its lua states. */
+    std::unordered_map<std::string, std::vector<std::unique_ptr<State>>> scripts_;
+
+    /** Id of next enemy created. */
+    std::int32_t next_id_;
+};
+
+}
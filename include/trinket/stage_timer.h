@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace trinket
+{
+
+/**
+ * Class for timing the stages of a multi stage operation (e.g. loading a zone) and logging them as a single line, so
+ * the effect of running stages on more threads is easy to compare.
+ */
+class StageTimer
+{
+  public:
+    /**
+     * Construct a new StageTimer.
+     *
+     * @param name
+     *   Name of operation being timed.
+     *
+     * @param thread_count
+     *   Number of threads parallel stages are run on.
+     */
+    StageTimer(const std::string &name, std::uint32_t thread_count);
+
+    /**
+     * End the current stage (if any) and start a new one.
+     *
+     * @param stage
+     *   Name of stage.
+     */
+    void start(const std::string &stage);
+
+    /**
+     * End the current stage and log the time taken by every stage.
+     */
+    void log();
+
+  private:
+    /** Name of operation being timed. */
+    std::string name_;
+
+    /** Number of threads parallel stages are run on. */
+    std::uint32_t thread_count_;
+
+    /** Completed stages, name and duration. */
+    std::vector<std::tuple<std::string, std::chrono::steady_clock::duration>> stages_;
+
+    /** Name of current stage, empty if none. */
+    std::string current_;
+
+    /** Time current stage started. */
+    std::chrono::steady_clock::time_point current_start_;
+};
+
+}
@@ -0,0 +1,263 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "iris/core/quaternion.h"
+#include "iris/core/vector3.h"
+#include "iris/graphics/mesh.h"
+#include "iris/physics/collision_shape.h"
+#include "iris/physics/physics_system.h"
+
+#include "job_system.h"
+#include "nav_grid.h"
+
+namespace trinket
+{
+
+/**
+ * Class for creating a zone's static rigid bodies.
+ *
+ * Collision shapes are shared between bodies with the same mesh and scale (or the same box), and mesh bounds are only
+ * computed once per mesh. Optionally, boxes with the same name, orientation and size which touch or overlap along one
+ * of their axes are merged into a single larger box, so runs of modular geometry (e.g. dungeon walls) become one body.
+ *
+ * Bodies are collected with the add functions and created by build. Mesh bounds and merging are spread across a job
+ * system, only creating the shapes and bodies happens on the calling thread (as the physics system isn't thread safe).
+ * Built bodies are also added to the zone's NavGrid, after merging so it has fewer to rasterise.
+ */
+class StaticBodyBuilder
+{
+  public:
+    /**
+     * Construct a new StaticBodyBuilder.
+     *
+     * @param ps
+     *   Physics system to create shapes and bodies in.
+     *
+     * @param merge_boxes
+     *   True if touching boxes should be merged.
+     */
+    StaticBodyBuilder(iris::PhysicsSystem *ps, bool merge_boxes);
+
+    /**
+     * Add a box body.
+     *
+     * @param name
+     *   Name of body.
+     *
+     * @param position
+     *   World position.
+     *
+     * @param orientation
+     *   Orientation.
+     *
+     * @param half_extents
+     *   Half extents of box.
+     */
+    void add_box(
+        const std::string &name,
+        const iris::Vector3 &position,
+        const iris::Quaternion &orientation,
+        const iris::Vector3 &half_extents);
+
+    /**
+     * Add a box body sized to the bounding box of a mesh.
+     *
+     * @param name
+     *   Name of body.
+     *
+     * @param mesh
+     *   Mesh to get bounds of.
+     *
+     * @param position
+     *   World position.
+     *
+     * @param orientation
+     *   Orientation.
+     *
+     * @param scale
+     *   Scale of mesh.
+     */
+    void add_bounding_box(
+        const std::string &name,
+        const iris::Mesh *mesh,
+        const iris::Vector3 &position,
+        const iris::Quaternion &orientation,
+        const iris::Vector3 &scale);
+
+    /**
+     * Add a body with a mesh collision shape.
+     *
+     * @param name
+     *   Name of body.
+     *
+     * @param mesh
+     *   Mesh to create shape from.
+     *
+     * @param position
+     *   World position.
+     *
+     * @param orientation
+     *   Orientation.
+     *
+     * @param scale
+     *   Scale of mesh.
+     */
+    void add_mesh(
+        const std::string &name,
+        const iris::Mesh *mesh,
+        const iris::Vector3 &position,
+        const iris::Quaternion &orientation,
+        const iris::Vector3 &scale);
+
+    /**
+     * Set the bounds of a mesh, so build doesn't need to walk its vertices.
+     *
+     * @param mesh
+     *   Mesh to set bounds of.
+     *
+     * @param min
+     *   Minimum corner of mesh, in mesh space.
+     *
+     * @param max
+     *   Maximum corner of mesh, in mesh space.
+     */
+    void set_mesh_bounds(const iris::Mesh *mesh, const iris::Vector3 &min, const iris::Vector3 &max);
+
+    /**
+     * Create all added bodies, and add them to a navigation grid. Mesh bodies are navigated around as their bounding
+     * box.
+     *
+     * @param jobs
+     *   Job system to compute bounds and merge boxes with.
+     *
+     * @param nav
+     *   Navigation grid to add bodies to.
+     */
+    void build(JobSystem &jobs, NavGrid &nav);
+
+  private:
+    /**
+     * Internal struct for a box body.
+     */
+    struct Box
+    {
+        /** Name of body. */
+        std::string name;
+
+        /** World position. */
+        iris::Vector3 position;
+
+        /** Orientation. */
+        iris::Quaternion orientation;
+
+        /** Half extents of box, or scale of mesh if box is a mesh's bounds. */
+        iris::Vector3 half_extents;
+
+        /** Mesh box is the bounds of, nullptr if half extents are already known. */
+        const iris::Mesh *mesh;
+    };
+
+    /**
+     * Internal struct for a mesh body.
+     */
+    struct MeshBody
+    {
+        /** Name of body. */
+        std::string name;
+
+        /** Mesh to create shape from. */
+        const iris::Mesh *mesh;
+
+        /** World position. */
+        iris::Vector3 position;
+
+        /** Orientation. */
+        iris::Quaternion orientation;
+
+        /** Scale of mesh. */
+        iris::Vector3 scale;
+    };
+
+    /**
+     * Compute the bounds of every mesh added with add_bounding_box (which weren't set with set_mesh_bounds), and size
+     * their boxes.
+     *
+     * @param jobs
+     *   Job system to compute bounds with.
+     *
+     * @param mesh_bodies
+     *   True if the bounds of meshes added with add_mesh are also needed.
+     */
+    void resolve_bounds(JobSystem &jobs, bool mesh_bodies);
+
+    /**
+     * Merge boxes which touch along an axis.
+     *
+     * @param jobs
+     *   Job system to merge with, each group of identical boxes is merged as a separate job.
+     *
+     * @param axis
+     *   Axis (in the boxes' local space) to merge along, 0 = x, 1 = y, 2 = z.
+     */
+    void merge(JobSystem &jobs, std::size_t axis);
+
+    /**
+     * Create a rigid body.
+     *
+     * @param name
+     *   Name of body.
+     *
+     * @param position
+     *   World position.
+     *
+     * @param orientation
+     *   Orientation.
+     *
+     * @param shape
+     *   Collision shape.
+     */
+    void create_body(
+        const std::string &name,
+        const iris::Vector3 &position,
+        const iris::Quaternion &orientation,
+        const iris::CollisionShape *shape);
+
+    /** Physics system to create shapes and bodies in. */
+    iris::PhysicsSystem *ps_;
+
+    /** Flag indicating if touching boxes should be merged. */
+    bool merge_boxes_;
+
+    /** Box bodies to create. */
+    std::vector<Box> boxes_;
+
+    /** Mesh bodies to create. */
+    std::vector<MeshBody> meshes_;
+
+    /** Half extents of each mesh's bounding box (unscaled). */
+    std::unordered_map<const iris::Mesh *, iris::Vector3> mesh_bounds_;
+
+    /** Box shapes, keyed on half extents. */
+    std::map<std::tuple<float, float, float>, const iris::CollisionShape *> box_shapes_;
+
+    /** Mesh shapes, keyed on mesh and scale. */
+    std::map<std::tuple<const iris::Mesh *, float, float, float>, const iris::CollisionShape *> mesh_shapes_;
+
+    /** Number of shape requests which reused an existing shape. */
+    std::uint32_t shapes_reused_;
+};
+
+}
@@ -6,44 +6,55 @@
 
 #pragma once
 
-#include <any>
-#include <set>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
 
+#include "message_broker.h"
+#include "message_data.h"
 #include "message_type.h"
+#include "subscription_channel.h"
 
 namespace trinket
 {
 
 /**
  * Abstract class for receiving messages.
+ *
+ * Derived classes subscribe to a message type and provide an overload of handle_message for it, e.g.
+ *
+ *   subscribe<MessageType::KEY_PRESS>(this);
+ *   void handle_message(const Message<MessageType::KEY_PRESS> &message);
  */
 class Subscriber
 {
   public:
     virtual ~Subscriber();
 
-    /**
-     * Message handler.
-     *
-     * @param message_type
-     *   Type of message being sent.
-     *
-     * @param data
-     *   Any data for the message.
-     */
-    virtual void handle_message(MessageType message_type, const std::any &data) = 0;
-
   protected:
     /**
      * Subscribe to a message type.
      *
-     * @param message_type
-     *   Message type to subscribe to,
+     * @param subscriber
+     *   The derived object subscribing (i.e. this), must have a public handle_message overload for the message type.
+     *
+     * @param key
+     *   Only receive messages published with this key, nullptr to receive all messages of the type.
      */
-    void subscribe(MessageType message_type);
-
-    /** Collection og subscribed message types. */
-    std::set<MessageType> subscribed_;
+    template <MessageType T, class S>
+    void subscribe(S *subscriber, MessageKey key = nullptr)
+    {
+        static_assert(std::is_base_of_v<Subscriber, S>, "subscriber must derive from Subscriber");
+
+        subscriptions_.emplace_back(MessageBroker::instance().subscribe<T>(
+            subscriber,
+            [](Subscriber *sub, const Message<T> &message) { static_cast<S *>(sub)->handle_message(message); },
+            key,
+            typeid(S)));
+    }
+
+    /** Collection of subscriptions. */
+    std::vector<SubscriptionHandle> subscriptions_;
 };
 
 }
@@ -0,0 +1,411 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "message_data.h"
+#include "message_stats.h"
+#include "message_type.h"
+
+namespace trinket
+{
+
+class Subscriber;
+
+/**
+ * Function called to deliver a message to a subscriber.
+ */
+template <MessageType T>
+using MessageHandler = void (*)(Subscriber *, const Message<T> &);
+
+/**
+ * Key used to address a message to specific subscribers, typically the address of the object the message is about
+ * (e.g. a rigid body). A nullptr key means the message/subscription is not addressed.
+ */
+using MessageKey = const void *;
+
+/**
+ * Handle to a single subscription. Handles are generational, so using a handle after it has been unsubscribed (even if
+ * its slot has since been reused) is safe and does nothing.
+ */
+struct SubscriptionHandle
+{
+    /** Type of message subscribed to. */
+    MessageType type;
+
+    /** Index of slot in channel. */
+    std::uint32_t slot;
+
+    /** Generation of slot when subscription was made. */
+    std::uint32_t generation;
+};
+
+/**
+ * The subscriptions for a single message type, stored as a slot map. Subscriptions are kept densely packed for
+ * dispatch and subscribe/unsubscribe are both O(1).
+ *
+ * A subscription can either be a broadcast subscription, which receives every message of the type, or a keyed
+ * subscription, which only receives messages published with the same key. This means an addressed message is only
+ * delivered to the subscribers that want it rather than every subscriber having to check if it is the recipient.
+ *
+ * Unsubscribing whilst a message is being dispatched is safe: the subscription is marked as dead (and will not receive
+ * any further messages) and is removed once the outermost dispatch has finished. Subscriptions added during a dispatch
+ * will not receive the message currently being dispatched.
+ */
+template <MessageType T>
+class SubscriptionChannel
+{
+  public:
+    /** Type of message for this channel. */
+    static constexpr MessageType type = T;
+
+    /**
+     * Construct a new empty SubscriptionChannel.
+     */
+    SubscriptionChannel()
+        : broadcast_()
+        , keyed_()
+        , slots_()
+        , free_slots_()
+        , dispatch_depth_(0u)
+        , dirty_keys_()
+    {
+    }
+
+    /**
+     * Add a subscription.
+     *
+     * @param subscriber
+     *   Object wanting to subscribe.
+     *
+     * @param handler
+     *   Function to call to deliver message to subscriber.
+     *
+     * @param key
+     *   Key to subscribe to, nullptr for a broadcast subscription.
+     *
+     * @param class_id
+     *   Id of subscriber class, used for recording stats.
+     *
+     * @returns
+     *   Handle to subscription.
+     */
+    SubscriptionHandle add(Subscriber *subscriber, MessageHandler<T> handler, MessageKey key, std::uint32_t class_id)
+    {
+        std::uint32_t slot_index = 0u;
+
+        if (free_slots_.empty())
+        {
+            slot_index = static_cast<std::uint32_t>(slots_.size());
+            slots_.push_back({0u, 0u, nullptr});
+        }
+        else
+        {
+            slot_index = free_slots_.back();
+            free_slots_.pop_back();
+        }
+
+        auto &entries = entries_for(key);
+
+        auto &slot = slots_[slot_index];
+        slot.index = static_cast<std::uint32_t>(entries.size());
+        slot.key = key;
+        entries.push_back({subscriber, handler, slot_index, class_id});
+
+        return {T, slot_index, slot.generation};
+    }
+
+    /**
+     * Remove a subscription. Does nothing if the handle is stale.
+     *
+     * @param handle
+     *   Handle of subscription to remove.
+     */
+    void remove(const SubscriptionHandle &handle)
+    {
+        if ((handle.slot >= slots_.size()) || (slots_[handle.slot].generation != handle.generation))
+        {
+            return;
+        }
+
+        auto &slot = slots_[handle.slot];
+
+        // bumping the generation invalidates any existing handles to this slot
+        ++slot.generation;
+
+        if (dispatch_depth_ == 0u)
+        {
+            erase(slot.key, slot.index);
+        }
+        else
+        {
+            // we are mid dispatch so cannot move entries around, instead mark the entry as dead and clean up once the
+            // dispatch has finished
+            entries_for(slot.key)[slot.index].handler = nullptr;
+            dirty_keys_.push_back(slot.key);
+        }
+    }
+
+    /**
+     * Deliver a message to all broadcast subscribers and, if a key is supplied, to all subscribers of that key.
+     *
+     * @param key
+     *   Key message is addressed to, nullptr if message is not addressed.
+     *
+     * @param data
+     *   Data for the message.
+     *
+     * @param stats
+     *   Stats to record dispatch in, nullptr if stats are not being recorded.
+     */
+    void dispatch(MessageKey key, const MessageData<T> &data, MessageStats *stats)
+    {
+        const Message<T> message{data};
+        std::uint32_t fan_out = 0u;
+
+        ++dispatch_depth_;
+
+        if (key != nullptr)
+        {
+            // unordered_map references are stable, so this is safe even if a handler subscribes with a new key
+            if (auto keyed = keyed_.find(key); keyed != std::end(keyed_))
+            {
+                fan_out += stats == nullptr ? deliver(keyed->second, message) : deliver(keyed->second, message, *stats);
+            }
+        }
+
+        fan_out += stats == nullptr ? deliver(broadcast_, message) : deliver(broadcast_, message, *stats);
+
+        --dispatch_depth_;
+
+        if (stats != nullptr)
+        {
+            stats->record_dispatch(T, fan_out);
+        }
+
+        if ((dispatch_depth_ == 0u) && !dirty_keys_.empty())
+        {
+            compact();
+        }
+    }
+
+    /**
+     * Get number of subscriptions.
+     *
+     * @returns
+     *   Number of subscriptions.
+     */
+    std::size_t size() const
+    {
+        return slots_.size() - free_slots_.size();
+    }
+
+  private:
+    /**
+     * Internal struct for a subscription.
+     */
+    struct Entry
+    {
+        /** Object that subscribed. */
+        Subscriber *subscriber;
+
+        /** Function to deliver message to subscriber, nullptr if subscription is dead. */
+        MessageHandler<T> handler;
+
+        /** Index of slot that refers to this entry. */
+        std::uint32_t slot;
+
+        /** Id of subscriber class. */
+        std::uint32_t class_id;
+    };
+
+    /**
+     * Internal struct for a slot, which maps a handle to an entry.
+     */
+    struct Slot
+    {
+        /** Index into entries. */
+        std::uint32_t index;
+
+        /** Current generation of slot. */
+        std::uint32_t generation;
+
+        /** Key of entry, nullptr for broadcast. */
+        MessageKey key;
+    };
+
+    /**
+     * Get the entries for a key.
+     *
+     * @param key
+     *   Key to get entries for, nullptr for broadcast.
+     *
+     * @returns
+     *   Entries for key.
+     */
+    std::vector<Entry> &entries_for(MessageKey key)
+    {
+        return key == nullptr ? broadcast_ : keyed_[key];
+    }
+
+    /**
+     * Deliver a message to a collection of entries.
+     *
+     * @param entries
+     *   Entries to deliver to.
+     *
+     * @param message
+     *   Message to deliver.
+     *
+     * @returns
+     *   Number of subscribers message was delivered to.
+     */
+    static std::uint32_t deliver(std::vector<Entry> &entries, const Message<T> &message)
+    {
+        std::uint32_t delivered = 0u;
+
+        // handlers may subscribe to this channel (which may reallocate entries) so index rather than iterate and take
+        // a copy of the entry before calling it, we also only deliver to entries which existed when we started
+        const auto count = entries.size();
+        for (std::size_t i = 0u; i < count; ++i)
+        {
+            const auto entry = entries[i];
+            if (entry.handler != nullptr)
+            {
+                entry.handler(entry.subscriber, message);
+                ++delivered;
+            }
+        }
+
+        return delivered;
+    }
+
+    /**
+     * Deliver a message to a collection of entries, timing each handler. This is kept separate from the untimed
+     * version so there is no cost when stats are not being recorded.
+     *
+     * @param entries
+     *   Entries to deliver to.
+     *
+     * @param message
+     *   Message to deliver.
+     *
+     * @param stats
+     *   Stats to record handler times in.
+     *
+     * @returns
+     *   Number of subscribers message was delivered to.
+     */
+    static std::uint32_t deliver(std::vector<Entry> &entries, const Message<T> &message, MessageStats &stats)
+    {
+        std::uint32_t delivered = 0u;
+
+        const auto count = entries.size();
+        for (std::size_t i = 0u; i < count; ++i)
+        {
+            const auto entry = entries[i];
+            if (entry.handler != nullptr)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                entry.handler(entry.subscriber, message);
+                const auto end = std::chrono::steady_clock::now();
+
+                stats.record_handler(T, entry.class_id, end - start);
+                ++delivered;
+            }
+        }
+
+        return delivered;
+    }
+
+    /**
+     * Remove an entry by swapping it with the last entry.
+     *
+     * @param key
+     *   Key of entry to remove.
+     *
+     * @param index
+     *   Index of entry to remove.
+     */
+    void erase(MessageKey key, std::uint32_t index)
+    {
+        auto &entries = entries_for(key);
+        const auto slot_index = entries[index].slot;
+
+        if (index != entries.size() - 1u)
+        {
+            entries[index] = entries.back();
+            slots_[entries[index].slot].index = index;
+        }
+
+        entries.pop_back();
+        free_slots_.push_back(slot_index);
+
+        // don't keep empty collections around for keys, they are often addresses of short lived objects
+        if ((key != nullptr) && entries.empty())
+        {
+            keyed_.erase(key);
+        }
+    }
+
+    /**
+     * Remove all dead entries.
+     */
+    void compact()
+    {
+        for (const auto key : dirty_keys_)
+        {
+            if ((key != nullptr) && !keyed_.contains(key))
+            {
+                // already compacted
+                continue;
+            }
+
+            auto &entries = entries_for(key);
+
+            for (auto i = static_cast<std::uint32_t>(entries.size()); i > 0u; --i)
+            {
+                if (entries[i - 1u].handler == nullptr)
+                {
+                    erase(key, i - 1u);
+
+                    if ((key != nullptr) && !keyed_.contains(key))
+                    {
+                        break;
+                    }
+                }
+            }
+        }
+
+        dirty_keys_.clear();
+    }
+
+    /** Densely packed broadcast subscriptions. */
+    std::vector<Entry> broadcast_;
+
+    /** Densely packed keyed subscriptions. */
+    std::unordered_map<MessageKey, std::vector<Entry>> keyed_;
+
+    /** Slots for mapping handles to entries. */
+    std::vector<Slot> slots_;
+
+    /** Indices of unused slots. */
+    std::vector<std::uint32_t> free_slots_;
+
+    /** Number of dispatches in progress (a handler may publish the same message type). */
+    std::uint32_t dispatch_depth_;
+
+    /** Keys which have dead entries to remove. */
+    std::vector<MessageKey> dirty_keys_;
+};
+
+}
@@ -6,7 +6,6 @@
 
 #pragma once
 
-#include <any>
 #include <chrono>
 #include <cstdint>
 #include <map>
@@ -16,9 +15,12 @@
 #include "iris/physics/physics_system.h"
 
 #include "game_object.h"
+#include "message_data.h"
 #include "message_type.h"
 #include "player.h"
 #include "subscriber.h"
+#include "transform_interpolator.h"
+#include "update_phase.h"
 
 namespace trinket
 {
@@ -26,7 +28,7 @@ namespace trinket
 /**
  * Implementation of GameObject for a third person camera i.e a camera that always follows and looks at the player.
  */
-class ThirdPersonCamera : public GameObject, Subscriber
+class ThirdPersonCamera : public GameObject, public Subscriber
 {
   public:
     /**
@@ -40,11 +42,16 @@ class ThirdPersonCamera : public GameObject, Subscriber
      *
      * @param height
      *   Screen height.
+     */
+    ThirdPersonCamera(Player *player, std::uint32_t width, std::uint32_t height);
+
+    /**
+     * Bind the camera to a newly loaded zone.
      *
      * @param ps
      *   Physics system.
      */
-    ThirdPersonCamera(Player *player, std::uint32_t width, std::uint32_t height, iris::PhysicsSystem *ps);
+    void bind(iris::PhysicsSystem *ps);
 
     /**
      * Update object.
@@ -54,6 +61,22 @@ class ThirdPersonCamera : public GameObject, Subscriber
      */
     void update(std::chrono::microseconds) override;
 
+    /**
+     * Get the phase of the frame this object should be updated in.
+     *
+     * @returns
+     *   Update phase.
+     */
+    UpdatePhase update_phase() const override;
+
+    /**
+     * Add anything this object renders, and which moves, to an interpolator so it is rendered smoothly between ticks.
+     *
+     * @param interpolator
+     *   Interpolator to add to.
+     */
+    void add_interpolated(TransformInterpolator &interpolator) override;
+
     /**
      * Get the engine camera object.
      *
@@ -69,17 +92,29 @@ class ThirdPersonCamera : public GameObject, Subscriber
      */
     const iris::Camera *camera() const;
 
-  protected:
     /**
-     * Message handler.
+     * Handle mouse move message.
      *
-     * @param message_type
-     *   Type of message being sent.
+     * @param message
+     *   Message data.
+     */
+    void handle_message(const Message<MessageType::MOUSE_MOVE> &message);
+
+    /**
+     * Handle key press message.
+     *
+     * @param message
+     *   Message data.
+     */
+    void handle_message(const Message<MessageType::KEY_PRESS> &message);
+
+    /**
+     * Handle scroll wheel message.
      *
-     * @param data
-     *   Any data for the message.
+     * @param message
+     *   Message data.
      */
-    void handle_message(MessageType message_type, const std::any &data) override;
+    void handle_message(const Message<MessageType::SCROLL_WHEEL> &message);
 
   private:
     /** Pointer to player to follow. */
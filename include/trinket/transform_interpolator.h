@@ -0,0 +1,107 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+
+#include "iris/core/camera.h"
+#include "iris/core/transform.h"
+#include "iris/core/vector3.h"
+#include "iris/graphics/render_entity.h"
+
+namespace trinket
+{
+
+/**
+ * Class for smoothing rendering when the simulation runs at a fixed tick rate. It records the transforms of entities
+ * at the end of the last two ticks and, when rendering, sets each entity to a blend of the two based on how far we are
+ * through the current tick.
+ *
+ * Game logic reads entity transforms, so before each tick the transforms from the end of the last tick must be
+ * restored. This means the simulation never sees interpolated values.
+ */
+class TransformInterpolator
+{
+  public:
+    /**
+     * Construct a new empty TransformInterpolator.
+     */
+    TransformInterpolator();
+
+    /**
+     * Add an entity to interpolate.
+     *
+     * @param entity
+     *   Entity to interpolate.
+     */
+    void add(iris::RenderEntity *entity);
+
+    /**
+     * Add a camera to interpolate, only the position is interpolated.
+     *
+     * @param camera
+     *   Camera to interpolate.
+     */
+    void add(iris::Camera *camera);
+
+    /**
+     * Restore all entities to their state at the end of the last tick, must be called before each tick.
+     */
+    void begin_tick();
+
+    /**
+     * Record the state of all entities, must be called after each tick.
+     */
+    void end_tick();
+
+    /**
+     * Set all entities to a blend of their state at the end of the last two ticks.
+     *
+     * @param alpha
+     *   How far through the current tick we are, in range [0, 1].
+     */
+    void interpolate(float alpha);
+
+  private:
+    /**
+     * Internal struct for an interpolated entity.
+     */
+    struct EntityState
+    {
+        /** Entity to interpolate. */
+        iris::RenderEntity *entity;
+
+        /** Transform at end of previous tick. */
+        iris::Transform previous;
+
+        /** Transform at end of last tick. */
+        iris::Transform current;
+    };
+
+    /**
+     * Internal struct for an interpolated camera.
+     */
+    struct CameraState
+    {
+        /** Camera to interpolate. */
+        iris::Camera *camera;
+
+        /** Position at end of previous tick. */
+        iris::Vector3 previous;
+
+        /** Position at end of last tick. */
+        iris::Vector3 current;
+    };
+
+    /** Interpolated entities. */
+    std::vector<EntityState> entities_;
+
+    /** Interpolated cameras. */
+    std::vector<CameraState> cameras_;
+};
+
+}
@@ -0,0 +1,26 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <typeinfo>
+
+namespace trinket
+{
+
+/**
+ * Get a human readable name for a type.
+ *
+ * @param type
+ *   Type to get name of.
+ *
+ * @returns
+ *   Name of type (demangled where supported).
+ */
+std::string type_name(const std::type_info &type);
+
+}
@@ -4,19 +4,23 @@
 //                 https://www.boost.org/LICENSE_1_0.txt)                     //
 ////////////////////////////////////////////////////////////////////////////////
 
-#include "publisher.h"
+#pragma once
 
-#include <any>
-
-#include "message_broker.h"
-#include "message_type.h"
+#include <cstdint>
 
 namespace trinket
 {
 
-void Publisher::publish(MessageType message_type, const std::any &data)
+/**
+ * Enumeration of phases of a frame update. All objects in a phase are updated before any object in a later phase.
+ */
+enum class UpdatePhase : std::uint8_t
 {
-    MessageBroker::instance().publish(message_type, data);
-}
+    INPUT,
+    CAMERA,
+    PLAYER,
+    AI,
+    PRESENTATION
+};
 
 }
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <cstdint>
+#include <map>
 #include <string>
 #include <unordered_map>
 #include <variant>
@@ -76,8 +77,31 @@ class YamlConfig : public Config
      */
     std::vector<std::string> string_array_option(ConfigOption option) override;
 
+    /**
+     * Get option as a map of strings to strings.
+     *
+     * @param option
+     *   Option to get.
+     *
+     * @returns
+     *   Option as a map of strings.
+     */
+    std::map<std::string, std::string> string_map_option(ConfigOption option) override;
+
+    /**
+     * Override a bool option, e.g. from the command line.
+     *
+     * @param option
+     *   Option to set.
+     *
+     * @param value
+     *   New value.
+     */
+    void set_bool_option(ConfigOption option, bool value);
+
   private:
-    using ConfigTypes = std::variant<std::string, std::uint32_t, bool, std::vector<std::string>>;
+    using ConfigTypes =
+        std::variant<std::string, std::uint32_t, bool, std::vector<std::string>, std::map<std::string, std::string>>;
 
     /** Loaded config types. */
     std::unordered_map<ConfigOption, ConfigTypes> options_;
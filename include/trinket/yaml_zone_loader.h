@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -18,8 +20,12 @@
 #include "yaml-cpp/yaml.h"
 
 #include "game_object.h"
+#include "job_system.h"
+#include "nav_grid.h"
 #include "player.h"
+#include "script_pool.h"
 #include "third_person_camera.h"
+#include "zone_cells.h"
 #include "zone_loader.h"
 
 namespace trinket
@@ -36,8 +42,11 @@ class YamlZoneLoader : public ZoneLoader
      *
      * @param zone_file
      *   YAML file to parse.
+     *
+     * @param merge_static_bodies
+     *   True if touching static boxes should be merged into single bodies.
      */
-    YamlZoneLoader(const std::string &zone_file);
+    YamlZoneLoader(const std::string &zone_file, bool merge_static_bodies);
 
     /**
      * Get the name of the zone.
@@ -62,13 +71,27 @@ class YamlZoneLoader : public ZoneLoader
      *   Physics system.
      *
      * @param scene
-     *   Scene to load into.
+     *   Scene to load into, nullptr if headless (only physics data will be loaded).
      *
      * @param render_pipeline
-     *   Render pipeline to use.
+     *   Render pipeline to use, nullptr if headless.
+     *
+     * @param cells
+     *   Cells to add static instances to, they create the render entities.
+     *
+     * @param nav
+     *   Navigation grid to add static bodies to.
+     *
+     * @param jobs
+     *   Job system for stages of loading which can run in parallel.
      */
-    void load_static_geometry(iris::PhysicsSystem *ps, iris::Scene *scene, iris::RenderPipeline &render_pipeline)
-        override;
+    void load_static_geometry(
+        iris::PhysicsSystem *ps,
+        iris::Scene *scene,
+        iris::RenderPipeline *render_pipeline,
+        ZoneCells &cells,
+        NavGrid &nav,
+        JobSystem &jobs) override;
 
     /**
      * Load enemies.
@@ -77,10 +100,10 @@ class YamlZoneLoader : public ZoneLoader
      *   Physics system.
      *
      * @param scene
-     *   Scene to load into.
+     *   Scene to load into, nullptr if headless (only physics data will be loaded).
      *
      * @param render_pipeline
-     *   Render pipeline to use.
+     *   Render pipeline to use, nullptr if headless.
      *
      * @param game_objects
      *   Collection of game objects to add enemies to.
@@ -89,15 +112,27 @@ class YamlZoneLoader : public ZoneLoader
      *   Pointer to player object.
      *
      * @param camera
-     *   Pointer to camera object,
+     *   Pointer to camera object, nullptr if headless.
+     *
+     * @param nav
+     *   Navigation grid enemies steer towards the player with.
+     *
+     * @param scripts
+     *   Pool to load and create enemy scripts from.
+     *
+     * @param jobs
+     *   Job system for stages of loading which can run in parallel.
      */
     void load_enemies(
         iris::PhysicsSystem *ps,
         iris::Scene *scene,
-        iris::RenderPipeline &render_pipeline,
+        iris::RenderPipeline *render_pipeline,
         std::vector<std::unique_ptr<GameObject>> &game_objects,
         Player *player,
-        ThirdPersonCamera *camera) override;
+        ThirdPersonCamera *camera,
+        const NavGrid &nav,
+        ScriptPool &scripts,
+        JobSystem &jobs) override;
 
     /**
      * Get portal data.
@@ -107,9 +142,60 @@ class YamlZoneLoader : public ZoneLoader
      */
     std::tuple<iris::Transform, std::string> portal() override;
 
+    /**
+     * Get all resource files used by the zone, so they can be read ahead of the zone being loaded. This only parses
+     * zone data so is cheap to call.
+     *
+     * @returns
+     *   Collection of resource files (relative to resource root).
+     */
+    std::vector<std::string> resource_files() override;
+
+    /**
+     * Start preloading the zone from its first step, must be called before preload_step.
+     */
+    void begin_preload() override;
+
+    /**
+     * Perform the next step of preloading the zone, this warms engine caches (e.g. decoding and uploading a mesh) so
+     * they are hits when the zone is actually loaded. Each step is small enough to be run during a frame.
+     *
+     * Must be called from the main thread.
+     *
+     * @returns
+     *   True if there are more steps to perform, false if preloading is complete.
+     */
+    bool preload_step() override;
+
   private:
+    /**
+     * Load the collision geometry that can be created without mesh data, used when headless.
+     *
+     * @param ps
+     *   Physics system.
+     *
+     * @param nav
+     *   Navigation grid to add static bodies to.
+     *
+     * @param jobs
+     *   Job system for stages of loading which can run in parallel.
+     */
+    void load_headless_geometry(iris::PhysicsSystem *ps, NavGrid &nav, JobSystem &jobs);
+
     /** YAML node. */
     YAML::Node yaml_file_;
+
+    /** Zone name, read once as it's looked up often. */
+    std::string name_;
+
+    /** Flag indicating if touching static boxes should be merged. */
+    bool merge_static_bodies_;
+
+    /** Preloading steps, created on first call to preload_step. */
+    std::vector<std::function<void()>> preload_steps_;
+
+    /** Index of next preloading step. */
+    std::size_t next_preload_step_;
 };
 
 }
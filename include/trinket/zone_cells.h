@@ -0,0 +1,269 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "iris/core/camera.h"
+#include "iris/core/transform.h"
+#include "iris/core/vector3.h"
+#include "iris/graphics/mesh.h"
+#include "iris/graphics/render_entity.h"
+#include "iris/graphics/render_graph/render_graph.h"
+#include "iris/graphics/scene.h"
+
+namespace trinket
+{
+
+/**
+ * Class for partitioning a zone into a uniform grid of cells (on the xz plane), so only content near the player or in
+ * view of the camera is rendered and updated.
+ *
+ * Static instances are added whilst the zone loads and grouped per cell by mesh and material. A cell's entities are
+ * only created in the scene whilst the cell is visible, and are removed again once it has been out of view for a short
+ * while (so turning the camera back and forth doesn't keep recreating them). Anything too large to belong to a single
+ * cell (e.g. a ground plane) is always visible.
+ *
+ * The grid is loose: each cell's bounds grow to fit the largest instance in it, so an instance only needs to be in the
+ * cell containing its origin.
+ */
+class ZoneCells
+{
+  public:
+    /**
+     * Construct a new ZoneCells.
+     *
+     * @param scene
+     *   Scene to create entities in, nullptr if headless.
+     *
+     * @param cell_size
+     *   Width and depth of a cell.
+     *
+     * @param active_radius
+     *   Number of cells around the player which are always active, regardless of the camera.
+     *
+     * @param enabled
+     *   True if culling is enabled, otherwise everything is always visible and active.
+     */
+    ZoneCells(iris::Scene *scene, float cell_size, std::uint32_t active_radius, bool enabled);
+
+    /**
+     * Add a static instance.
+     *
+     * @param render_graph
+     *   Render graph of instance, may be nullptr.
+     *
+     * @param mesh
+     *   Mesh of instance.
+     *
+     * @param transform
+     *   World transform of instance.
+     */
+    void add(iris::RenderGraph *render_graph, const iris::Mesh *mesh, const iris::Transform &transform);
+
+    /**
+     * Set the bounds of a mesh, so adding instances of it doesn't need to walk its vertices.
+     *
+     * @param mesh
+     *   Mesh to set bounds of.
+     *
+     * @param min
+     *   Minimum corner of mesh, in mesh space.
+     *
+     * @param max
+     *   Maximum corner of mesh, in mesh space.
+     */
+    void set_mesh_bounds(const iris::Mesh *mesh, const iris::Vector3 &min, const iris::Vector3 &max);
+
+    /**
+     * Finish adding instances, anything always visible (or everything if culling is disabled) is created now.
+     */
+    void build();
+
+    /**
+     * Update which cells are active and visible, should be called once a tick.
+     *
+     * @param player_position
+     *   Position of player.
+     *
+     * @param camera
+     *   Camera to test visibility against, nullptr if headless.
+     */
+    void update(const iris::Vector3 &player_position, const iris::Camera *camera);
+
+    /**
+     * Check if a position is active, i.e. near the player or in view of the camera (as of the last update).
+     *
+     * @param position
+     *   Position to check.
+     *
+     * @returns
+     *   True if position is active.
+     */
+    bool is_active(const iris::Vector3 &position) const;
+
+    /**
+     * Record how many objects were updated this tick, for the stats logged by log_stats.
+     *
+     * @param active
+     *   Number of objects updated.
+     *
+     * @param total
+     *   Number of objects that could have been updated.
+     */
+    void record_objects(std::size_t active, std::size_t total);
+
+    /**
+     * Log cell, entity and object counts averaged over all updates.
+     */
+    void log_stats() const;
+
+  private:
+    /**
+     * Internal struct for a plane, points on the positive side are inside the frustum.
+     */
+    struct Plane
+    {
+        /** Normal of plane. */
+        iris::Vector3 normal;
+
+        /** Distance of plane from origin along normal. */
+        float distance;
+    };
+
+    /**
+     * Internal struct for a cell.
+     */
+    struct Cell
+    {
+        /** Static instances, grouped by mesh and material. */
+        std::map<std::tuple<const iris::Mesh *, iris::RenderGraph *>, std::vector<iris::Transform>> instances;
+
+        /** Entities created for instances, empty if cell isn't visible. */
+        std::vector<iris::RenderEntity *> entities;
+
+        /** Lowest point of anything in cell. */
+        float min_y;
+
+        /** Highest point of anything in cell. */
+        float max_y;
+
+        /** Radius of largest instance in cell. */
+        float max_radius;
+
+        /** Last update cell was visible in. */
+        std::uint64_t last_visible;
+    };
+
+    /**
+     * Get the key of the cell containing a position.
+     *
+     * @param position
+     *   Position to get cell of.
+     *
+     * @returns
+     *   Cell key.
+     */
+    std::tuple<std::int32_t, std::int32_t> cell_key(const iris::Vector3 &position) const;
+
+    /**
+     * Check if a cell is within the active radius of the player.
+     *
+     * @param key
+     *   Key of cell to check.
+     *
+     * @returns
+     *   True if cell is near player.
+     */
+    bool is_near_player(const std::tuple<std::int32_t, std::int32_t> &key) const;
+
+    /**
+     * Check if a sphere is inside the camera frustum (as of the last update).
+     *
+     * @param centre
+     *   Centre of sphere.
+     *
+     * @param radius
+     *   Radius of sphere.
+     *
+     * @returns
+     *   True if any part of the sphere may be inside the frustum, always false if there is no camera.
+     */
+    bool in_frustum(const iris::Vector3 &centre, float radius) const;
+
+    /**
+     * Create entities for a set of instances.
+     *
+     * @param instances
+     *   Instances to create entities for.
+     *
+     * @param entities
+     *   Collection to add created entities to.
+     */
+    void create_entities(
+        const std::map<std::tuple<const iris::Mesh *, iris::RenderGraph *>, std::vector<iris::Transform>> &instances,
+        std::vector<iris::RenderEntity *> &entities);
+
+    /** Scene to create entities in. */
+    iris::Scene *scene_;
+
+    /** Width and depth of a cell. */
+    float cell_size_;
+
+    /** Number of cells around the player which are always active. */
+    std::int32_t active_radius_;
+
+    /** Flag indicating if culling is enabled. */
+    bool enabled_;
+
+    /** Cells with static content, keyed on grid coordinates. */
+    std::map<std::tuple<std::int32_t, std::int32_t>, Cell> cells_;
+
+    /** Instances which are always visible. */
+    std::map<std::tuple<const iris::Mesh *, iris::RenderGraph *>, std::vector<iris::Transform>> global_instances_;
+
+    /** Entities created for always visible instances. */
+    std::vector<iris::RenderEntity *> global_entities_;
+
+    /** Radius of each mesh about its origin (unscaled). */
+    std::unordered_map<const iris::Mesh *, float> mesh_radii_;
+
+    /** Cell player was in at the last update. */
+    std::tuple<std::int32_t, std::int32_t> player_cell_;
+
+    /** Camera frustum at the last update: left, right, bottom, top, near, far. */
+    std::array<Plane, 6u> frustum_;
+
+    /** Flag indicating if frustum_ is valid. */
+    bool has_frustum_;
+
+    /** Number of updates. */
+    std::uint64_t updates_;
+
+    /** Sum of visible cells across all updates. */
+    std::uint64_t visible_cells_total_;
+
+    /** Sum of visible entities across all updates. */
+    std::uint64_t visible_entities_total_;
+
+    /** Sum of updated objects across all ticks. */
+    std::uint64_t active_objects_total_;
+
+    /** Sum of objects that could have been updated across all ticks. */
+    std::uint64_t objects_total_;
+
+    /** Number of times a cell had its entities created. */
+    std::uint64_t cells_shown_;
+};
+
+}
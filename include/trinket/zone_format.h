@@ -0,0 +1,314 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+// Layout of cooked (binary) zone files, as written by trinket_zone_cook and read by BinaryZoneLoader.
+//
+// A file is a ZoneFileHeader followed by the sections it describes. Every record is made of 4 byte fields, so sections
+// only need 4 byte alignment and the file can be used in place once mapped into memory. Values are in native byte
+// order, zones should be cooked on the same architecture they are played on.
+//
+// Any change to these records must increment zone_file_version.
+
+namespace trinket
+{
+
+/** Magic number at the start of every zone file ("TZNE"). */
+inline constexpr std::uint32_t zone_file_magic = 0x454e5a54u;
+
+/** Version of the format, files with a different version must be re-cooked. */
+inline constexpr std::uint32_t zone_file_version = 1u;
+
+/** Index used for an absent texture. */
+inline constexpr std::uint32_t zone_no_texture = 0xffffffffu;
+
+/**
+ * Reference to a string in the string section. Strings are not null terminated.
+ */
+struct ZoneString
+{
+    /** Offset into string section. */
+    std::uint32_t offset;
+
+    /** Length in bytes. */
+    std::uint32_t length;
+};
+
+/**
+ * Location of a section in the file.
+ */
+struct ZoneSection
+{
+    /** Offset from start of file. */
+    std::uint32_t offset;
+
+    /** Number of records (bytes for the string section). */
+    std::uint32_t count;
+};
+
+/**
+ * Plain vector, as iris types don't have a guaranteed layout.
+ */
+struct ZoneVector3
+{
+    float x;
+    float y;
+    float z;
+};
+
+/**
+ * Plain quaternion, as iris types don't have a guaranteed layout.
+ */
+struct ZoneQuaternion
+{
+    float x;
+    float y;
+    float z;
+    float w;
+};
+
+/**
+ * Enumeration of mesh sources.
+ */
+enum class ZoneMeshKind : std::uint32_t
+{
+    CUBE,
+    FILE
+};
+
+/**
+ * A mesh used by the zone's static geometry, loading a mesh file may produce several parts.
+ */
+struct ZoneMesh
+{
+    /** Mesh resource name (empty for a cube). */
+    ZoneString name;
+
+    /** Source of mesh. */
+    ZoneMeshKind kind;
+
+    /** Index of first part in part section. */
+    std::uint32_t first_part;
+
+    /** Number of parts. */
+    std::uint32_t part_count;
+};
+
+/**
+ * Precomputed bounding box of a mesh part, in mesh space.
+ */
+struct ZoneMeshPart
+{
+    /** Minimum corner. */
+    ZoneVector3 min;
+
+    /** Maximum corner. */
+    ZoneVector3 max;
+};
+
+/**
+ * Enumeration of samplers a texture can be loaded with.
+ */
+enum class ZoneSampler : std::uint32_t
+{
+    DEFAULT,
+    NEAREST
+};
+
+/**
+ * A texture used by the zone.
+ */
+struct ZoneTexture
+{
+    /** Texture resource name. */
+    ZoneString name;
+
+    /** Sampler to load texture with. */
+    ZoneSampler sampler;
+};
+
+/**
+ * Transform of a single instance of a mesh part.
+ */
+struct ZoneInstance
+{
+    /** World position. */
+    ZoneVector3 position;
+
+    /** Orientation. */
+    ZoneQuaternion orientation;
+
+    /** Scale. */
+    ZoneVector3 scale;
+};
+
+/**
+ * All instances of a mesh part which share a material, rendered as a single entity.
+ */
+struct ZoneInstanceGroup
+{
+    /** Index into mesh section. */
+    std::uint32_t mesh;
+
+    /** Part of mesh. */
+    std::uint32_t part;
+
+    /** Index into texture section of colour texture, zone_no_texture if untextured. */
+    std::uint32_t texture;
+
+    /** Index into texture section of normal texture, zone_no_texture if none. */
+    std::uint32_t normal;
+
+    /** UV scale of colour texture, 0 if unscaled. */
+    float texture_scale;
+
+    /** Index of first instance in instance section. */
+    std::uint32_t first_instance;
+
+    /** Number of instances. */
+    std::uint32_t instance_count;
+};
+
+/**
+ * Enumeration of collision shapes for static bodies.
+ */
+enum class ZoneShape : std::uint32_t
+{
+    BOX,
+    MESH
+};
+
+/**
+ * A static rigid body.
+ */
+struct ZoneBody
+{
+    /** Name of body. */
+    ZoneString name;
+
+    /** Collision shape. */
+    ZoneShape shape;
+
+    /** Index into mesh section (for MESH shapes). */
+    std::uint32_t mesh;
+
+    /** Part of mesh (for MESH shapes). */
+    std::uint32_t part;
+
+    /** World position. */
+    ZoneVector3 position;
+
+    /** Orientation. */
+    ZoneQuaternion orientation;
+
+    /** Scale (for MESH shapes). */
+    ZoneVector3 scale;
+
+    /** Half extents, already scaled (for BOX shapes). */
+    ZoneVector3 half_extents;
+};
+
+/**
+ * An enemy spawn.
+ */
+struct ZoneEnemy
+{
+    /** World position. */
+    ZoneVector3 position;
+
+    /** Orientation. */
+    ZoneQuaternion orientation;
+
+    /** Scale. */
+    ZoneVector3 scale;
+
+    /** Minimum corner of area enemy can roam. */
+    ZoneVector3 bounds_min;
+
+    /** Maximum corner of area enemy can roam. */
+    ZoneVector3 bounds_max;
+
+    /** Mesh resource name, not in the mesh section as skinned meshes are loaded per enemy. */
+    ZoneString mesh;
+
+    /** Index into texture section. */
+    std::uint32_t texture;
+
+    /** Script resource name. */
+    ZoneString script;
+};
+
+/**
+ * Header at the start of every zone file.
+ */
+struct ZoneFileHeader
+{
+    /** Must be zone_file_magic. */
+    std::uint32_t magic;
+
+    /** Must be zone_file_version. */
+    std::uint32_t version;
+
+    /** Size of the whole file in bytes. */
+    std::uint32_t file_size;
+
+    /** Zone name. */
+    ZoneString name;
+
+    /** Player start position. */
+    ZoneVector3 player_start_position;
+
+    /** Portal position. */
+    ZoneVector3 portal_position;
+
+    /** Portal scale. */
+    ZoneVector3 portal_scale;
+
+    /** Name of zone portal leads to. */
+    ZoneString portal_destination;
+
+    /** ZoneMesh records. */
+    ZoneSection meshes;
+
+    /** ZoneMeshPart records. */
+    ZoneSection parts;
+
+    /** ZoneTexture records. */
+    ZoneSection textures;
+
+    /** ZoneInstanceGroup records. */
+    ZoneSection instance_groups;
+
+    /** ZoneInstance records. */
+    ZoneSection instances;
+
+    /** ZoneBody records. */
+    ZoneSection bodies;
+
+    /** ZoneEnemy records. */
+    ZoneSection enemies;
+
+    /** ZoneString records, for all resource files used by the zone. */
+    ZoneSection resource_files;
+
+    /** String data. */
+    ZoneSection strings;
+};
+
+static_assert(std::is_trivially_copyable_v<ZoneFileHeader> && (alignof(ZoneFileHeader) == 4u));
+static_assert(std::is_trivially_copyable_v<ZoneMesh> && (alignof(ZoneMesh) == 4u));
+static_assert(std::is_trivially_copyable_v<ZoneMeshPart> && (alignof(ZoneMeshPart) == 4u));
+static_assert(std::is_trivially_copyable_v<ZoneTexture> && (alignof(ZoneTexture) == 4u));
+static_assert(std::is_trivially_copyable_v<ZoneInstance> && (alignof(ZoneInstance) == 4u));
+static_assert(std::is_trivially_copyable_v<ZoneInstanceGroup> && (alignof(ZoneInstanceGroup) == 4u));
+static_assert(std::is_trivially_copyable_v<ZoneBody> && (alignof(ZoneBody) == 4u));
+static_assert(std::is_trivially_copyable_v<ZoneEnemy> && (alignof(ZoneEnemy) == 4u));
+
+}
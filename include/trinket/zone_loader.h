@@ -17,8 +17,12 @@
 #include "iris/physics/physics_system.h"
 
 #include "game_object.h"
+#include "job_system.h"
+#include "nav_grid.h"
 #include "player.h"
+#include "script_pool.h"
 #include "third_person_camera.h"
+#include "zone_cells.h"
 
 namespace trinket
 {
@@ -54,15 +58,27 @@ class ZoneLoader
      *   Physics system.
      *
      * @param scene
-     *   Scene to load into.
+     *   Scene to load into, nullptr if headless (only physics data will be loaded).
      *
      * @param render_pipeline
-     *   Render pipeline to use.
+     *   Render pipeline to use, nullptr if headless.
+     *
+     * @param cells
+     *   Cells to add static instances to, they create the render entities.
+     *
+     * @param nav
+     *   Navigation grid to add static bodies to.
+     *
+     * @param jobs
+     *   Job system for stages of loading which can run in parallel.
      */
     virtual void load_static_geometry(
         iris::PhysicsSystem *ps,
         iris::Scene *scene,
-        iris::RenderPipeline &render_pipeline) = 0;
+        iris::RenderPipeline *render_pipeline,
+        ZoneCells &cells,
+        NavGrid &nav,
+        JobSystem &jobs) = 0;
 
     /**
      * Load enemies.
@@ -71,10 +87,10 @@ class ZoneLoader
      *   Physics system.
      *
      * @param scene
-     *   Scene to load into.
+     *   Scene to load into, nullptr if headless (only physics data will be loaded).
      *
      * @param render_pipeline
-     *   Render pipeline to use.
+     *   Render pipeline to use, nullptr if headless.
      *
      * @param game_objects
      *   Collection of game objects to add enemies to.
@@ -83,15 +99,27 @@ class ZoneLoader
      *   Pointer to player object.
      *
      * @param camera
-     *   Pointer to camera object,
+     *   Pointer to camera object, nullptr if headless.
+     *
+     * @param nav
+     *   Navigation grid enemies steer towards the player with.
+     *
+     * @param scripts
+     *   Pool to load and create enemy scripts from.
+     *
+     * @param jobs
+     *   Job system for stages of loading which can run in parallel.
      */
     virtual void load_enemies(
         iris::PhysicsSystem *ps,
         iris::Scene *scene,
-        iris::RenderPipeline &render_pipeline,
+        iris::RenderPipeline *render_pipeline,
         std::vector<std::unique_ptr<GameObject>> &game_objects,
         Player *player,
-        ThirdPersonCamera *camera) = 0;
+        ThirdPersonCamera *camera,
+        const NavGrid &nav,
+        ScriptPool &scripts,
+        JobSystem &jobs) = 0;
 
     /**
      * Get portal data.
@@ -100,6 +128,32 @@ class ZoneLoader
      *   Tuple of portal transform and name of next zone.
      */
     virtual std::tuple<iris::Transform, std::string> portal() = 0;
+
+    /**
+     * Get all resource files used by the zone, so they can be read ahead of the zone being loaded. This only parses
+     * zone data so is cheap to call.
+     *
+     * @returns
+     *   Collection of resource files (relative to resource root).
+     */
+    virtual std::vector<std::string> resource_files() = 0;
+
+    /**
+     * Start preloading the zone from its first step, must be called before preload_step. A zone can be preloaded any
+     * number of times, as the assets an earlier preload warmed may since have been evicted.
+     */
+    virtual void begin_preload() = 0;
+
+    /**
+     * Perform the next step of preloading the zone, this warms engine caches (e.g. decoding and uploading a mesh) so
+     * they are hits when the zone is actually loaded. Each step is small enough to be run during a frame.
+     *
+     * Must be called from the main thread.
+     *
+     * @returns
+     *   True if there are more steps to perform, false if preloading is complete.
+     */
+    virtual bool preload_step() = 0;
 };
 
 }
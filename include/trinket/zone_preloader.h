@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "job_system.h"
+#include "zone_loader.h"
+
+namespace trinket
+{
+
+/**
+ * Class for preloading a zone whilst another one is being played, so that the transition between them doesn't have to
+ * wait on the disk or decode assets.
+ *
+ * Preloading happens in two stages:
+ *   1. A background thread reads all the zone's resource files, so they are in the OS file cache.
+ *   2. Once they have been read, update (called once a frame) performs the zone's preload steps within a time budget.
+ *      These warm the engine caches and have to happen on the main thread, as the engine isn't thread safe.
+ */
+class ZonePreloader
+{
+  public:
+    /**
+     * Construct a new ZonePreloader.
+     *
+     * @param resource_root
+     *   Directory resource files are relative to.
+     */
+    explicit ZonePreloader(const std::filesystem::path &resource_root);
+
+    /**
+     * Stops and joins background thread.
+     */
+    ~ZonePreloader();
+
+    ZonePreloader(const ZonePreloader &) = delete;
+    ZonePreloader &operator=(const ZonePreloader &) = delete;
+
+    /**
+     * Start preloading a zone, this abandons any preload already in progress.
+     *
+     * @param zone
+     *   Zone to preload.
+     */
+    void preload(ZoneLoader *zone);
+
+    /**
+     * Progress the current preload, should be called once a frame.
+     *
+     * @param budget
+     *   Time to spend preloading, at least one step is performed if there is work to do.
+     */
+    void update(std::chrono::microseconds budget);
+
+    /**
+     * Read all of a zone's resource files now, spread across a job system. Used when a zone is loaded without having
+     * been preloaded, so the disk reads aren't serialised behind the engine loading each asset. Blocks until all files
+     * have been read.
+     *
+     * @param zone
+     *   Zone to read files of.
+     *
+     * @param jobs
+     *   Job system to read files with.
+     */
+    void read_now(ZoneLoader *zone, JobSystem &jobs);
+
+    /**
+     * Check if a zone has been fully preloaded.
+     *
+     * @param zone
+     *   Zone to check.
+     *
+     * @returns
+     *   True if zone was the last zone passed to preload and all preloading has completed.
+     */
+    bool is_preloaded(const ZoneLoader *zone) const;
+
+  private:
+    /**
+     * Main loop of background thread.
+     */
+    void read_loop();
+
+    /** Directory resource files are relative to. */
+    std::filesystem::path resource_root_;
+
+    /** Zone being preloaded. */
+    ZoneLoader *zone_;
+
+    /** Flag indicating if all preload steps have been performed. */
+    bool warmed_;
+
+    /** Time preload started. */
+    std::chrono::steady_clock::time_point start_;
+
+    /** Number of frames spent performing preload steps. */
+    std::uint32_t frames_;
+
+    /** Lock for state shared with background thread. */
+    mutable std::mutex mutex_;
+
+    /** Used to wake background thread. */
+    std::condition_variable wake_;
+
+    /** Files for background thread to read. */
+    std::vector<std::string> pending_files_;
+
+    /** Incremented for each preload, so the background thread can tell when its work is stale. */
+    std::uint64_t generation_;
+
+    /** Flag indicating if all files for current preload have been read. */
+    bool files_read_;
+
+    /** Number of bytes read for current preload. */
+    std::uint64_t bytes_read_;
+
+    /** Time background thread finished reading files. */
+    std::chrono::steady_clock::time_point read_end_;
+
+    /** Flag indicating background thread should exit. */
+    bool stop_;
+
+    /** Background thread. */
+    std::thread thread_;
+};
+
+}
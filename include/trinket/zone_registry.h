@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "zone_loader.h"
+
+namespace trinket
+{
+
+/**
+ * Class for looking up zones by name. Zones are indexed from a manifest of names to files, and a zone's file is only
+ * read and parsed the first time it is looked up (i.e. when it is loaded or preloaded), so startup doesn't pay for
+ * zones which may never be visited.
+ */
+class ZoneRegistry
+{
+  public:
+    /**
+     * Construct a new ZoneRegistry.
+     *
+     * @param resource_root
+     *   Directory zone files are relative to.
+     *
+     * @param zone_files
+     *   Map of zone names to zone files, files ending in .zone are cooked zones all others are YAML.
+     *
+     * @param merge_static_bodies
+     *   True if zones should merge touching static boxes into single bodies.
+     */
+    ZoneRegistry(
+        const std::filesystem::path &resource_root,
+        const std::map<std::string, std::string> &zone_files,
+        bool merge_static_bodies);
+
+    /**
+     * Get a zone, creating its loader if this is the first time it has been requested.
+     *
+     * @param name
+     *   Name of zone.
+     *
+     * @returns
+     *   Loader for zone.
+     */
+    ZoneLoader *zone(const std::string &name);
+
+    /**
+     * Get the number of zones in the registry.
+     *
+     * @returns
+     *   Number of zones.
+     */
+    std::size_t size() const;
+
+  private:
+    /**
+     * Internal struct for a registered zone.
+     */
+    struct Entry
+    {
+        /** Zone file. */
+        std::string file;
+
+        /** Loader, nullptr until zone is first requested. */
+        std::unique_ptr<ZoneLoader> loader;
+    };
+
+    /** Directory zone files are relative to. */
+    std::filesystem::path resource_root_;
+
+    /** Flag indicating if zones should merge touching static boxes. */
+    bool merge_static_bodies_;
+
+    /** Registered zones, keyed on name. */
+    std::unordered_map<std::string, Entry> zones_;
+};
+
+}
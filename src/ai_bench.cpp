@@ -0,0 +1,298 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+// Offline tool which measures the cost of running enemy AI scripts.
+//
+// usage: trinket_ai_bench <resource root> [script]
+//
+// For each enemy count the enemies are run by the script (all sharing a single compiled copy, as in game, see
+// ScriptPool) and then by the native AI (see NativeAi), and ticked a fixed number of times whilst the player walks in a
+// circle through them. The time taken to spawn the enemies, the lua memory each one uses and the average cost of a
+// single enemy tick are printed, all of which should stay flat as the number of enemies grows.
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "iris/core/resource_loader.h"
+#include "iris/core/start.h"
+#include "iris/core/vector3.h"
+#include "iris/scripting/lua/lua_script.h"
+#include "iris/scripting/script_runner.h"
+
+#include "enemy_ai.h"
+#include "enemy_decision.h"
+#include "native_ai.h"
+#include "nav_grid.h"
+
+namespace
+{
+
+/** Enemy counts to measure. */
+constexpr std::array<std::size_t, 3u> enemy_counts{10u, 100u, 1000u};
+
+/** Number of ticks to run for each count, ten seconds at 60Hz. */
+constexpr std::uint32_t tick_count = 600u;
+
+/** Simulated time between ticks. */
+constexpr std::chrono::microseconds tick_delta{16667};
+
+/** Half the width of the area enemies roam in. */
+constexpr float half_extent = 20.0f;
+
+/** Distance enemies walk each tick. */
+constexpr float walk_speed = 0.1f;
+
+/** Appended to the script under test so the bench can query how much memory lua is using. */
+constexpr auto memory_function = "\nfunction bench_memory_kb() collectgarbage() return collectgarbage('count') end\n";
+
+/**
+ * Internal struct for the results of a run.
+ */
+struct Result
+{
+    /** Time taken to init all enemies. */
+    std::chrono::steady_clock::duration spawn;
+
+    /** Lua memory used by each enemy in bytes, empty if not running a script. */
+    std::optional<double> memory_per_enemy;
+
+    /** Time taken to run all ticks. */
+    std::chrono::steady_clock::duration ticks;
+};
+
+/**
+ * Get how much memory a lua state is using.
+ *
+ * @param script
+ *   Script to query.
+ *
+ * @returns
+ *   Memory in bytes, after a full collection.
+ */
+double lua_memory(iris::ScriptRunner &script)
+{
+    return static_cast<double>(script.execute<float>("bench_memory_kb")) * 1024.0;
+}
+
+/**
+ * Get start positions for enemies, spread over the area on a grid.
+ *
+ * @param count
+ *   Number of enemies.
+ *
+ * @returns
+ *   Start positions.
+ */
+std::vector<iris::Vector3> start_positions(std::size_t count)
+{
+    std::vector<iris::Vector3> positions{};
+
+    const auto side = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<float>(count))));
+    const auto step = (half_extent * 2.0f) / static_cast<float>(side);
+
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        positions.emplace_back(
+            -half_extent + (static_cast<float>(i % side) + 0.5f) * step,
+            0.0f,
+            -half_extent + (static_cast<float>(i / side) + 0.5f) * step);
+    }
+
+    return positions;
+}
+
+/**
+ * Get the position of the player, walking in a circle.
+ *
+ * @param tick
+ *   Tick to get position at.
+ *
+ * @returns
+ *   Player position.
+ */
+iris::Vector3 player_position(std::uint32_t tick)
+{
+    const auto angle = static_cast<float>(tick) * 0.01f;
+    return {std::cos(angle) * half_extent * 0.5f, 0.0f, std::sin(angle) * half_extent * 0.5f};
+}
+
+/**
+ * Spawn enemies driven by a script and run them for a fixed number of ticks.
+ *
+ * @param source
+ *   Source of script to run.
+ *
+ * @param count
+ *   Number of enemies.
+ *
+ * @returns
+ *   Results of run.
+ */
+Result run_script(const std::string &source, std::size_t count)
+{
+    const iris::Vector3 bounds_min{-half_extent, 0.0f, -half_extent};
+    const iris::Vector3 bounds_max{half_extent, 0.0f, half_extent};
+
+    // the area is open, so steering is always straight at the player
+    const trinket::NavGrid nav{1.0f, 0.0f, false};
+
+    iris::ScriptRunner script{std::make_unique<iris::LuaScript>(source + memory_function)};
+    auto positions = start_positions(count);
+
+    const auto memory_before = lua_memory(script);
+    const auto spawn_start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        script.execute("init", static_cast<std::int32_t>(i), bounds_min, bounds_max);
+    }
+
+    const auto spawn_end = std::chrono::steady_clock::now();
+    const auto memory_after = lua_memory(script);
+    const auto tick_start = std::chrono::steady_clock::now();
+
+    for (std::uint32_t tick = 0u; tick < tick_count; ++tick)
+    {
+        const auto elapsed = tick_delta * tick;
+        const auto player = player_position(tick);
+
+        for (std::size_t i = 0u; i < count; ++i)
+        {
+            const auto decision = trinket::tick_script(
+                script,
+                static_cast<std::int32_t>(i),
+                positions[i],
+                player,
+                nav.direction(positions[i], player),
+                elapsed,
+                100.0f);
+            positions[i] += decision.walk_direction * walk_speed;
+        }
+    }
+
+    return {
+        .spawn = spawn_end - spawn_start,
+        .memory_per_enemy = (memory_after - memory_before) / static_cast<double>(count),
+        .ticks = std::chrono::steady_clock::now() - tick_start};
+}
+
+/**
+ * Spawn enemies driven by native AI and run them for a fixed number of ticks.
+ *
+ * @param count
+ *   Number of enemies.
+ *
+ * @returns
+ *   Results of run.
+ */
+Result run_native(std::size_t count)
+{
+    const iris::Vector3 bounds_min{-half_extent, 0.0f, -half_extent};
+    const iris::Vector3 bounds_max{half_extent, 0.0f, half_extent};
+
+    const trinket::NavGrid nav{1.0f, 0.0f, false};
+
+    trinket::NativeAi native_ai{};
+    std::vector<std::unique_ptr<trinket::EnemyAi>> ais{};
+    auto positions = start_positions(count);
+
+    const auto spawn_start = std::chrono::steady_clock::now();
+
+    for (const auto &position : positions)
+    {
+        ais.emplace_back(native_ai.create("native:basic", position, bounds_min, bounds_max));
+    }
+
+    const auto spawn_end = std::chrono::steady_clock::now();
+
+    for (std::uint32_t tick = 0u; tick < tick_count; ++tick)
+    {
+        const auto elapsed = tick_delta * tick;
+        const auto player = player_position(tick);
+
+        native_ai.update(player, nav, elapsed);
+
+        for (std::size_t i = 0u; i < count; ++i)
+        {
+            const auto decision =
+                ais[i]->tick(positions[i], player, nav.direction(positions[i], player), elapsed, 100.0f);
+            positions[i] += decision.walk_direction * walk_speed;
+            ais[i]->moved(positions[i]);
+        }
+    }
+
+    return {
+        .spawn = spawn_end - spawn_start,
+        .memory_per_enemy = std::nullopt,
+        .ticks = std::chrono::steady_clock::now() - spawn_end};
+}
+
+/**
+ * Print the results of a run.
+ *
+ * @param name
+ *   Name of AI.
+ *
+ * @param count
+ *   Number of enemies.
+ *
+ * @param result
+ *   Results of run.
+ */
+void print(const std::string &name, std::size_t count, const Result &result)
+{
+    const auto ticks = static_cast<double>(count) * static_cast<double>(tick_count);
+
+    std::cout << name << " " << count << " enemies: spawned in "
+              << std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(result.spawn).count() << "ms, ";
+
+    if (result.memory_per_enemy)
+    {
+        std::cout << *result.memory_per_enemy << " bytes per enemy, ";
+    }
+
+    std::cout << std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(result.ticks).count()
+              << "ms for " << tick_count << " ticks, "
+              << std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(result.ticks).count() / ticks
+              << "us per enemy tick" << std::endl;
+}
+
+void bench(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: trinket_ai_bench <resource root> [script]" << std::endl;
+        return;
+    }
+
+    iris::ResourceLoader::instance().set_root_directory(argv[1]);
+
+    const std::string script_file = (argc > 2) ? argv[2] : "basic_enemy.lua";
+    const auto script_data = iris::ResourceLoader::instance().load(script_file);
+    const std::string source(reinterpret_cast<const char *>(script_data.data()), script_data.size());
+
+    for (const auto count : enemy_counts)
+    {
+        print(script_file, count, run_script(source, count));
+        print("native:basic", count, run_native(count));
+    }
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    iris::start(argc, argv, bench);
+    return 0;
+}
@@ -0,0 +1,231 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "ai_scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "iris/core/vector3.h"
+#include "iris/log/log.h"
+
+#include "game_object.h"
+#include "profiler.h"
+#include "update_phase.h"
+
+namespace
+{
+
+/** Weight of the previous average when a new update cost is recorded, out of cost_smoothing + 1. */
+constexpr std::int64_t cost_smoothing = 7;
+
+}
+
+namespace trinket
+{
+
+AiScheduler::AiScheduler(
+    float near_distance,
+    float far_distance,
+    std::uint32_t mid_interval,
+    std::chrono::microseconds far_budget,
+    bool enabled)
+    : near_distance_sq_(near_distance * near_distance)
+    , far_distance_sq_(far_distance * far_distance)
+    , mid_interval_(std::max(mid_interval, 1u))
+    , far_budget_(far_budget)
+    , enabled_(enabled)
+    , bands_()
+    , slots_()
+    , next_slot_(0u)
+    , update_cost_(0)
+    , far_cursor_(0u)
+    , ticks_(0u)
+    , last_tick_()
+    , peak_updated_(0u)
+    , near_total_(0u)
+    , mid_total_(0u)
+    , mid_candidates_total_(0u)
+    , far_total_(0u)
+    , far_candidates_total_(0u)
+{
+}
+
+void AiScheduler::schedule(std::vector<GameObject *> &objects, const iris::Vector3 &player_position)
+{
+    if (!enabled_)
+    {
+        return;
+    }
+
+    TRINKET_PROFILE_SCOPE("ai_schedule");
+
+    // classify every enemy first, the far round robin needs to know how many there are
+    bands_.resize(objects.size());
+    std::size_t mid_count = 0u;
+    std::size_t far_count = 0u;
+
+    for (std::size_t i = 0u; i < objects.size(); ++i)
+    {
+        const auto *object = objects[i];
+        const auto position = object->cull_position();
+
+        if ((object->update_phase() != UpdatePhase::AI) || !position)
+        {
+            bands_[i] = Band::UNSCHEDULED;
+            continue;
+        }
+
+        const auto offset = *position - player_position;
+        const auto distance_sq = offset.dot(offset);
+
+        if (distance_sq <= near_distance_sq_)
+        {
+            bands_[i] = Band::NEAR;
+        }
+        else if (distance_sq <= far_distance_sq_)
+        {
+            bands_[i] = Band::MID;
+            ++mid_count;
+        }
+        else
+        {
+            bands_[i] = Band::FAR;
+            ++far_count;
+        }
+    }
+
+    // until an update has been timed there's nothing to budget with, so update all far enemies
+    auto far_allowance = far_count;
+    if (update_cost_.count() > 0)
+    {
+        const auto affordable = static_cast<std::size_t>(far_budget_ / update_cost_);
+        far_allowance = std::min(std::max(affordable, std::size_t{1u}), far_count);
+    }
+
+    if (far_count != 0u)
+    {
+        far_cursor_ %= far_count;
+    }
+
+    // compact the objects due this tick in place, a mid enemy is due every mid_interval_ ticks (offset by its slot so
+    // the same share of them is updated each tick) and far enemies are due if they're within the allowance after the
+    // round robin cursor
+    std::size_t far_index = 0u;
+    std::size_t near_updated = 0u;
+    std::size_t mid_updated = 0u;
+    std::size_t far_updated = 0u;
+    std::size_t write = 0u;
+
+    for (std::size_t i = 0u; i < objects.size(); ++i)
+    {
+        auto due = true;
+
+        if (bands_[i] == Band::NEAR)
+        {
+            ++near_updated;
+        }
+        else if (bands_[i] == Band::MID)
+        {
+            // slots are fixed for the life of an enemy, so it's due exactly every mid_interval_ ticks however many
+            // other enemies enter or leave the band
+            auto [slot, inserted] = slots_.try_emplace(objects[i], 0u);
+            if (inserted)
+            {
+                slot->second = next_slot_;
+                next_slot_ = (next_slot_ + 1u) % mid_interval_;
+            }
+
+            due = ((ticks_ + slot->second) % mid_interval_) == 0u;
+            mid_updated += due ? 1u : 0u;
+        }
+        else if (bands_[i] == Band::FAR)
+        {
+            due = ((far_index++ + far_count - far_cursor_) % far_count) < far_allowance;
+            far_updated += due ? 1u : 0u;
+        }
+
+        if (due)
+        {
+            objects[write++] = objects[i];
+        }
+    }
+
+    objects.resize(write);
+
+    if (far_count != 0u)
+    {
+        far_cursor_ = (far_cursor_ + far_updated) % far_count;
+    }
+
+    last_tick_ = {
+        .near = near_updated,
+        .mid = mid_updated,
+        .mid_candidates = mid_count,
+        .far = far_updated,
+        .far_candidates = far_count};
+    peak_updated_ = std::max(peak_updated_, near_updated + mid_updated + far_updated);
+
+    TRINKET_PROFILE_COUNTER("ai_near", static_cast<std::int64_t>(near_updated));
+    TRINKET_PROFILE_COUNTER("ai_mid", static_cast<std::int64_t>(mid_updated));
+    TRINKET_PROFILE_COUNTER("ai_far", static_cast<std::int64_t>(far_updated));
+
+    ++ticks_;
+    near_total_ += near_updated;
+    mid_total_ += mid_updated;
+    mid_candidates_total_ += mid_count;
+    far_total_ += far_updated;
+    far_candidates_total_ += far_count;
+}
+
+void AiScheduler::record_update_time(std::chrono::nanoseconds duration, std::size_t count)
+{
+    if (!enabled_ || (count == 0u))
+    {
+        return;
+    }
+
+    const auto cost = duration / static_cast<std::int64_t>(count);
+
+    // smooth the cost so a single slow tick doesn't starve the far enemies
+    update_cost_ =
+        (update_cost_.count() == 0) ? cost : ((update_cost_ * cost_smoothing) + cost) / (cost_smoothing + 1);
+}
+
+const AiScheduler::TickCounts &AiScheduler::last_tick() const
+{
+    return last_tick_;
+}
+
+void AiScheduler::log_stats() const
+{
+    if (!enabled_ || (ticks_ == 0u))
+    {
+        return;
+    }
+
+    const auto average = [this](std::uint64_t total) {
+        return static_cast<double>(total) / static_cast<double>(ticks_);
+    };
+
+    LOG_INFO(
+        "zone",
+        "ai: {:.1f} near, {:.1f}/{:.1f} mid, {:.1f}/{:.1f} far updated (averages), {} most in a tick, {:.1f}us per "
+        "update",
+        average(near_total_),
+        average(mid_total_),
+        average(mid_candidates_total_),
+        average(far_total_),
+        average(far_candidates_total_),
+        peak_updated_,
+        std::chrono::duration<double, std::micro>(update_cost_).count());
+}
+
+}
@@ -0,0 +1,254 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "asset_cache.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+#include "iris/core/colour.h"
+#include "iris/core/root.h"
+#include "iris/graphics/cube_map.h"
+#include "iris/graphics/mesh_manager.h"
+#include "iris/graphics/texture_manager.h"
+#include "iris/graphics/vertex_data.h"
+#include "iris/log/log.h"
+
+namespace
+{
+
+/** Estimated bytes per texel of a loaded texture. */
+constexpr std::size_t bytes_per_texel = 4u;
+
+/**
+ * Get a human readable name for an asset kind.
+ *
+ * @param kind
+ *   Kind to get name of.
+ *
+ * @returns
+ *   Name of kind.
+ */
+std::string_view to_string(trinket::AssetKind kind)
+{
+    switch (kind)
+    {
+        case trinket::AssetKind::MESH: return "mesh";
+        case trinket::AssetKind::TEXTURE: return "texture";
+        case trinket::AssetKind::SKY_BOX: return "sky_box";
+    }
+
+    return "unknown";
+}
+
+}
+
+namespace trinket
+{
+
+AssetCache::AssetCache()
+    : entries_()
+    , lru_()
+    , stats_()
+    , bytes_(0u)
+    , budget_(0u)
+{
+}
+
+AssetCache &AssetCache::instance()
+{
+    static AssetCache instance{};
+    return instance;
+}
+
+void AssetCache::set_budget(std::size_t bytes)
+{
+    budget_ = bytes;
+}
+
+iris::MeshLoadData AssetCache::mesh(const std::string &name)
+{
+    const auto key = "mesh:" + name;
+
+    if (const auto *entry = find(key, AssetKind::MESH); entry != nullptr)
+    {
+        return std::get<iris::MeshLoadData>(entry->asset);
+    }
+
+    auto mesh_data = iris::Root::mesh_manager().load_mesh(name);
+
+    // sharing a skeleton would make every instance play the same animation, so only static meshes are cached
+    if (mesh_data.skeleton != nullptr)
+    {
+        ++stats_[static_cast<std::size_t>(AssetKind::MESH)].misses;
+        return mesh_data;
+    }
+
+    std::size_t bytes = 0u;
+    for (const auto &part : mesh_data.mesh_data)
+    {
+        bytes += part.mesh->vertices().size() * sizeof(iris::VertexData);
+        bytes += part.mesh->indices().size() * sizeof(std::uint32_t);
+    }
+
+    return std::get<iris::MeshLoadData>(insert(key, AssetKind::MESH, std::move(mesh_data), bytes).asset);
+}
+
+const iris::Texture *AssetCache::texture(const std::string &name, const iris::Sampler *sampler)
+{
+    // the sampler is part of the texture, so the same file loaded with different samplers is a different asset
+    std::stringstream strm{};
+    strm << "texture:" << name << ":" << static_cast<const void *>(sampler);
+    const auto key = strm.str();
+
+    if (const auto *entry = find(key, AssetKind::TEXTURE); entry != nullptr)
+    {
+        return std::get<const iris::Texture *>(entry->asset);
+    }
+
+    const auto *texture = iris::Root::texture_manager().load(name, iris::TextureUsage::IMAGE, sampler);
+    const auto bytes = static_cast<std::size_t>(texture->width()) * texture->height() * bytes_per_texel;
+
+    return std::get<const iris::Texture *>(insert(key, AssetKind::TEXTURE, texture, bytes).asset);
+}
+
+const iris::CubeMap *AssetCache::sky_box(
+    const iris::Colour &top,
+    const iris::Colour &bottom,
+    std::uint32_t width,
+    std::uint32_t height)
+{
+    std::stringstream strm{};
+    strm << "sky_box:" << top.r << "," << top.g << "," << top.b << "," << top.a << ":" << bottom.r << "," << bottom.g
+         << "," << bottom.b << "," << bottom.a << ":" << width << "x" << height;
+    const auto key = strm.str();
+
+    if (const auto *entry = find(key, AssetKind::SKY_BOX); entry != nullptr)
+    {
+        return std::get<const iris::CubeMap *>(entry->asset);
+    }
+
+    const auto *sky_box = iris::Root::texture_manager().create(top, bottom, width, height);
+    const auto bytes = static_cast<std::size_t>(width) * height * bytes_per_texel * 6u;
+
+    return std::get<const iris::CubeMap *>(insert(key, AssetKind::SKY_BOX, sky_box, bytes).asset);
+}
+
+void AssetCache::end_zone()
+{
+    for (auto &[key, entry] : entries_)
+    {
+        entry.references = 0u;
+    }
+
+    evict();
+    log_stats();
+}
+
+void AssetCache::evict()
+{
+    auto &texture_manager = iris::Root::texture_manager();
+
+    // walk from least to most recently used, skipping anything the current zone is using
+    auto key = std::rbegin(lru_);
+    while ((bytes_ > budget_) && (key != std::rend(lru_)))
+    {
+        const auto entry = entries_.find(*key);
+        if (entry->second.references != 0u)
+        {
+            ++key;
+            continue;
+        }
+
+        // meshes have no way to be unloaded, dropping them from the cache still stops them being kept alive by us
+        if (const auto *texture = std::get_if<const iris::Texture *>(&entry->second.asset); texture != nullptr)
+        {
+            texture_manager.unload(*texture);
+        }
+        else if (const auto *sky_box = std::get_if<const iris::CubeMap *>(&entry->second.asset); sky_box != nullptr)
+        {
+            texture_manager.unload(*sky_box);
+        }
+
+        ++stats_[static_cast<std::size_t>(entry->second.kind)].evictions;
+        bytes_ -= entry->second.bytes;
+
+        // erase returns the element after the erased one, which is the next one to visit in reverse
+        key = std::make_reverse_iterator(lru_.erase(std::next(key).base()));
+        entries_.erase(entry);
+    }
+}
+
+void AssetCache::log_stats() const
+{
+    for (std::size_t i = 0u; i < stats_.size(); ++i)
+    {
+        const auto &[hits, misses, evictions] = stats_[i];
+
+        LOG_INFO(
+            "assets",
+            "{}: {} hits, {} misses, {} evictions",
+            to_string(static_cast<AssetKind>(i)),
+            hits,
+            misses,
+            evictions);
+    }
+
+    LOG_INFO("assets", "{} assets cached, {}/{} bytes", entries_.size(), bytes_, budget_);
+}
+
+AssetCache::Entry *AssetCache::find(const std::string &key, AssetKind kind)
+{
+    auto entry = entries_.find(key);
+    if (entry == std::end(entries_))
+    {
+        return nullptr;
+    }
+
+    ++stats_[static_cast<std::size_t>(kind)].hits;
+    ++entry->second.references;
+
+    // move to most recently used
+    lru_.splice(std::begin(lru_), lru_, entry->second.lru_position);
+
+    return &entry->second;
+}
+
+AssetCache::Entry &AssetCache::insert(
+    const std::string &key,
+    AssetKind kind,
+    std::variant<iris::MeshLoadData, const iris::Texture *, const iris::CubeMap *> asset,
+    std::size_t bytes)
+{
+    ++stats_[static_cast<std::size_t>(kind)].misses;
+    bytes_ += bytes;
+
+    lru_.emplace_front(key);
+
+    const auto entry = entries_
+                           .try_emplace(
+                               key,
+                               Entry{
+                                   .asset = std::move(asset),
+                                   .kind = kind,
+                                   .bytes = bytes,
+                                   .references = 1u,
+                                   .lru_position = std::begin(lru_)})
+                           .first;
+
+    // make room for the new asset, it's referenced so can't evict itself
+    evict();
+
+    return entry->second;
+}
+
+}
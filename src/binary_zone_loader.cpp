@@ -0,0 +1,584 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "binary_zone_loader.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "iris/core/error_handling.h"
+#include "iris/core/quaternion.h"
+#include "iris/core/resource_loader.h"
+#include "iris/core/root.h"
+#include "iris/core/transform.h"
+#include "iris/core/vector3.h"
+#include "iris/graphics/mesh_manager.h"
+#include "iris/graphics/render_graph/render_graph.h"
+#include "iris/graphics/render_graph/texture_node.h"
+#include "iris/graphics/scene.h"
+#include "iris/graphics/single_entity.h"
+#include "iris/graphics/texture_manager.h"
+#include "iris/log/log.h"
+#include "iris/physics/physics_system.h"
+
+#include "asset_cache.h"
+#include "enemy.h"
+#include "game_object.h"
+#include "job_system.h"
+#include "material_cache.h"
+#include "native_ai.h"
+#include "native_ai_updater.h"
+#include "nav_grid.h"
+#include "player.h"
+#include "script_pool.h"
+#include "stage_timer.h"
+#include "static_body_builder.h"
+#include "third_person_camera.h"
+#include "zone_cells.h"
+#include "zone_format.h"
+
+namespace
+{
+
+iris::Vector3 to_vector3(const trinket::ZoneVector3 &vector)
+{
+    return {vector.x, vector.y, vector.z};
+}
+
+iris::Quaternion to_quaternion(const trinket::ZoneQuaternion &quaternion)
+{
+    return {quaternion.x, quaternion.y, quaternion.z, quaternion.w};
+}
+
+/**
+ * Check a section lies within the file.
+ *
+ * @param section
+ *   Section to check.
+ *
+ * @param record_size
+ *   Size of each record in section.
+ *
+ * @param file_size
+ *   Size of file.
+ *
+ * @returns
+ *   True if section is within file and correctly aligned.
+ */
+bool section_valid(const trinket::ZoneSection &section, std::size_t record_size, std::size_t file_size)
+{
+    const auto end =
+        static_cast<std::uint64_t>(section.offset) + static_cast<std::uint64_t>(section.count) * record_size;
+    return ((section.offset % 4u) == 0u) && (end <= file_size);
+}
+
+/**
+ * Check a run of records lies within a section.
+ *
+ * @param first
+ *   Index of first record.
+ *
+ * @param count
+ *   Number of records.
+ *
+ * @param section
+ *   Section records are in.
+ *
+ * @returns
+ *   True if every record is in section.
+ */
+bool span_valid(std::uint32_t first, std::uint32_t count, const trinket::ZoneSection &section)
+{
+    return (static_cast<std::uint64_t>(first) + count) <= section.count;
+}
+
+/**
+ * Check a string lies within the string section.
+ *
+ * @param str
+ *   String to check.
+ *
+ * @param strings
+ *   String section.
+ *
+ * @returns
+ *   True if string is in section.
+ */
+bool string_valid(const trinket::ZoneString &str, const trinket::ZoneSection &strings)
+{
+    return span_valid(str.offset, str.length, strings);
+}
+
+/**
+ * Check a texture index is absent or refers to a texture record.
+ *
+ * @param texture
+ *   Index to check.
+ *
+ * @param textures
+ *   Texture section.
+ *
+ * @returns
+ *   True if index is valid.
+ */
+bool optional_texture_valid(std::uint32_t texture, const trinket::ZoneSection &textures)
+{
+    return (texture == trinket::zone_no_texture) || (texture < textures.count);
+}
+
+}
+
+namespace trinket
+{
+
+BinaryZoneLoader::BinaryZoneLoader(const std::filesystem::path &zone_file, bool merge_static_bodies)
+    : file_(zone_file)
+    , header_(nullptr)
+    , merge_static_bodies_(merge_static_bodies)
+    , preload_steps_()
+    , next_preload_step_(0u)
+{
+    iris::ensure(file_.size() >= sizeof(ZoneFileHeader), "zone file too small");
+    header_ = reinterpret_cast<const ZoneFileHeader *>(file_.data());
+
+    iris::ensure(header_->magic == zone_file_magic, "not a zone file");
+    iris::ensure(header_->version == zone_file_version, "zone file version mismatch, re-run trinket_zone_cook");
+    iris::ensure(header_->file_size == file_.size(), "zone file truncated");
+
+    // validate once up front, so records can be used without further checks
+    const auto size = file_.size();
+    iris::ensure(
+        section_valid(header_->meshes, sizeof(ZoneMesh), size) &&
+            section_valid(header_->parts, sizeof(ZoneMeshPart), size) &&
+            section_valid(header_->textures, sizeof(ZoneTexture), size) &&
+            section_valid(header_->instance_groups, sizeof(ZoneInstanceGroup), size) &&
+            section_valid(header_->instances, sizeof(ZoneInstance), size) &&
+            section_valid(header_->bodies, sizeof(ZoneBody), size) &&
+            section_valid(header_->enemies, sizeof(ZoneEnemy), size) &&
+            section_valid(header_->resource_files, sizeof(ZoneString), size) &&
+            section_valid(header_->strings, 1u, size),
+        "zone file section out of bounds");
+
+    validate();
+}
+
+std::string BinaryZoneLoader::name()
+{
+    return std::string{string(header_->name)};
+}
+
+iris::Vector3 BinaryZoneLoader::player_start_position()
+{
+    return to_vector3(header_->player_start_position);
+}
+
+void BinaryZoneLoader::load_static_geometry(
+    iris::PhysicsSystem *ps,
+    iris::Scene *scene,
+    iris::RenderPipeline *render_pipeline,
+    ZoneCells &cells,
+    NavGrid &nav,
+    JobSystem &jobs)
+{
+    const auto meshes = records<ZoneMesh>(header_->meshes);
+    const auto textures = records<ZoneTexture>(header_->textures);
+    const auto instances = records<ZoneInstance>(header_->instances);
+
+    StageTimer timer{std::string{string(header_->name)} + " static geometry", jobs.worker_count() + 1u};
+    timer.start("upload");
+
+    // if headless then we have no mesh data, every box shape was precomputed when cooking and mesh shapes are
+    // approximated by their cooked bounds
+    const auto parts = (scene == nullptr) ? std::vector<const iris::Mesh *>{} : load_parts();
+    const auto part_bounds = records<ZoneMeshPart>(header_->parts);
+
+    // bounds were computed when cooking, so nothing needs to walk mesh vertices
+    for (std::size_t i = 0u; i < parts.size(); ++i)
+    {
+        cells.set_mesh_bounds(parts[i], to_vector3(part_bounds[i].min), to_vector3(part_bounds[i].max));
+    }
+
+    if (scene != nullptr)
+    {
+        timer.start("materials");
+
+        // groups are already split by material, but different meshes with the same material can still share a graph
+        MaterialCache materials{render_pipeline};
+
+        for (const auto &group : records<ZoneInstanceGroup>(header_->instance_groups))
+        {
+            const auto *mesh = parts[meshes[group.mesh].first_part + group.part];
+            iris::RenderGraph *render_graph = nullptr;
+
+            if (group.texture != zone_no_texture)
+            {
+                const auto &texture = textures[group.texture];
+
+                render_graph = materials.material(
+                    std::string{string(texture.name)},
+                    group.texture_scale,
+                    group.normal != zone_no_texture ? std::string{string(textures[group.normal].name)} : std::string{},
+                    texture.sampler == ZoneSampler::NEAREST);
+            }
+
+            for (const auto &instance : instances.subspan(group.first_instance, group.instance_count))
+            {
+                cells.add(
+                    render_graph,
+                    mesh,
+                    iris::Transform{
+                        to_vector3(instance.position),
+                        to_quaternion(instance.orientation),
+                        to_vector3(instance.scale)});
+            }
+        }
+
+        LOG_INFO(
+            "zone",
+            "{}: {} render graphs for {} textured instance groups, {} instance groups",
+            string(header_->name),
+            materials.graphs(),
+            materials.requests(),
+            header_->instance_groups.count);
+    }
+
+    timer.start("shapes");
+
+    StaticBodyBuilder bodies{ps, merge_static_bodies_};
+    auto approximated = 0u;
+
+    for (std::size_t i = 0u; i < parts.size(); ++i)
+    {
+        bodies.set_mesh_bounds(parts[i], to_vector3(part_bounds[i].min), to_vector3(part_bounds[i].max));
+    }
+
+    for (const auto &body : records<ZoneBody>(header_->bodies))
+    {
+        if (body.shape == ZoneShape::BOX)
+        {
+            bodies.add_box(
+                std::string{string(body.name)},
+                to_vector3(body.position),
+                to_quaternion(body.orientation),
+                to_vector3(body.half_extents));
+        }
+        else if (scene != nullptr)
+        {
+            bodies.add_mesh(
+                std::string{string(body.name)},
+                parts[meshes[body.mesh].first_part + body.part],
+                to_vector3(body.position),
+                to_quaternion(body.orientation),
+                to_vector3(body.scale));
+        }
+        else
+        {
+            // navigation already treats mesh bodies as their bounding box, so this only changes physics contacts
+            const auto &bounds = part_bounds[meshes[body.mesh].first_part + body.part];
+            bodies.add_box(
+                std::string{string(body.name)},
+                to_vector3(body.position),
+                to_quaternion(body.orientation),
+                (to_vector3(bounds.max) - to_vector3(bounds.min)) * 0.5f * to_vector3(body.scale));
+            ++approximated;
+        }
+    }
+
+    bodies.build(jobs, nav);
+
+    if (approximated != 0u)
+    {
+        LOG_INFO(
+            "zone",
+            "{}: {} mesh rigid bodies approximated by their bounds (headless)",
+            string(header_->name),
+            approximated);
+    }
+
+    timer.log();
+}
+
+void BinaryZoneLoader::load_enemies(
+    iris::PhysicsSystem *ps,
+    iris::Scene *scene,
+    iris::RenderPipeline *render_pipeline,
+    std::vector<std::unique_ptr<GameObject>> &game_objects,
+    Player *player,
+    ThirdPersonCamera *camera,
+    const NavGrid &nav,
+    ScriptPool &scripts,
+    JobSystem &jobs)
+{
+    const auto textures = records<ZoneTexture>(header_->textures);
+    const auto enemies = records<ZoneEnemy>(header_->enemies);
+
+    StageTimer timer{std::string{string(header_->name)} + " enemies", jobs.worker_count() + 1u};
+    timer.start("scripts");
+
+    std::vector<std::string> script_files{};
+    for (const auto &enemy : enemies)
+    {
+        script_files.emplace_back(string(enemy.script));
+    }
+
+    scripts.load(script_files, jobs);
+
+    // native enemies are decided for in a single batch, which has to be updated before any of them
+    NativeAi *native_ai = nullptr;
+    if (std::ranges::any_of(script_files, [](const std::string &file) { return is_native_ai(file); }))
+    {
+        auto updater = std::make_unique<NativeAiUpdater>(player, nav);
+        native_ai = &updater->ai();
+        game_objects.emplace_back(std::move(updater));
+    }
+
+    timer.start("create");
+
+    for (std::size_t i = 0u; i < enemies.size(); ++i)
+    {
+        const auto &enemy = enemies[i];
+        const auto position = to_vector3(enemy.position);
+        const auto bounds_min = to_vector3(enemy.bounds_min);
+        const auto bounds_max = to_vector3(enemy.bounds_max);
+        auto ai = is_native_ai(script_files[i]) ? native_ai->create(script_files[i], position, bounds_min, bounds_max)
+                                                : scripts.create(script_files[i], bounds_min, bounds_max);
+
+        if (scene == nullptr)
+        {
+            // headless so no render entities or animations
+            game_objects.emplace_back(std::make_unique<Enemy>(
+                ps,
+                std::move(ai),
+                position,
+                nullptr,
+                nullptr,
+                std::vector<iris::Animation>{},
+                player,
+                nav,
+                camera));
+            continue;
+        }
+
+        const auto mesh_data = AssetCache::instance().mesh(std::string{string(enemy.mesh)});
+        iris::expect(mesh_data.mesh_data.size() == 1u, "expecting only one mesh");
+
+        auto *render_graph = render_pipeline->create_render_graph();
+        auto *texture_node = render_graph->create<iris::TextureNode>(
+            AssetCache::instance().texture(std::string{string(textures[enemy.texture].name)}));
+        render_graph->render_node()->set_colour_input(texture_node);
+
+        auto *health_bar = scene->create_entity<iris::SingleEntity>(
+            nullptr,
+            iris::Root::mesh_manager().sprite({1.0f, 0.0f, 0.0f}),
+            iris::Transform({}, {}, {1.5f, 0.1f, 1.0f}));
+
+        auto *entity = scene->create_entity<iris::SingleEntity>(
+            render_graph,
+            mesh_data.mesh_data.front().mesh,
+            iris::Transform(position, to_quaternion(enemy.orientation), to_vector3(enemy.scale)),
+            mesh_data.skeleton);
+        game_objects.emplace_back(std::make_unique<Enemy>(
+            ps,
+            std::move(ai),
+            position,
+            entity,
+            health_bar,
+            mesh_data.animations,
+            player,
+            nav,
+            camera));
+    }
+
+    timer.log();
+}
+
+std::tuple<iris::Transform, std::string> BinaryZoneLoader::portal()
+{
+    return {
+        iris::Transform{to_vector3(header_->portal_position), {}, to_vector3(header_->portal_scale)},
+        std::string{string(header_->portal_destination)}};
+}
+
+std::vector<std::string> BinaryZoneLoader::resource_files()
+{
+    std::vector<std::string> files{};
+
+    for (const auto &file : records<ZoneString>(header_->resource_files))
+    {
+        files.emplace_back(string(file));
+    }
+
+    return files;
+}
+
+void BinaryZoneLoader::begin_preload()
+{
+    // the steps only depend on zone data so are kept, but every one is run again
+    next_preload_step_ = 0u;
+}
+
+bool BinaryZoneLoader::preload_step()
+{
+    if (preload_steps_.empty())
+    {
+        // the mesh and texture sections already hold each asset once, with the sampler load_static_geometry will use
+        for (const auto &mesh : records<ZoneMesh>(header_->meshes))
+        {
+            if (mesh.kind == ZoneMeshKind::FILE)
+            {
+                preload_steps_.emplace_back(
+                    [name = std::string{string(mesh.name)}] { AssetCache::instance().mesh(name); });
+            }
+        }
+
+        for (const auto &texture : records<ZoneTexture>(header_->textures))
+        {
+            preload_steps_.emplace_back(
+                [name = std::string{string(texture.name)}, nearest = texture.sampler == ZoneSampler::NEAREST] {
+                    AssetCache::instance().texture(name, nearest ? MaterialCache::nearest_sampler() : nullptr);
+                });
+        }
+
+        std::set<std::string_view> enemy_meshes{};
+        std::set<std::string_view> scripts{};
+        for (const auto &enemy : records<ZoneEnemy>(header_->enemies))
+        {
+            enemy_meshes.emplace(string(enemy.mesh));
+            if (!is_native_ai(string(enemy.script)))
+            {
+                scripts.emplace(string(enemy.script));
+            }
+        }
+
+        for (const auto &mesh : enemy_meshes)
+        {
+            preload_steps_.emplace_back([name = std::string{mesh}] { AssetCache::instance().mesh(name); });
+        }
+
+        for (const auto &script : scripts)
+        {
+            preload_steps_.emplace_back(
+                [name = std::string{script}] { iris::ResourceLoader::instance().load(name); });
+        }
+    }
+
+    if (next_preload_step_ < preload_steps_.size())
+    {
+        preload_steps_[next_preload_step_]();
+        ++next_preload_step_;
+    }
+
+    return next_preload_step_ < preload_steps_.size();
+}
+
+void BinaryZoneLoader::validate() const
+{
+    const auto &strings = header_->strings;
+
+    iris::ensure(
+        string_valid(header_->name, strings) && string_valid(header_->portal_destination, strings),
+        "zone file header string out of bounds");
+
+    const auto meshes = records<ZoneMesh>(header_->meshes);
+    for (const auto &mesh : meshes)
+    {
+        iris::ensure(string_valid(mesh.name, strings), "zone file mesh name out of bounds");
+        iris::ensure(
+            (mesh.kind == ZoneMeshKind::CUBE) || (mesh.kind == ZoneMeshKind::FILE), "zone file mesh kind invalid");
+        iris::ensure(
+            span_valid(mesh.first_part, mesh.part_count, header_->parts) &&
+                ((mesh.kind == ZoneMeshKind::FILE) || (mesh.part_count == 1u)),
+            "zone file mesh parts out of bounds");
+    }
+
+    // a mesh and part index pair must name a part of an existing mesh
+    const auto part_valid = [&meshes](std::uint32_t mesh, std::uint32_t part) {
+        return (mesh < meshes.size()) && (part < meshes[mesh].part_count);
+    };
+
+    for (const auto &texture : records<ZoneTexture>(header_->textures))
+    {
+        iris::ensure(string_valid(texture.name, strings), "zone file texture name out of bounds");
+        iris::ensure(
+            (texture.sampler == ZoneSampler::DEFAULT) || (texture.sampler == ZoneSampler::NEAREST),
+            "zone file texture sampler invalid");
+    }
+
+    for (const auto &group : records<ZoneInstanceGroup>(header_->instance_groups))
+    {
+        iris::ensure(part_valid(group.mesh, group.part), "zone file instance group mesh out of bounds");
+        iris::ensure(
+            optional_texture_valid(group.texture, header_->textures) &&
+                optional_texture_valid(group.normal, header_->textures),
+            "zone file instance group texture out of bounds");
+        iris::ensure(
+            span_valid(group.first_instance, group.instance_count, header_->instances),
+            "zone file instance group instances out of bounds");
+    }
+
+    for (const auto &body : records<ZoneBody>(header_->bodies))
+    {
+        iris::ensure(string_valid(body.name, strings), "zone file body name out of bounds");
+        iris::ensure((body.shape == ZoneShape::BOX) || (body.shape == ZoneShape::MESH), "zone file body shape invalid");
+        iris::ensure(
+            (body.shape != ZoneShape::MESH) || part_valid(body.mesh, body.part), "zone file body mesh out of bounds");
+    }
+
+    for (const auto &enemy : records<ZoneEnemy>(header_->enemies))
+    {
+        iris::ensure(
+            string_valid(enemy.mesh, strings) && string_valid(enemy.script, strings),
+            "zone file enemy string out of bounds");
+        iris::ensure(enemy.texture < header_->textures.count, "zone file enemy texture out of bounds");
+    }
+
+    for (const auto &file : records<ZoneString>(header_->resource_files))
+    {
+        iris::ensure(string_valid(file, strings), "zone file resource file out of bounds");
+    }
+}
+
+std::string_view BinaryZoneLoader::string(const ZoneString &str) const
+{
+    iris::expect(
+        static_cast<std::uint64_t>(str.offset) + str.length <= header_->strings.count, "string out of bounds");
+
+    return {reinterpret_cast<const char *>(file_.data() + header_->strings.offset + str.offset), str.length};
+}
+
+std::vector<const iris::Mesh *> BinaryZoneLoader::load_parts() const
+{
+    std::vector<const iris::Mesh *> parts(header_->parts.count, nullptr);
+
+    for (const auto &mesh : records<ZoneMesh>(header_->meshes))
+    {
+        if (mesh.kind == ZoneMeshKind::CUBE)
+        {
+            parts[mesh.first_part] = iris::Root::mesh_manager().cube({});
+            continue;
+        }
+
+        const auto mesh_data = AssetCache::instance().mesh(std::string{string(mesh.name)});
+        iris::ensure(mesh_data.mesh_data.size() == mesh.part_count, "mesh changed since zone was cooked");
+
+        for (auto i = 0u; i < mesh.part_count; ++i)
+        {
+            parts[mesh.first_part + i] = mesh_data.mesh_data[i].mesh;
+        }
+    }
+
+    return parts;
+}
+
+}
@@ -0,0 +1,385 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+// Offline tool which measures the cost of publishing messages through the MessageBroker.
+//
+// usage: trinket_broker_bench
+//
+// For each subscriber count a fixed number of weapon collisions (the largest payload, sent by the player every tick for
+// every contact) are published, first through a copy of the original broker, which boxed every payload in a std::any
+// and had subscribers any_cast it back, and then through the typed MessageBroker. The typed broker is also measured
+// queued and then flushed, and addressed to a single key (with every subscriber subscribed to its own key, as enemies
+// are). Each run is done once to grow the broker's buffers and then again to measure it, printing the average cost of
+// a publish (including dispatching it to its subscribers) and the number of heap allocations per publish.
+
+#include <algorithm>
+#include <any>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "iris/core/start.h"
+#include "iris/core/vector3.h"
+#include "iris/physics/rigid_body.h"
+
+#include "message_broker.h"
+#include "message_data.h"
+#include "message_type.h"
+#include "subscriber.h"
+
+namespace
+{
+
+/** Number of heap allocations made since the program started. */
+std::atomic<std::size_t> allocation_count{0u};
+
+}
+
+// replace the global allocation functions so every heap allocation, including those made by the standard library, is
+// counted
+
+void *operator new(std::size_t size)
+{
+    allocation_count.fetch_add(1u, std::memory_order_relaxed);
+
+    if (auto *ptr = std::malloc(size == 0u ? 1u : size); ptr != nullptr)
+    {
+        return ptr;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+
+/** Subscriber counts to measure. */
+constexpr std::array<std::size_t, 3u> subscriber_counts{1u, 10u, 100u};
+
+/** Number of messages to publish for each run. */
+constexpr std::uint32_t publish_count = 100000u;
+
+/** Number of messages to publish between flushes when queued, a generous frame's worth. */
+constexpr std::uint32_t flush_interval = 100u;
+
+/** Position of every published collision. */
+constexpr iris::Vector3 contact_position{1.0f, 2.0f, 3.0f};
+
+/**
+ * Internal struct for the results of a run.
+ */
+struct Result
+{
+    /** Time taken to publish (and deliver) all messages. */
+    std::chrono::steady_clock::duration duration;
+
+    /** Number of heap allocations made whilst publishing. */
+    std::size_t allocations;
+};
+
+class AnySubscriber;
+
+/**
+ * Copy of the original broker, which mapped each message type to its subscribers and boxed every payload in a
+ * std::any.
+ */
+class AnyBroker
+{
+  public:
+    /**
+     * Subscribe a subscriber to a message type.
+     *
+     * @param subscriber
+     *   Object wanting to subscribe.
+     *
+     * @param message_type
+     *   Type of message to subscribe to.
+     */
+    void subscribe(AnySubscriber *subscriber, trinket::MessageType message_type)
+    {
+        subscriptions_[message_type].emplace_back(subscriber);
+    }
+
+    /**
+     * Unsubscribe a subscriber from a message type.
+     *
+     * @param subscriber
+     *   Object wanting to unsubscribe.
+     *
+     * @param message_type
+     *   Type of message to unsubscribe from.
+     */
+    void unsubscribe(AnySubscriber *subscriber, trinket::MessageType message_type)
+    {
+        auto &subs = subscriptions_[message_type];
+        subs.erase(std::remove(std::begin(subs), std::end(subs), subscriber), std::end(subs));
+    }
+
+    /*
+     * Publish a message to all subscribers.
+     *
+     * @param message_type
+     *   Type of message being sent (will be sent to subscribers of this type).
+     *
+     * @param data
+     *   Any data for the message.
+     */
+    void publish(trinket::MessageType message_type, const std::any &data) const;
+
+  private:
+    /** Collection of subscriptions. */
+    std::unordered_map<trinket::MessageType, std::vector<AnySubscriber *>> subscriptions_;
+};
+
+/**
+ * Subscriber to the original broker, which counts the weapon collisions it receives.
+ */
+class AnySubscriber
+{
+  public:
+    /**
+     * Construct a new AnySubscriber.
+     *
+     * @param broker
+     *   Broker to subscribe to.
+     *
+     * @param received
+     *   Counter to increment for every message received.
+     */
+    AnySubscriber(AnyBroker &broker, std::uint64_t &received)
+        : broker_(broker)
+        , received_(received)
+    {
+        broker_.subscribe(this, trinket::MessageType::WEAPON_COLLISION);
+    }
+
+    virtual ~AnySubscriber()
+    {
+        broker_.unsubscribe(this, trinket::MessageType::WEAPON_COLLISION);
+    }
+
+    AnySubscriber(const AnySubscriber &) = delete;
+    AnySubscriber &operator=(const AnySubscriber &) = delete;
+
+    /**
+     * Message handler, as the original subscribers were written.
+     *
+     * @param message_type
+     *   Type of message being sent.
+     *
+     * @param data
+     *   Any data for the message.
+     */
+    virtual void handle_message(trinket::MessageType message_type, const std::any &data)
+    {
+        if (message_type == trinket::MessageType::WEAPON_COLLISION)
+        {
+            const auto [body, position] = std::any_cast<std::tuple<iris::RigidBody *, iris::Vector3>>(data);
+            received_ += static_cast<std::uint64_t>(position.x);
+        }
+    }
+
+  private:
+    /** Broker subscribed to. */
+    AnyBroker &broker_;
+
+    /** Counter to increment for every message received. */
+    std::uint64_t &received_;
+};
+
+void AnyBroker::publish(trinket::MessageType message_type, const std::any &data) const
+{
+    if (const auto subs = subscriptions_.find(message_type); subs != std::cend(subscriptions_))
+    {
+        for (auto *subscriber : subs->second)
+        {
+            subscriber->handle_message(message_type, data);
+        }
+    }
+}
+
+/**
+ * Subscriber to the typed broker, which counts the collisions it receives.
+ */
+class TypedSubscriber : public trinket::Subscriber
+{
+  public:
+    /**
+     * Construct a new TypedSubscriber.
+     *
+     * @param received
+     *   Counter to increment for every message received.
+     */
+    explicit TypedSubscriber(std::uint64_t &received)
+        : received_(received)
+    {
+        subscribe<trinket::MessageType::WEAPON_COLLISION>(this);
+        subscribe<trinket::MessageType::OBJECT_COLLISION>(this, this);
+    }
+
+    void handle_message(const trinket::Message<trinket::MessageType::WEAPON_COLLISION> &message)
+    {
+        received_ += static_cast<std::uint64_t>(message.data.position.x);
+    }
+
+    void handle_message(const trinket::Message<trinket::MessageType::OBJECT_COLLISION> &message)
+    {
+        received_ += static_cast<std::uint64_t>(message.data.position.x);
+    }
+
+  private:
+    /** Counter to increment for every message received. */
+    std::uint64_t &received_;
+};
+
+/**
+ * Publish a fixed number of messages, once to warm up and then again measuring the time taken and allocations made.
+ *
+ * @param publish_all
+ *   Function which publishes all the messages.
+ *
+ * @returns
+ *   Results of measured run.
+ */
+Result run(const std::function<void()> &publish_all)
+{
+    publish_all();
+
+    const auto allocations_before = allocation_count.load(std::memory_order_relaxed);
+    const auto start = std::chrono::steady_clock::now();
+
+    publish_all();
+
+    const auto end = std::chrono::steady_clock::now();
+
+    return {
+        .duration = end - start,
+        .allocations = allocation_count.load(std::memory_order_relaxed) - allocations_before};
+}
+
+/**
+ * Print the results of a run.
+ *
+ * @param name
+ *   Name of run.
+ *
+ * @param count
+ *   Number of subscribers.
+ *
+ * @param result
+ *   Results of run.
+ */
+void print(const std::string &name, std::size_t count, const Result &result)
+{
+    std::cout << name << " " << count << " subscribers: "
+              << std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(result.duration).count() /
+                     static_cast<double>(publish_count)
+              << "ns per publish, "
+              << static_cast<double>(result.allocations) / static_cast<double>(publish_count)
+              << " allocations per publish" << std::endl;
+}
+
+void bench(int, char **)
+{
+    auto &broker = trinket::MessageBroker::instance();
+    AnyBroker any_broker{};
+
+    // the original player published its contacts' bodies, we never dereference them so any address will do
+    auto *body = reinterpret_cast<iris::RigidBody *>(&any_broker);
+
+    for (const auto count : subscriber_counts)
+    {
+        std::uint64_t received = 0u;
+        std::vector<std::unique_ptr<AnySubscriber>> any_subscribers{};
+        std::vector<std::unique_ptr<TypedSubscriber>> typed_subscribers{};
+
+        for (std::size_t i = 0u; i < count; ++i)
+        {
+            any_subscribers.emplace_back(std::make_unique<AnySubscriber>(any_broker, received));
+            typed_subscribers.emplace_back(std::make_unique<TypedSubscriber>(received));
+        }
+
+        // published exactly as the original player did, building the std::any from a tuple each time
+        print("std::any immediate", count, run([&any_broker, body] {
+                  for (std::uint32_t i = 0u; i < publish_count; ++i)
+                  {
+                      any_broker.publish(
+                          trinket::MessageType::WEAPON_COLLISION, std::make_tuple(body, contact_position));
+                  }
+              }));
+
+        broker.set_queued(false);
+
+        print("typed immediate", count, run([&broker, body] {
+                  for (std::uint32_t i = 0u; i < publish_count; ++i)
+                  {
+                      broker.publish<trinket::MessageType::WEAPON_COLLISION>(
+                          {.body = body, .position = contact_position});
+                  }
+              }));
+
+        broker.set_queued(true);
+
+        print("typed queued", count, run([&broker, body] {
+                  for (std::uint32_t i = 0u; i < publish_count; ++i)
+                  {
+                      broker.publish<trinket::MessageType::WEAPON_COLLISION>(
+                          {.body = body, .position = contact_position});
+
+                      if ((i + 1u) % flush_interval == 0u)
+                      {
+                          broker.flush();
+                      }
+                  }
+
+                  broker.flush();
+              }));
+
+        broker.set_queued(false);
+
+        // address every message to the last subscriber, so a linear search for the key would be at its worst
+        const trinket::MessageKey key = typed_subscribers.back().get();
+
+        print("typed keyed", count, run([&broker, body, key] {
+                  for (std::uint32_t i = 0u; i < publish_count; ++i)
+                  {
+                      broker.publish<trinket::MessageType::OBJECT_COLLISION>(
+                          key, {.body = body, .position = contact_position});
+                  }
+              }));
+
+        std::cout << "  (" << received << " messages received)" << std::endl;
+    }
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    iris::start(argc, argv, bench);
+    return 0;
+}
@@ -21,7 +21,7 @@ CharacterController::CharacterController(
     float float_height)
     : iris::BasicCharacterController(ps, speed, width, height, float_height)
     , is_being_shunted_(false)
-    , shunt_end_(std::chrono::system_clock::now())
+    , shunt_remaining_()
     , saved_movement_direction_()
     , saved_speed_(0.0)
 {
@@ -44,11 +44,17 @@ void CharacterController::update(iris::PhysicsSystem *ps, std::chrono::milliseco
 {
     iris::BasicCharacterController::update(ps, delta);
 
-    if (is_being_shunted_ && (std::chrono::system_clock::now() > shunt_end_))
+    // count down in simulation time, so a shunt always lasts the same number of physics steps
+    if (is_being_shunted_)
     {
-        movement_direction_ = saved_movement_direction_;
-        speed_ = saved_speed_;
-        is_being_shunted_ = false;
+        shunt_remaining_ -= delta;
+
+        if (shunt_remaining_ <= std::chrono::milliseconds::zero())
+        {
+            movement_direction_ = saved_movement_direction_;
+            speed_ = saved_speed_;
+            is_being_shunted_ = false;
+        }
     }
 }
 
@@ -62,7 +68,7 @@ void CharacterController::shunt(const iris::Vector3 direction, float distance, s
         movement_direction_ = direction;
         speed_ = distance / (static_cast<float>(time.count()) / 1000.0f);
 
-        shunt_end_ = std::chrono::system_clock::now() + time;
+        shunt_remaining_ = time;
         is_being_shunted_ = true;
     }
 }
@@ -6,11 +6,12 @@
 
 #include "enemy.h"
 
-#include <any>
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
-#include "iris/core/resource_loader.h"
 #include "iris/core/vector3.h"
 #include "iris/graphics/animation/animation_layer.h"
 #include "iris/graphics/scene.h"
@@ -18,11 +19,16 @@
 #include "iris/log/log.h"
 #include "iris/physics/physics_system.h"
 #include "iris/physics/rigid_body.h"
-#include "iris/scripting/lua/lua_script.h"
 
 #include "character_controller.h"
+#include "enemy_ai.h"
+#include "enemy_decision.h"
+#include "message_data.h"
 #include "message_type.h"
+#include "nav_grid.h"
 #include "player.h"
+#include "profiler.h"
+#include "transform_interpolator.h"
 
 using namespace std::literals::chrono_literals;
 
@@ -31,137 +37,184 @@ namespace trinket
 
 Enemy::Enemy(
     iris::PhysicsSystem *ps,
-    const std::string &script_file,
+    std::unique_ptr<EnemyAi> ai,
+    const iris::Vector3 &start_position,
     iris::SingleEntity *render_entity,
     iris::SingleEntity *health_bar,
     std::vector<iris::Animation> animations,
-    const iris::Vector3 &bounds_min,
-    const iris::Vector3 &bounds_max,
     const Player *player,
+    const NavGrid &nav,
     const ThirdPersonCamera *camera)
-    : script_(std::make_unique<iris::LuaScript>(script_file, iris::LuaScript::LoadFile{}))
+    : ai_(std::move(ai))
     , render_entity_(render_entity)
     , health_bar_(health_bar)
     , animation_controller_(nullptr)
     , character_controller_(nullptr)
     , player_(player)
+    , nav_(nav)
+    , decision_()
     , camera_(camera)
-    , hit_cooldown_(std::chrono::system_clock::now())
-    , health_bar_scale_(health_bar_->scale())
+    , hit_cooldown_()
+    , sim_time_()
+    , health_bar_scale_(health_bar_ == nullptr ? iris::Vector3{1.5f, 0.1f, 1.0f} : health_bar_->scale())
+    , position_(start_position)
     , health_(100.0f)
     , is_dead_(false)
+    , active_(true)
 {
-    // call init of script
-    script_.execute("init", bounds_min, bounds_max);
-
-    // set death animation to not loop
-    auto find = std::find_if(std::begin(animations), std::end(animations), [](const iris::Animation &animation) {
-        return animation.name() == "Death_Back";
-    });
-    find->set_playback_type(iris::PlaybackType::SINGLE);
-
-    // create animation controller with required transitions
-    animation_controller_ = std::make_unique<iris::AnimationController>(
-        animations,
-        std::vector<iris::AnimationLayer>{
-            {{{"Walk", "Walk", 0ms},
-              {"Walk", "Bite_Front", 500ms},
-              {"Walk", "Death_Back", 500ms},
-              {"Bite_Front", "Death_Back", 500ms},
-              {"Death_Back", "Death_Back", 0ms},
-              {"Bite_Front", "Walk", 500ms},
-              {"Bite_Front", "Bite_Front", 0ms}},
-             "Walk"}},
-        render_entity_->skeleton());
+    // animations need a skeleton, which we don't have if headless
+    if (render_entity_ != nullptr)
+    {
+        // set death animation to not loop
+        auto find = std::find_if(std::begin(animations), std::end(animations), [](const iris::Animation &animation) {
+            return animation.name() == "Death_Back";
+        });
+        find->set_playback_type(iris::PlaybackType::SINGLE);
+
+        // create animation controller with required transitions
+        animation_controller_ = std::make_unique<iris::AnimationController>(
+            animations,
+            std::vector<iris::AnimationLayer>{
+                {{{"Walk", "Walk", 0ms},
+                  {"Walk", "Bite_Front", 500ms},
+                  {"Walk", "Death_Back", 500ms},
+                  {"Bite_Front", "Death_Back", 500ms},
+                  {"Death_Back", "Death_Back", 0ms},
+                  {"Bite_Front", "Walk", 500ms},
+                  {"Bite_Front", "Bite_Front", 0ms}},
+                 "Walk"}},
+            render_entity_->skeleton());
+    }
 
     character_controller_ = ps->create_character_controller<CharacterController>(ps, 1.0f, 1.0f, 0.5f, 2.0f);
-    character_controller_->reposition(render_entity_->position(), {});
+    character_controller_->reposition(position_, {});
+
+    // only interested in weapon collisions with our body
+    subscribe<MessageType::WEAPON_COLLISION>(this, character_controller_->rigid_body());
+}
+
+void Enemy::prepare(std::chrono::microseconds elapsed)
+{
+    if (is_dead_)
+    {
+        return;
+    }
 
-    subscribe(MessageType::WEAPON_COLLISION);
+    // a single call gets everything the AI decided this tick, the player has already been updated this tick so its
+    // position can be read without touching physics
+    TRINKET_PROFILE_SCOPE("ai_update");
+    const auto player_position = player_->tick_position();
+    decision_ = ai_->tick(position_, player_position, nav_.direction(position_, player_position), elapsed, health_);
 }
 
 void Enemy::update(std::chrono::microseconds elapsed)
 {
+    sim_time_ = elapsed;
+
     // if we are not dead then update
     if (!is_dead_)
     {
-        // call script update
-        script_.execute(
-            "update",
-            render_entity_->position(),
-            player_->position(),
-            static_cast<std::int32_t>(elapsed.count()),
-            health_);
-
         static const iris::Vector3 offset{0.0f, -2.0f, 0.0f};
 
         // update entity
-        character_controller_->set_movement_direction(script_.execute<iris::Vector3>("get_walk_direction"));
-        render_entity_->set_orientation(script_.execute<iris::Quaternion>("get_orientation"));
-        render_entity_->set_position(character_controller_->position() + offset);
+        character_controller_->set_movement_direction(decision_.walk_direction);
+        position_ = character_controller_->position() + offset;
+        ai_->moved(position_);
 
-        // update billboard health bar
-        iris::Transform billboard_transform{iris::Matrix4::invert(camera_->camera()->view())};
-        billboard_transform.set_translation(render_entity_->position() + iris::Vector3{0.0f, 3.0f, 0.0f});
-        billboard_transform.set_scale(health_bar_scale_);
-        health_bar_->set_transform(billboard_transform.matrix());
+        if (render_entity_ != nullptr)
+        {
+            render_entity_->set_orientation(decision_.orientation);
+            render_entity_->set_position(position_);
+
+            // update billboard health bar
+            iris::Transform billboard_transform{iris::Matrix4::invert(camera_->camera()->view())};
+            billboard_transform.set_translation(position_ + iris::Vector3{0.0f, 3.0f, 0.0f});
+            billboard_transform.set_scale(health_bar_scale_);
+            health_bar_->set_transform(billboard_transform.matrix());
+        }
 
         // check if script wants us to update animation
-        if (const auto [change, animation] = script_.execute<bool, std::string>("get_animation_change"); change)
+        if (!decision_.animation.empty() && (animation_controller_ != nullptr))
         {
-            LOG_DEBUG("enemy", "new animation: {}", animation);
-            animation_controller_->play(0u, animation);
+            LOG_DEBUG("enemy", "new animation: {}", decision_.animation);
+            animation_controller_->play(0u, decision_.animation);
         }
 
         // if script attacks then send message
-        if (const auto attack = script_.execute<bool>("attack_player"); attack)
+        if (decision_.attack)
         {
-            publish(MessageType::ENEMY_ATTACK, {1.0f});
+            publish<MessageType::ENEMY_ATTACK>(1.0f);
         }
 
         // if we die then send message and update state
         if (health_ <= 0.0f)
         {
-            character_controller_->reposition(render_entity_->position(), {});
+            character_controller_->reposition(position_, {});
             is_dead_ = true;
 
-            publish(MessageType::KILLED_ENEMY, {this});
+            publish<MessageType::KILLED_ENEMY>(this);
         }
     }
 
-    animation_controller_->update();
+    if (animation_controller_ != nullptr)
+    {
+        animation_controller_->update();
+    }
 }
 
-void Enemy::handle_message(MessageType message_type, const std::any &data)
+UpdatePhase Enemy::update_phase() const
 {
-    switch (message_type)
+    return UpdatePhase::AI;
+}
+
+void Enemy::add_interpolated(TransformInterpolator &interpolator)
+{
+    if (render_entity_ != nullptr)
     {
-        case MessageType::WEAPON_COLLISION:
-        {
-            // if we are hit by player (and not in a hit cooldown) then shunt us and decrement health
-            const auto &[body, pos] = std::any_cast<std::tuple<iris::RigidBody *, iris::Vector3>>(data);
-            if (body == character_controller_->rigid_body())
-            {
-                if (std::chrono::system_clock::now() > hit_cooldown_)
-                {
-                    hit_cooldown_ = std::chrono::system_clock::now() + 500ms;
-                    const auto shunt_dir =
-                        iris::Vector3::normalise(character_controller_->position() - player_->position());
-                    character_controller_->shunt(shunt_dir, 6.0, 200ms);
-
-                    health_ -= 25.0f;
-                    health_bar_scale_.x = 1.5f * (health_ / 100.0f);
-                }
-                break;
-            }
-        }
-        default: break;
+        interpolator.add(render_entity_);
+        interpolator.add(health_bar_);
+    }
+}
+
+bool Enemy::is_parallel() const
+{
+    return true;
+}
+
+void Enemy::handle_message(const Message<MessageType::WEAPON_COLLISION> &)
+{
+    // we are hit by player (messages are keyed by our body) so if not in a hit cooldown then shunt us and decrement
+    // health
+    if (sim_time_ > hit_cooldown_)
+    {
+        hit_cooldown_ = sim_time_ + 500ms;
+        const auto shunt_dir = iris::Vector3::normalise(character_controller_->position() - player_->position());
+        character_controller_->shunt(shunt_dir, 6.0, 200ms);
+
+        health_ -= 25.0f;
+        health_bar_scale_.x = 1.5f * (health_ / 100.0f);
     }
 }
 
 iris::Vector3 Enemy::position() const
 {
-    return render_entity_->position();
+    return position_;
+}
+
+std::optional<iris::Vector3> Enemy::cull_position() const
+{
+    return position_;
+}
+
+void Enemy::set_active(bool active)
+{
+    // the character controller keeps moving in the last direction the script gave it, so stop it whilst we're culled
+    if (active_ && !active)
+    {
+        character_controller_->set_movement_direction({});
+    }
+
+    active_ = active;
 }
 
 }
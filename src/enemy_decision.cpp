@@ -0,0 +1,41 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "enemy_decision.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "iris/core/quaternion.h"
+#include "iris/core/vector3.h"
+#include "iris/scripting/script_runner.h"
+
+namespace trinket
+{
+
+EnemyDecision tick_script(
+    iris::ScriptRunner &script,
+    std::int32_t id,
+    const iris::Vector3 &position,
+    const iris::Vector3 &player_position,
+    const iris::Vector3 &steering,
+    std::chrono::microseconds elapsed,
+    float health)
+{
+    auto [walk_direction, orientation, animation, attack] =
+        script.execute<iris::Vector3, iris::Quaternion, std::string, bool>(
+            "tick", id, position, player_position, steering, static_cast<std::int32_t>(elapsed.count()), health);
+
+    return {
+        .walk_direction = walk_direction,
+        .orientation = orientation,
+        .animation = std::move(animation),
+        .attack = attack};
+}
+
+}
@@ -7,12 +7,14 @@
 #include "game.h"
 
 #include <algorithm>
-#include <any>
 #include <chrono>
 #include <cmath>
-#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <map>
 #include <memory>
+#include <thread>
 #include <vector>
 
 #include "iris/core/camera.h"
@@ -37,60 +39,141 @@
 #include "iris/graphics/texture_manager.h"
 #include "iris/graphics/window.h"
 #include "iris/graphics/window_manager.h"
+#include "iris/log/log.h"
 #include "iris/physics/physics_manager.h"
 #include "iris/physics/physics_system.h"
 #include "iris/physics/rigid_body.h"
 #include "iris/physics/rigid_body_type.h"
 
+#include "ai_scheduler.h"
+#include "asset_cache.h"
 #include "config.h"
 #include "enemy.h"
 #include "game_object.h"
 #include "hud.h"
 #include "input_handler.h"
+#include "job_system.h"
 #include "kill_enemy_quest.h"
 #include "maths.h"
+#include "message_broker.h"
+#include "message_data.h"
 #include "message_type.h"
+#include "nav_grid.h"
 #include "player.h"
+#include "profiler.h"
 #include "publisher.h"
 #include "quest_manager.h"
+#include "script_pool.h"
 #include "third_person_camera.h"
+#include "transform_interpolator.h"
+#include "update_phase.h"
 #include "zone_loader.h"
+#include "zone_preloader.h"
 
 using namespace std::literals::chrono_literals;
 
+namespace
+{
+
+/** File message stats are written to. */
+constexpr auto message_stats_path = "message_stats.json";
+
+/** File profiler trace is written to. */
+constexpr auto profile_trace_path = "profile_trace.json";
+
+/** Directory resources are loaded from. */
+constexpr auto resource_root = "assets";
+
+/** Time each frame can spend preloading the next zone. */
+constexpr std::chrono::microseconds preload_budget{2000};
+
+/**
+ * Collect persistent and zone objects into a single collection, sorted into update order.
+ *
+ * @param persistent_objects
+ *   Objects which live across zones.
+ *
+ * @param zone_objects
+ *   Objects owned by the current zone.
+ *
+ * @returns
+ *   All objects, sorted by update phase.
+ */
+std::vector<trinket::GameObject *> sorted_objects(
+    const std::vector<std::unique_ptr<trinket::GameObject>> &persistent_objects,
+    const std::vector<std::unique_ptr<trinket::GameObject>> &zone_objects)
+{
+    std::vector<trinket::GameObject *> objects{};
+    objects.reserve(persistent_objects.size() + zone_objects.size());
+
+    for (const auto &object : persistent_objects)
+    {
+        objects.emplace_back(object.get());
+    }
+
+    for (const auto &object : zone_objects)
+    {
+        objects.emplace_back(object.get());
+    }
+
+    // objects are updated phase by phase, stable so objects within a phase keep the order they were created in
+    std::stable_sort(std::begin(objects), std::end(objects), [](const auto *a, const auto *b) {
+        return a->update_phase() < b->update_phase();
+    });
+
+    return objects;
+}
+
+}
+
 namespace trinket
 {
 
-Game::Game(std::unique_ptr<Config> config, std::vector<std::unique_ptr<ZoneLoader>> &&zone_loaders)
+Game::Game(std::unique_ptr<Config> config, std::unique_ptr<ZoneRegistry> zones)
     : running_(true)
+    , headless_(false)
     , config_(std::move(config))
-    , zone_loaders_(std::move(zone_loaders))
+    , zones_(std::move(zones))
     , current_zone_(nullptr)
     , next_zone_(nullptr)
     , window_(nullptr)
     , portal_(nullptr)
     , portal_destination_()
+    , jobs_(std::make_unique<JobSystem>(config_->uint32_option(ConfigOption::WORKER_THREADS)))
+    , scripts_(std::make_unique<ScriptPool>(jobs_->worker_count() + 1u))
+    , captured_messages_()
+    , active_objects_()
+    , simulated_ticks_(0u)
+    , physics_remainder_(0)
+    , preloader_(std::make_unique<ZonePreloader>(resource_root))
+    , input_handler_()
+    , persistent_objects_()
+    , player_(nullptr)
+    , camera_(nullptr)
+    , hud_(nullptr)
     , state_(GameState::PLAYING)
 {
-    const auto starting_zone_name = config_->string_option(ConfigOption::STARTING_ZONE);
-
-    auto starting_zone =
-        std::find_if(std::begin(zone_loaders_), std::end(zone_loaders_), [&starting_zone_name](auto &element) {
-            return element->name() == starting_zone_name;
-        });
-    iris::ensure(starting_zone != std::end(zone_loaders_), "missing starting zone");
-
-    next_zone_ = starting_zone->get();
-
-    subscribe(MessageType::QUIT);
-    subscribe(MessageType::KEY_PRESS);
-    subscribe(MessageType::PLAYER_DIED);
+    next_zone_ = zones_->zone(config_->string_option(ConfigOption::STARTING_ZONE));
+    headless_ = config_->bool_option(ConfigOption::HEADLESS);
+
+    MessageBroker::instance().set_queued(config_->bool_option(ConfigOption::QUEUED_MESSAGES));
+    MessageBroker::instance().set_stats_enabled(config_->bool_option(ConfigOption::MESSAGE_STATS));
+    Profiler::instance().set_enabled(config_->bool_option(ConfigOption::PROFILER));
+    AssetCache::instance().set_budget(
+        static_cast<std::size_t>(config_->uint32_option(ConfigOption::ASSET_CACHE_MB)) * 1024u * 1024u);
+
+    subscribe<MessageType::QUIT>(this);
+    subscribe<MessageType::KEY_PRESS>(this);
+    subscribe<MessageType::PLAYER_DIED>(this);
 }
 
 void Game::run()
 {
-    window_ = iris::Root::window_manager().create_window(
-        config_->uint32_option(ConfigOption::SCREEN_WIDTH), config_->uint32_option(ConfigOption::SCREEN_HEIGHT));
+    if (!headless_)
+    {
+        window_ = iris::Root::window_manager().create_window(
+            config_->uint32_option(ConfigOption::SCREEN_WIDTH), config_->uint32_option(ConfigOption::SCREEN_HEIGHT));
+    }
 
     // the main game loops keeps going until signalled to stop
     do
@@ -100,8 +183,26 @@ void Game::run()
         next_zone_ = nullptr;
 
         // actually run the game
-        run_zone();
+        if (headless_)
+        {
+            run_headless_zone();
+        }
+        else
+        {
+            run_zone();
+        }
     } while (running_);
+
+    if (MessageBroker::instance().stats_enabled())
+    {
+        MessageBroker::instance().stats().write_json(message_stats_path);
+    }
+
+    if (Profiler::instance().enabled())
+    {
+        Profiler::instance().write_trace(profile_trace_path);
+        Profiler::instance().log_summary();
+    }
 }
 
 void Game::run_zone()
@@ -120,22 +221,26 @@ void Game::run_zone()
     auto *game_scene = render_pipeline->create_scene();
     auto *rt = iris::Root::render_target_manager().create();
 
-    // setup game objects
-    std::vector<std::unique_ptr<GameObject>> objects{};
-    objects.emplace_back(std::make_unique<InputHandler>(window_));
-    objects.emplace_back(
-        std::make_unique<Player>(game_scene, ps, current_zone_->player_start_position(), *render_pipeline));
-    auto *player = static_cast<Player *>(objects.back().get());
+    auto &broker = MessageBroker::instance();
 
-    objects.emplace_back(std::make_unique<ThirdPersonCamera>(player, window_->width(), window_->height(), ps));
-    auto *camera = static_cast<ThirdPersonCamera *>(objects.back().get());
+    if (player_ == nullptr)
+    {
+        create_persistent_objects(rt->width(), rt->height());
+    }
 
-    objects.emplace_back(std::make_unique<HUD>(100.0f, rt->width(), rt->height(), final_scene));
-    auto *hud = static_cast<HUD *>(objects.back().get());
+    // persistent objects outlive the scene and physics system, so need binding to this zone's
+    player_->bind(game_scene, ps, current_zone_->player_start_position(), render_pipeline.get());
+    camera_->bind(ps);
+    hud_->bind(final_scene);
 
-    objects.emplace_back(std::make_unique<QuestManager>());
-    auto *qm = static_cast<QuestManager *>(objects.back().get());
-    qm->create<KillEnemyQuest>(2u);
+    // health carries over between zones, unless the player is coming back from the dead
+    if (state_ == GameState::DEAD)
+    {
+        player_->respawn();
+    }
+
+    // objects owned by this zone
+    std::vector<std::unique_ptr<GameObject>> zone_objects{};
 
     auto *rg = render_pipeline->create_render_graph();
     rg->render_node()->set_colour_input(rg->create<iris::TextureNode>(rt->colour_texture()));
@@ -146,10 +251,40 @@ void Game::run_zone()
     iris::Camera final_camera{iris::CameraType::ORTHOGRAPHIC, window_->width(), window_->height()};
 
     // load data from zone
-    current_zone_->load_static_geometry(ps, game_scene, *render_pipeline);
-    current_zone_->load_enemies(ps, game_scene, *render_pipeline, objects, player, camera);
+    auto cells = create_cells(game_scene);
+    auto ai = create_ai_scheduler();
+    auto nav = create_nav_grid();
+    {
+        TRINKET_PROFILE_SCOPE("zone_load");
+        const auto load_start = std::chrono::steady_clock::now();
+        const auto preloaded = preloader_->is_preloaded(current_zone_);
+
+        // without a preload nothing is in the file cache yet, so read everything in parallel before the engine
+        // (which can only load on this thread) asks for it one file at a time
+        if (!preloaded)
+        {
+            preloader_->read_now(current_zone_, *jobs_);
+        }
+
+        current_zone_->load_static_geometry(ps, game_scene, render_pipeline.get(), cells, nav, *jobs_);
+        cells.build();
+        nav.build(current_zone_->player_start_position().y);
+        current_zone_->load_enemies(
+            ps, game_scene, render_pipeline.get(), zone_objects, player_, camera_, nav, *scripts_, *jobs_);
+
+        LOG_INFO(
+            "zone",
+            "loaded {} in {}ms (preloaded: {})",
+            current_zone_->name(),
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - load_start)
+                .count(),
+            preloaded);
+    }
+
+    auto objects = sorted_objects(persistent_objects_, zone_objects);
 
     // lighting setup
+
     game_scene->set_ambient_light({0.5f, 0.5f, 0.5f, 1.0f});
     auto *light = game_scene->create_light<iris::PointLight>(iris::Vector3{10.0f}, iris::Colour{10.0f, 10.0f, 10.0f});
     game_scene->create_light<iris::DirectionalLight>(iris::Vector3{0.0, -1.0f, 0.0f}, true);
@@ -163,18 +298,21 @@ void Game::run_zone()
         iris::RigidBodyType::GHOST);
     portal_destination_ = destination;
 
+    // start loading the zone the portal leads to, so walking through it doesn't stall
+    preloader_->preload(zones_->zone(portal_destination_));
+
     // optional debug draw
     if (config_->bool_option(ConfigOption::PHYSICS_DEBUG_DRAW))
     {
         ps->enable_debug_draw(game_scene);
     }
 
-    const auto *game_sky_box = iris::Root::texture_manager().create(
+    const auto *game_sky_box = AssetCache::instance().sky_box(
         iris::Colour{0.275f, 0.51f, 0.796f}, iris::Colour{0.5f, 0.5f, 0.5f}, 2048u, 2048u);
 
     // setup the game pass
     auto *game_pass = render_pipeline->create_render_pass(game_scene);
-    game_pass->camera = camera->camera();
+    game_pass->camera = camera_->camera();
     game_pass->colour_target = rt;
     game_pass->sky_box = game_sky_box;
     game_pass->post_processing_description = {
@@ -189,123 +327,468 @@ void Game::run_zone()
 
     window_->set_render_pipeline(std::move(render_pipeline));
 
+    // record state of everything that moves, so rendering can interpolate between ticks
+    TransformInterpolator interpolator{};
+    for (auto *object : objects)
+    {
+        object->add_interpolated(interpolator);
+    }
+
+    // gameplay runs at a fixed rate regardless of frame rate
+    const auto tick = tick_length();
+    auto last_tick = std::chrono::steady_clock::now();
+
     // setup game loop
     iris::Looper looper{
         0ms,
-        16ms,
-        [ps, player, this](auto, std::chrono::microseconds delta) {
-            if (state_ == GameState::PLAYING)
-            {
-                // update physics
-                ps->step(std::chrono::duration_cast<std::chrono::milliseconds>(delta));
+        tick,
+        [&](std::chrono::microseconds elapsed, std::chrono::microseconds delta) {
+            // undo any interpolation, so the simulation only sees the results of the last tick
+            interpolator.begin_tick();
 
-                // check if we are intersecting portal
-                for (const auto &contact : ps->contacts(portal_))
-                {
-                    if (contact.contact == player->rigid_body())
-                    {
-                        auto destination =
-                            std::find_if(std::begin(zone_loaders_), std::end(zone_loaders_), [this](auto &element) {
-                                return element->name() == portal_destination_;
-                            });
-
-                        iris::ensure(destination != std::cend(zone_loaders_), "missing zone");
-
-                        // set next zone which will get loaded when we return
-                        next_zone_ = destination->get();
-                    }
-                }
+            {
+                TRINKET_PROFILE_SCOPE("input");
+                input_handler_->update(elapsed);
+                broker.flush();
             }
 
+            simulate(objects, ps, player_, cells, ai, nav, elapsed, delta);
+
+            // move light with player
+            light->set_position(player_->position() + iris::Vector3{0.0f, 10.0f, 0.0f});
+
+            interpolator.end_tick();
+            last_tick = std::chrono::steady_clock::now();
+
             return true;
         },
-        [&](std::chrono::microseconds elapsed, auto) {
-            // move light with player
-            light->set_position(player->position() + iris::Vector3{0.0f, 10.0f, 0.0f});
+        [&](auto, auto) {
+            // render between the last two ticks, based on how far we are through the current one
+            const auto since_tick = std::chrono::duration<float>(std::chrono::steady_clock::now() - last_tick);
+            const auto alpha = std::clamp(since_tick / std::chrono::duration<float>(tick), 0.0f, 1.0f);
+            interpolator.interpolate(alpha);
 
-            // update game objects
-            for (auto &object : objects)
             {
-                object->update(elapsed);
+                TRINKET_PROFILE_SCOPE("render");
+                window_->render();
             }
 
-            window_->render();
+            preloader_->update(preload_budget);
+
+            broker.end_frame();
+            Profiler::instance().end_frame();
 
             return running_ && (next_zone_ == nullptr);
         }};
 
     state_ = GameState::PLAYING;
     looper.run();
+
+    LOG_INFO("input", "merged {} input events", input_handler_->merged_events());
+
+    cells.log_stats();
+    ai.log_stats();
+    nav.log_stats();
+
+    // anything still queued may reference objects from this zone, which are about to be destroyed
+    broker.clear();
+
+    AssetCache::instance().end_zone();
+}
+
+void Game::run_headless_zone()
+{
+    // as run_zone but without a window, rendering, camera or input, the loop is our own so it can outpace real time
+
+    auto *ps = iris::Root::physics_manager().create_physics_system();
+    auto &broker = MessageBroker::instance();
+
+    if (player_ == nullptr)
+    {
+        create_persistent_objects(0u, 0u);
+    }
+
+    player_->bind(nullptr, ps, current_zone_->player_start_position(), nullptr);
+
+    if (state_ == GameState::DEAD)
+    {
+        player_->respawn();
+    }
+
+    // load data from zone
+    std::vector<std::unique_ptr<GameObject>> zone_objects{};
+    auto cells = create_cells(nullptr);
+    auto ai = create_ai_scheduler();
+    auto nav = create_nav_grid();
+    {
+        TRINKET_PROFILE_SCOPE("zone_load");
+        current_zone_->load_static_geometry(ps, nullptr, nullptr, cells, nav, *jobs_);
+        cells.build();
+        nav.build(current_zone_->player_start_position().y);
+        current_zone_->load_enemies(ps, nullptr, nullptr, zone_objects, player_, nullptr, nav, *scripts_, *jobs_);
+    }
+
+    auto objects = sorted_objects(persistent_objects_, zone_objects);
+
+    // setup portal
+    const auto [portal_transform, destination] = current_zone_->portal();
+    portal_ = ps->create_rigid_body(
+        portal_transform.translation(),
+        ps->create_box_collision_shape(portal_transform.scale()),
+        iris::RigidBodyType::GHOST);
+    portal_destination_ = destination;
+
+    const auto tick = tick_length();
+    const auto realtime = config_->bool_option(ConfigOption::HEADLESS_REALTIME);
+    const std::uint64_t max_ticks = config_->uint32_option(ConfigOption::HEADLESS_TICKS);
+
+    std::chrono::microseconds elapsed{0};
+    std::uint64_t zone_ticks = 0u;
+
+    const auto start = std::chrono::steady_clock::now();
+    auto next_tick = start;
+    auto report_start = start;
+    auto report_ticks = zone_ticks;
+
+    state_ = GameState::PLAYING;
+
+    while (running_ && (next_zone_ == nullptr))
+    {
+        // a tick budget of 0 means run until quit
+        if ((max_ticks != 0u) && (simulated_ticks_ >= max_ticks))
+        {
+            running_ = false;
+            break;
+        }
+
+        if (realtime)
+        {
+            std::this_thread::sleep_until(next_tick);
+            next_tick += tick;
+        }
+
+        simulate(objects, ps, player_, cells, ai, nav, elapsed, tick);
+        broker.end_frame();
+        Profiler::instance().end_frame();
+
+        elapsed += tick;
+        ++zone_ticks;
+        ++simulated_ticks_;
+
+        // report simulation rate once a second
+        if (const auto now = std::chrono::steady_clock::now(); (now - report_start) >= 1s)
+        {
+            const auto seconds = std::chrono::duration<double>(now - report_start).count();
+            LOG_INFO("headless", "{:.1f} ticks/s", static_cast<double>(zone_ticks - report_ticks) / seconds);
+
+            report_start = now;
+            report_ticks = zone_ticks;
+        }
+    }
+
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO(
+        "headless",
+        "zone {} simulated {} ticks ({:.1f}s of game time) in {:.2f}s",
+        current_zone_->name(),
+        zone_ticks,
+        std::chrono::duration<double>(elapsed).count(),
+        seconds);
+
+    cells.log_stats();
+    ai.log_stats();
+    nav.log_stats();
+
+    // anything still queued may reference objects from this zone, which are about to be destroyed
+    broker.clear();
+
+    AssetCache::instance().end_zone();
 }
 
-void Game::handle_message(MessageType message_type, const std::any &data)
+void Game::create_persistent_objects(std::uint32_t hud_width, std::uint32_t hud_height)
 {
-    switch (message_type)
+    persistent_objects_.emplace_back(std::make_unique<Player>(headless_));
+    player_ = static_cast<Player *>(persistent_objects_.back().get());
+
+    if (!headless_)
     {
-        case MessageType::QUIT: running_ = false; break;
-        case MessageType::KEY_PRESS:
+        input_handler_ = std::make_unique<InputHandler>(window_, config_->bool_option(ConfigOption::COALESCE_INPUT));
+
+        persistent_objects_.emplace_back(
+            std::make_unique<ThirdPersonCamera>(player_, window_->width(), window_->height()));
+        camera_ = static_cast<ThirdPersonCamera *>(persistent_objects_.back().get());
+
+        persistent_objects_.emplace_back(std::make_unique<HUD>(100.0f, hud_width, hud_height));
+        hud_ = static_cast<HUD *>(persistent_objects_.back().get());
+    }
+
+    persistent_objects_.emplace_back(std::make_unique<QuestManager>());
+    auto *qm = static_cast<QuestManager *>(persistent_objects_.back().get());
+    qm->create<KillEnemyQuest>(2u);
+}
+
+void Game::simulate(
+    std::vector<GameObject *> &objects,
+    iris::PhysicsSystem *ps,
+    const Player *player,
+    ZoneCells &cells,
+    AiScheduler &ai,
+    NavGrid &nav,
+    std::chrono::microseconds elapsed,
+    std::chrono::microseconds delta)
+{
+    auto &broker = MessageBroker::instance();
+
+    if (state_ == GameState::PLAYING)
+    {
+        TRINKET_PROFILE_SCOPE("physics");
+
+        // update physics, carrying any fraction of a millisecond over so it keeps pace with simulation time
+        physics_remainder_ += delta;
+        const auto step = std::chrono::duration_cast<std::chrono::milliseconds>(physics_remainder_);
+        physics_remainder_ -= step;
+        ps->step(step);
+
+        // check if we are intersecting portal
+        for (const auto &contact : ps->contacts(portal_))
         {
-            const auto key = std::any_cast<iris::KeyboardEvent>(data);
+            if (contact.contact == player->rigid_body())
+            {
+                // set next zone which will get loaded when we return
+                next_zone_ = zones_->zone(portal_destination_);
+            }
+        }
+
+        broker.flush();
+    }
+
+    cells.update(player->position(), (camera_ == nullptr) ? nullptr : camera_->camera());
+    nav.update(player->position());
 
-            // pressing R has two outcomes
-            //   player alive - reload current scene (useful for testing)
-            //   player dead  - reload starting scene
-            if ((key.key == iris::Key::R) && (key.state == iris::KeyState::DOWN))
+    {
+        TRINKET_PROFILE_SCOPE("update");
+
+        // objects which are far from the player and out of view aren't updated
+        active_objects_.clear();
+        for (auto *object : objects)
+        {
+            if (const auto position = object->cull_position(); position)
             {
-                if (state_ == GameState::PLAYING)
+                const auto active = cells.is_active(*position);
+                object->set_active(active);
+
+                if (!active)
                 {
-                    next_zone_ = current_zone_;
+                    continue;
                 }
-                else
-                {
-                    const auto starting_zone_name = config_->string_option(ConfigOption::STARTING_ZONE);
+            }
 
-                    auto starting_zone = std::find_if(
-                        std::begin(zone_loaders_), std::end(zone_loaders_), [&starting_zone_name](auto &element) {
-                            return element->name() == starting_zone_name;
-                        });
+            active_objects_.emplace_back(object);
+        }
 
-                    next_zone_ = starting_zone->get();
-                }
+        cells.record_objects(active_objects_.size(), objects.size());
+
+        // active enemies further from the player are updated less often
+        ai.schedule(active_objects_, player->position());
+
+        update_objects(active_objects_, ai, elapsed);
+        broker.flush();
+    }
+}
+
+ZoneCells Game::create_cells(iris::Scene *scene) const
+{
+    const auto cell_size = config_->uint32_option(ConfigOption::CELL_SIZE);
+    iris::ensure(cell_size > 0u, "cell size must be greater than 0");
+
+    return {
+        scene,
+        static_cast<float>(cell_size),
+        config_->uint32_option(ConfigOption::ACTIVE_CELL_RADIUS),
+        config_->bool_option(ConfigOption::CELL_CULLING)};
+}
+
+std::chrono::microseconds Game::tick_length() const
+{
+    const auto tick_rate = config_->uint32_option(ConfigOption::TICK_RATE);
+    iris::ensure((tick_rate > 0u) && (tick_rate <= 1000u), "tick rate must be in range [1, 1000]");
+
+    // whole milliseconds would make e.g. 60Hz tick at 62.5Hz
+    return std::chrono::microseconds{1'000'000u / tick_rate};
+}
+
+AiScheduler Game::create_ai_scheduler() const
+{
+    const auto near_distance = config_->uint32_option(ConfigOption::AI_NEAR_DISTANCE);
+    const auto far_distance = config_->uint32_option(ConfigOption::AI_FAR_DISTANCE);
+    iris::ensure(near_distance <= far_distance, "ai near distance must not be greater than far distance");
+
+    const auto mid_interval = config_->uint32_option(ConfigOption::AI_MID_INTERVAL);
+    iris::ensure(mid_interval > 0u, "ai mid interval must be greater than 0");
+
+    return {
+        static_cast<float>(near_distance),
+        static_cast<float>(far_distance),
+        mid_interval,
+        std::chrono::microseconds{config_->uint32_option(ConfigOption::AI_FAR_BUDGET_US)},
+        config_->bool_option(ConfigOption::AI_LOD)};
+}
+
+NavGrid Game::create_nav_grid() const
+{
+    const auto cell_size = config_->uint32_option(ConfigOption::NAV_CELL_SIZE);
+    iris::ensure(cell_size > 0u, "nav cell size must be greater than 0");
+
+    return {
+        static_cast<float>(cell_size),
+        static_cast<float>(config_->uint32_option(ConfigOption::NAV_MAX_DISTANCE)),
+        config_->bool_option(ConfigOption::NAVIGATION)};
+}
+
+void Game::update_objects(std::vector<GameObject *> &objects, AiScheduler &ai, std::chrono::microseconds elapsed)
+{
+    auto &broker = MessageBroker::instance();
+
+    auto begin = std::begin(objects);
+    while (begin != std::end(objects))
+    {
+        if (!(*begin)->is_parallel())
+        {
+            {
+                TRINKET_PROFILE_TYPE(**begin);
+                (*begin)->update(elapsed);
             }
-            break;
+
+            ++begin;
+            continue;
         }
-        case MessageType::PLAYER_DIED:
+
+        // find the run of parallel objects in this phase
+        const auto phase = (*begin)->update_phase();
+        const auto end = std::find_if(begin, std::end(objects), [phase](const auto &object) {
+            return !object->is_parallel() || (object->update_phase() != phase);
+        });
+        const auto count = static_cast<std::size_t>(std::distance(begin, end));
+
+        if (captured_messages_.size() < count)
         {
-            state_ = GameState::DEAD;
+            captured_messages_.resize(count);
+        }
+
+        // objects prepare in parallel and capture anything they publish, replaying in object order means subscribers
+        // get the same messages in the same order regardless of how the work was scheduled
+        const auto start = std::chrono::steady_clock::now();
+        jobs_->parallel_for(count, 1u, [this, begin, elapsed](std::size_t index) {
+            MessageBroker::set_capture(&captured_messages_[index]);
+            TRINKET_PROFILE_TYPE(**(begin + index));
+            (*(begin + index))->prepare(elapsed);
+            MessageBroker::set_capture(nullptr);
+        });
 
-            // create death screen
+        // the rest of each update touches the engine (physics and rendering), which isn't thread safe
+        for (std::size_t i = 0u; i < count; ++i)
+        {
+            broker.replay(captured_messages_[i]);
 
-            auto pipeline = std::make_unique<iris::RenderPipeline>(window_->width(), window_->height());
-            auto *scene = pipeline->create_scene();
+            TRINKET_PROFILE_TYPE(**(begin + i));
+            (*(begin + i))->update(elapsed);
+        }
 
-            scene->create_entity<iris::SingleEntity>(
-                nullptr,
-                iris::Root::mesh_manager().sprite({}),
-                iris::Transform{
-                    {}, {}, {static_cast<float>(window_->width()), static_cast<float>(window_->height()), 1.0f}});
+        if (phase == UpdatePhase::AI)
+        {
+            ai.record_update_time(std::chrono::steady_clock::now() - start, count);
+        }
 
-            auto *text = iris::text_factory::create("Arial", 72, "you died 😢", {1.0f, 1.0f, 1.0f, 1.0f});
-            auto *rg = pipeline->create_render_graph();
-            rg->render_node()->set_colour_input(rg->create<iris::TextureNode>(text));
-            scene->create_entity<iris::SingleEntity>(
-                rg,
-                iris::Root::mesh_manager().sprite({1.0f, 1.0f, 1.0f}),
-                iris::Transform{
-                    {0.0f, 0.0f, 1.0f},
-                    {},
-                    {static_cast<float>(text->width()), static_cast<float>(text->height()), 1.0f}},
-                true);
+        begin = end;
+    }
+}
 
-            static const iris::Camera camera{iris::CameraType::ORTHOGRAPHIC, window_->width(), window_->height()};
+void Game::handle_message(const Message<MessageType::QUIT> &)
+{
+    running_ = false;
+}
 
-            auto *pass = pipeline->create_render_pass(scene);
-            pass->camera = &camera;
+void Game::handle_message(const Message<MessageType::KEY_PRESS> &message)
+{
+    const auto &key = message.data;
 
-            window_->set_render_pipeline(std::move(pipeline));
-            break;
+    // pressing R has two outcomes
+    //   player alive - reload current scene (useful for testing)
+    //   player dead  - reload starting scene
+    if ((key.key == iris::Key::R) && (key.state == iris::KeyState::DOWN))
+    {
+        if (state_ == GameState::PLAYING)
+        {
+            next_zone_ = current_zone_;
         }
-        default: break;
+        else
+        {
+            next_zone_ = zones_->zone(config_->string_option(ConfigOption::STARTING_ZONE));
+        }
+    }
+    else if ((key.key == iris::Key::F1) && (key.state == iris::KeyState::DOWN))
+    {
+        // toggle recording message stats
+        auto &broker = MessageBroker::instance();
+        broker.set_stats_enabled(!broker.stats_enabled());
+    }
+    else if ((key.key == iris::Key::F2) && (key.state == iris::KeyState::DOWN))
+    {
+        // dump message stats recorded so far
+        MessageBroker::instance().stats().write_json(message_stats_path);
+    }
+    else if ((key.key == iris::Key::F3) && (key.state == iris::KeyState::DOWN))
+    {
+        // toggle profiler
+        auto &profiler = Profiler::instance();
+        profiler.set_enabled(!profiler.enabled());
+    }
+    else if ((key.key == iris::Key::F4) && (key.state == iris::KeyState::DOWN))
+    {
+        // dump profile recorded so far
+        Profiler::instance().write_trace(profile_trace_path);
+        Profiler::instance().log_summary();
+    }
+}
+
+void Game::handle_message(const Message<MessageType::PLAYER_DIED> &)
+{
+    state_ = GameState::DEAD;
+
+    if (headless_)
+    {
+        // nobody to press a key on the death screen, so just restart the zone
+        LOG_INFO("headless", "player died, restarting zone");
+        next_zone_ = current_zone_;
+        return;
     }
+
+    // create death screen
+
+    auto pipeline = std::make_unique<iris::RenderPipeline>(window_->width(), window_->height());
+    auto *scene = pipeline->create_scene();
+
+    scene->create_entity<iris::SingleEntity>(
+        nullptr,
+        iris::Root::mesh_manager().sprite({}),
+        iris::Transform{{}, {}, {static_cast<float>(window_->width()), static_cast<float>(window_->height()), 1.0f}});
+
+    auto *text = iris::text_factory::create("Arial", 72, "you died 😢", {1.0f, 1.0f, 1.0f, 1.0f});
+    auto *rg = pipeline->create_render_graph();
+    rg->render_node()->set_colour_input(rg->create<iris::TextureNode>(text));
+    scene->create_entity<iris::SingleEntity>(
+        rg,
+        iris::Root::mesh_manager().sprite({1.0f, 1.0f, 1.0f}),
+        iris::Transform{
+            {0.0f, 0.0f, 1.0f}, {}, {static_cast<float>(text->width()), static_cast<float>(text->height()), 1.0f}},
+        true);
+
+    static const iris::Camera camera{iris::CameraType::ORTHOGRAPHIC, window_->width(), window_->height()};
+
+    auto *pass = pipeline->create_render_pass(scene);
+    pass->camera = &camera;
+
+    window_->set_render_pipeline(std::move(pipeline));
+}
+
 }
-}
\ No newline at end of file
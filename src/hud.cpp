@@ -6,7 +6,6 @@
 
 #include "hud.h"
 
-#include <any>
 #include <chrono>
 #include <cstdint>
 
@@ -25,62 +24,77 @@
 #include "iris/graphics/window_manager.h"
 
 #include "game_object.h"
+#include "message_data.h"
 #include "message_type.h"
 #include "subscriber.h"
 
 namespace trinket
 {
 
-HUD::HUD(float starting_health, std::uint32_t width, std::uint32_t height, iris::Scene *scene)
+HUD::HUD(float starting_health, std::uint32_t width, std::uint32_t height)
     : health_bar_(nullptr)
     , level_progress_bar_(nullptr)
     , camera_(iris::CameraType::ORTHOGRAPHIC, width, height)
     , width_(width)
     , height_(height)
     , starting_health_(starting_health)
+    , health_(starting_health)
+    , level_progress_(0.0f)
+{
+    subscribe<MessageType::PLAYER_HEALTH_CHANGE>(this);
+    subscribe<MessageType::LEVEL_PROGRESS>(this);
+}
+
+void HUD::bind(iris::Scene *scene)
 {
     const auto offset = 20.0f;
 
     health_bar_ = scene->create_entity<iris::SingleEntity>(
         nullptr,
         iris::Root::mesh_manager().sprite({1.0f, 0.0f, 0.0f}),
-        iris::Transform({0.0f, height - offset, 1.0f}, {}, {width - 40.0f, 10.0f, 0.0f}));
+        iris::Transform({0.0f, height_ - offset, 1.0f}, {}, {width_ - 40.0f, 10.0f, 0.0f}));
 
     level_progress_bar_ = scene->create_entity<iris::SingleEntity>(
         nullptr,
         iris::Root::mesh_manager().sprite({1.0f, 1.0f, 0.0f}),
-        iris::Transform({0.0f, offset - height, 1.0f}, {}, {0.0f, 10.0f, 0.0f}));
+        iris::Transform({0.0f, offset - height_, 1.0f}, {}, {0.0f, 10.0f, 0.0f}));
 
-    subscribe(MessageType::PLAYER_HEALTH_CHANGE);
-    subscribe(MessageType::LEVEL_PROGRESS);
+    // restore state carried over from the last zone
+    update_health_bar();
+    update_level_progress_bar();
 }
 
 void HUD::update(std::chrono::microseconds)
 {
 }
 
-void HUD::handle_message(MessageType message_type, const std::any &data)
+void HUD::handle_message(const Message<MessageType::PLAYER_HEALTH_CHANGE> &message)
+{
+    health_ = message.data;
+    update_health_bar();
+}
+
+UpdatePhase HUD::update_phase() const
+{
+    return UpdatePhase::PRESENTATION;
+}
+
+void HUD::handle_message(const Message<MessageType::LEVEL_PROGRESS> &message)
+{
+    level_progress_ = message.data;
+    update_level_progress_bar();
+}
+
+void HUD::update_health_bar()
+{
+    const auto bar_width = (width_ - 4.0f) * (health_ / starting_health_);
+    health_bar_->set_scale({bar_width, 10.0f, 1.0f});
+}
+
+void HUD::update_level_progress_bar()
 {
-    switch (message_type)
-    {
-        case MessageType::PLAYER_HEALTH_CHANGE:
-        {
-            const auto remaining_health = std::any_cast<float>(data);
-            const auto bar_width = (width_ - 4.0f) * (remaining_health / starting_health_);
-
-            health_bar_->set_scale({bar_width, 10.0f, 1.0f});
-            break;
-        }
-        case MessageType::LEVEL_PROGRESS:
-        {
-            const auto progress = std::any_cast<float>(data);
-            const auto bar_width = (width_ - 40.0f) * progress;
-
-            level_progress_bar_->set_scale({bar_width, 10.0f, 1.0f});
-            break;
-        }
-        default: break;
-    }
+    const auto bar_width = (width_ - 40.0f) * level_progress_;
+    level_progress_bar_->set_scale({bar_width, 10.0f, 1.0f});
 }
 
 }
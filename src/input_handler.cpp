@@ -7,49 +7,109 @@
 #include "input_handler.h"
 
 #include <chrono>
+#include <cstdint>
 
 #include "iris/events/event.h"
+#include "iris/events/mouse_event.h"
+#include "iris/events/scroll_wheel_event.h"
 #include "iris/log/log.h"
 
+#include "message_data.h"
 #include "message_type.h"
 #include "publisher.h"
 
 namespace trinket
 {
 
-InputHandler::InputHandler(iris::Window *window)
+InputHandler::InputHandler(iris::Window *window, bool coalesce)
     : window_(window)
+    , coalesce_(coalesce)
+    , merged_events_(0u)
 {
 }
 
 void InputHandler::update(std::chrono::microseconds)
 {
+    // accumulated movement, only used when coalescing
+    auto mouse_delta_x = 0.0f;
+    auto mouse_delta_y = 0.0f;
+    auto scroll_delta_y = 0.0f;
+    std::uint32_t mouse_events = 0u;
+    std::uint32_t scroll_events = 0u;
+
     auto event = window_->pump_event();
     while (event)
     {
+        const auto timestamp = std::chrono::steady_clock::now();
+
         if (event->is_key(iris::Key::ESCAPE) || event->is_quit())
         {
-            publish(MessageType::QUIT, {});
+            publish<MessageType::QUIT>();
         }
         else if (event->is_mouse())
         {
-            publish(MessageType::MOUSE_MOVE, {event->mouse()});
+            const auto mouse = event->mouse();
+
+            if (coalesce_)
+            {
+                mouse_delta_x += mouse.delta_x;
+                mouse_delta_y += mouse.delta_y;
+                ++mouse_events;
+            }
+            else
+            {
+                publish<MessageType::MOUSE_MOVE>(mouse);
+            }
         }
         else if (event->is_key())
         {
-            publish(MessageType::KEY_PRESS, {event->key()});
+            const auto key = event->key();
+            publish<MessageType::KEY_PRESS>({key.key, key.state, timestamp});
         }
         else if (event->is_mouse_button())
         {
-            publish(MessageType::MOUSE_BUTTON_PRESS, {event->mouse_button()});
+            const auto mouse_button = event->mouse_button();
+            publish<MessageType::MOUSE_BUTTON_PRESS>({mouse_button.button, mouse_button.state, timestamp});
         }
         else if (event->is_scroll_wheel())
         {
-            publish(MessageType::SCROLL_WHEEL, {event->scroll_wheel()});
+            const auto scroll = event->scroll_wheel();
+
+            if (coalesce_)
+            {
+                scroll_delta_y += scroll.delta_y;
+                ++scroll_events;
+            }
+            else
+            {
+                publish<MessageType::SCROLL_WHEEL>(scroll);
+            }
         }
 
         event = window_->pump_event();
     }
+
+    if (mouse_events != 0u)
+    {
+        publish<MessageType::MOUSE_MOVE>(iris::MouseEvent{mouse_delta_x, mouse_delta_y});
+        merged_events_ += mouse_events - 1u;
+    }
+
+    if (scroll_events != 0u)
+    {
+        publish<MessageType::SCROLL_WHEEL>(iris::ScrollWheelEvent{scroll_delta_y});
+        merged_events_ += scroll_events - 1u;
+    }
+}
+
+UpdatePhase InputHandler::update_phase() const
+{
+    return UpdatePhase::INPUT;
+}
+
+std::uint64_t InputHandler::merged_events() const
+{
+    return merged_events_;
 }
 
 }
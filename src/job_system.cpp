@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "job_system.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace trinket
+{
+
+JobSystem::JobSystem(std::uint32_t worker_count)
+    : queues_()
+    , queued_jobs_(0u)
+    , stop_(false)
+    , wake_mutex_()
+    , wake_()
+    , workers_()
+{
+    if (worker_count == 0u)
+    {
+        worker_count = std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+    }
+
+    // one queue per worker plus one for the calling thread
+    for (auto i = 0u; i <= worker_count; ++i)
+    {
+        queues_.emplace_back(std::make_unique<WorkQueue>());
+    }
+
+    for (auto i = 1u; i <= worker_count; ++i)
+    {
+        workers_.emplace_back([this, i] { worker_loop(i); });
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::scoped_lock lock{wake_mutex_};
+        stop_ = true;
+    }
+
+    wake_.notify_all();
+
+    for (auto &worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+void JobSystem::parallel_for(std::size_t count, std::size_t batch_size, const std::function<void(std::size_t)> &job)
+{
+    if (count == 0u)
+    {
+        return;
+    }
+
+    batch_size = std::max(batch_size, std::size_t{1u});
+    const auto job_count = (count + batch_size - 1u) / batch_size;
+    std::atomic<std::size_t> remaining{job_count};
+
+    // count jobs before queuing them so a worker can never take a job before it has been counted
+    {
+        std::scoped_lock lock{wake_mutex_};
+        queued_jobs_ += job_count;
+    }
+
+    // deal jobs out round robin, threads that finish early will steal from the others
+    for (std::size_t i = 0u; i < job_count; ++i)
+    {
+        const auto begin = i * batch_size;
+        const Job queued_job{&job, begin, std::min(begin + batch_size, count), &remaining};
+
+        auto &queue = *queues_[i % queues_.size()];
+        std::scoped_lock lock{queue.mutex};
+        queue.jobs.push_back(queued_job);
+    }
+
+    wake_.notify_all();
+
+    // help out until every job has finished, once there is nothing left to take the remaining jobs are already running
+    // on workers so we just wait for them
+    while (remaining.load(std::memory_order_acquire) != 0u)
+    {
+        if (const auto next = take_job(0u); next)
+        {
+            run_job(*next);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+std::uint32_t JobSystem::worker_count() const
+{
+    return static_cast<std::uint32_t>(workers_.size());
+}
+
+void JobSystem::worker_loop(std::size_t index)
+{
+    for (;;)
+    {
+        if (const auto next = take_job(index); next)
+        {
+            run_job(*next);
+            continue;
+        }
+
+        std::unique_lock lock{wake_mutex_};
+        wake_.wait(lock, [this] { return stop_ || (queued_jobs_ != 0u); });
+
+        if (stop_)
+        {
+            return;
+        }
+    }
+}
+
+std::optional<JobSystem::Job> JobSystem::take_job(std::size_t index)
+{
+    // take newest job from our own queue, it's most likely to be hot in the cache
+    {
+        auto &queue = *queues_[index];
+        std::scoped_lock lock{queue.mutex};
+
+        if (!queue.jobs.empty())
+        {
+            const auto job = queue.jobs.back();
+            queue.jobs.pop_back();
+            --queued_jobs_;
+            return job;
+        }
+    }
+
+    // steal oldest job from another thread, starting with our neighbour so thieves spread out
+    for (std::size_t i = 1u; i < queues_.size(); ++i)
+    {
+        auto &queue = *queues_[(index + i) % queues_.size()];
+        std::scoped_lock lock{queue.mutex};
+
+        if (!queue.jobs.empty())
+        {
+            const auto job = queue.jobs.front();
+            queue.jobs.pop_front();
+            --queued_jobs_;
+            return job;
+        }
+    }
+
+    return std::nullopt;
+}
+
+void JobSystem::run_job(const Job &job)
+{
+    for (auto i = job.begin; i < job.end; ++i)
+    {
+        (*job.function)(i);
+    }
+
+    job.remaining->fetch_sub(1u, std::memory_order_release);
+}
+
+}
@@ -6,9 +6,9 @@
 
 #include "kill_enemy_quest.h"
 
-#include <any>
 #include <cstdint>
 
+#include "message_data.h"
 #include "message_type.h"
 #include "quest.h"
 #include "subscriber.h"
@@ -20,7 +20,7 @@ KillEnemyQuest::KillEnemyQuest(std::uint32_t enemy_count)
     : enemy_count_(enemy_count)
     , complete_(false)
 {
-    subscribe(MessageType::KILLED_ENEMY);
+    subscribe<MessageType::KILLED_ENEMY>(this);
 }
 
 bool KillEnemyQuest::is_complete() const
@@ -33,23 +33,15 @@ std::uint32_t KillEnemyQuest::completion_xp() const
     return 50u;
 }
 
-void KillEnemyQuest::handle_message(MessageType message_type, const std::any &data)
+void KillEnemyQuest::handle_message(const Message<MessageType::KILLED_ENEMY> &)
 {
-    switch (message_type)
+    if (!complete_)
     {
-        case MessageType::KILLED_ENEMY:
+        --enemy_count_;
+        if (enemy_count_ == 0u)
         {
-            if (!complete_)
-            {
-                --enemy_count_;
-                if (enemy_count_ == 0u)
-                {
-                    complete_ = true;
-                }
-            }
-            break;
+            complete_ = true;
         }
-        default: break;
     }
 }
 
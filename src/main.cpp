@@ -4,21 +4,24 @@
 //                 https://www.boost.org/LICENSE_1_0.txt)                     //
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <chrono>
+#include <filesystem>
 #include <iostream>
 #include <memory>
-#include <vector>
+#include <string_view>
 
 #include "iris/core/resource_loader.h"
 #include "iris/core/root.h"
 #include "iris/core/start.h"
 #include "iris/iris_version.h"
+#include "iris/log/log.h"
 #include "iris/physics/physics_manager.h"
 
 #include "game.h"
 #include "yaml_config.h"
-#include "yaml_zone_loader.h"
+#include "zone_registry.h"
 
-void go(int, char **)
+void go(int argc, char **argv)
 {
     // sanity check we're using the right version of iris for development
     static_assert(IRIS_VERSION_MAJOR == 3);
@@ -27,9 +30,19 @@ void go(int, char **)
 
     std::cout << "hello trinket" << std::endl;
 
-    iris::ResourceLoader::instance().set_root_directory("assets");
+    const std::filesystem::path resource_root{"assets"};
+    iris::ResourceLoader::instance().set_root_directory(resource_root.string());
     auto config = std::make_unique<trinket::YamlConfig>("config.yml");
 
+    // allow headless mode to be enabled without editing the config
+    for (auto i = 1; i < argc; ++i)
+    {
+        if (std::string_view{argv[i]} == "--headless")
+        {
+            config->set_bool_option(trinket::ConfigOption::HEADLESS, true);
+        }
+    }
+
     // set graphics api if one was set
     if (const auto &graphics_api = config->string_option(trinket::ConfigOption::GRAPHICS_API);
         graphics_api != "default")
@@ -37,15 +50,23 @@ void go(int, char **)
         iris::Root::set_graphics_api(graphics_api);
     }
 
-    // create a loader for all zones in config
-    std::vector<std::unique_ptr<trinket::ZoneLoader>> zone_loaders{};
-    for (const auto &zone_file : config->string_array_option(trinket::ConfigOption::ZONE_LOADERS))
-    {
-        zone_loaders.emplace_back(std::make_unique<trinket::YamlZoneLoader>(zone_file));
-    }
+    // index all zones in config, they are only parsed when first needed
+    const auto registry_start = std::chrono::steady_clock::now();
+
+    auto zones = std::make_unique<trinket::ZoneRegistry>(
+        resource_root,
+        config->string_map_option(trinket::ConfigOption::ZONE_LOADERS),
+        config->bool_option(trinket::ConfigOption::MERGE_STATIC_BODIES));
+
+    LOG_INFO(
+        "zone",
+        "registered {} zones in {}us",
+        zones->size(),
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - registry_start)
+            .count());
 
     // kick off game
-    trinket::Game game{std::move(config), std::move(zone_loaders)};
+    trinket::Game game{std::move(config), std::move(zones)};
     game.run();
 }
 
@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "mapped_file.h"
+
+#include <cstddef>
+#include <filesystem>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "iris/core/error_handling.h"
+
+namespace trinket
+{
+
+#if defined(_WIN32)
+
+MappedFile::MappedFile(const std::filesystem::path &path)
+    : data_(nullptr)
+    , size_(0u)
+    , file_(INVALID_HANDLE_VALUE)
+    , mapping_(nullptr)
+{
+    // the destructor doesn't run if we throw, so release whatever has been opened so far
+    try
+    {
+        file_ = ::CreateFileW(
+            path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        iris::ensure(file_ != INVALID_HANDLE_VALUE, "could not open file");
+
+        LARGE_INTEGER size{};
+        iris::ensure(::GetFileSizeEx(file_, &size) != 0, "could not get file size");
+        size_ = static_cast<std::size_t>(size.QuadPart);
+        iris::ensure(size_ != 0u, "cannot map empty file");
+
+        mapping_ = ::CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        iris::ensure(mapping_ != nullptr, "could not create file mapping");
+
+        data_ = static_cast<const std::byte *>(::MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        iris::ensure(data_ != nullptr, "could not map file");
+    }
+    catch (...)
+    {
+        release();
+        throw;
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    release();
+}
+
+void MappedFile::release()
+{
+    if (data_ != nullptr)
+    {
+        ::UnmapViewOfFile(data_);
+    }
+
+    if (mapping_ != nullptr)
+    {
+        ::CloseHandle(mapping_);
+    }
+
+    if (file_ != INVALID_HANDLE_VALUE)
+    {
+        ::CloseHandle(file_);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path &path)
+    : data_(nullptr)
+    , size_(0u)
+{
+    const auto fd = ::open(path.c_str(), O_RDONLY);
+    iris::ensure(fd != -1, "could not open file");
+
+    struct stat info
+    {
+    };
+    const auto stat_result = ::fstat(fd, &info);
+    size_ = static_cast<std::size_t>(info.st_size);
+
+    auto *mapping =
+        ((stat_result == 0) && (size_ != 0u)) ? ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+
+    // the mapping keeps its own reference to the file
+    ::close(fd);
+
+    iris::ensure(mapping != MAP_FAILED, "could not map file");
+    data_ = static_cast<const std::byte *>(mapping);
+}
+
+MappedFile::~MappedFile()
+{
+    ::munmap(const_cast<std::byte *>(data_), size_);
+}
+
+#endif
+
+const std::byte *MappedFile::data() const
+{
+    return data_;
+}
+
+std::size_t MappedFile::size() const
+{
+    return size_;
+}
+
+}
@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "material_cache.h"
+
+#include <cstdint>
+#include <string>
+
+#include "iris/core/root.h"
+#include "iris/core/vector3.h"
+#include "iris/graphics/render_graph/arithmetic_node.h"
+#include "iris/graphics/render_graph/render_graph.h"
+#include "iris/graphics/render_graph/texture_node.h"
+#include "iris/graphics/render_graph/value_node.h"
+#include "iris/graphics/render_graph/vertex_node.h"
+#include "iris/graphics/render_pipeline.h"
+#include "iris/graphics/texture_manager.h"
+
+#include "asset_cache.h"
+
+namespace trinket
+{
+
+MaterialCache::MaterialCache(iris::RenderPipeline *render_pipeline)
+    : render_pipeline_(render_pipeline)
+    , materials_()
+    , requests_(0u)
+{
+}
+
+iris::RenderGraph *MaterialCache::material(
+    const std::string &texture,
+    float texture_scale,
+    const std::string &normal,
+    bool nearest)
+{
+    ++requests_;
+
+    // the sampler only applies to unscaled textures, so don't let it split otherwise identical materials
+    const auto uses_nearest = nearest && (texture_scale == 0.0f);
+
+    auto [material, inserted] = materials_.try_emplace({texture, texture_scale, normal, uses_nearest}, nullptr);
+    if (!inserted)
+    {
+        return material->second;
+    }
+
+    auto *render_graph = render_pipeline_->create_render_graph();
+    iris::TextureNode *texture_node = nullptr;
+
+    if (texture_scale != 0.0f)
+    {
+        // the node loads scaled textures by name, holding them in the cache keeps them loaded across zones so the node
+        // finds them already loaded
+        AssetCache::instance().texture(texture);
+
+        texture_node = render_graph->create<iris::TextureNode>(
+            texture,
+            iris::TextureUsage::IMAGE,
+            nullptr,
+            iris::UVSource::NODE,
+            render_graph->create<iris::ArithmeticNode>(
+                render_graph->create<iris::VertexNode>(iris::VertexDataType::UV),
+                render_graph->create<iris::ValueNode<iris::Vector3>>(iris::Vector3{texture_scale}),
+                iris::ArithmeticOperator::MULTIPLY));
+    }
+    else
+    {
+        texture_node = render_graph->create<iris::TextureNode>(
+            AssetCache::instance().texture(texture, uses_nearest ? nearest_sampler() : nullptr));
+    }
+
+    render_graph->render_node()->set_colour_input(texture_node);
+
+    if (!normal.empty())
+    {
+        auto *normal_node = render_graph->create<iris::TextureNode>(AssetCache::instance().texture(normal));
+        render_graph->render_node()->set_normal_input(normal_node);
+    }
+
+    material->second = render_graph;
+
+    return render_graph;
+}
+
+std::uint32_t MaterialCache::graphs() const
+{
+    return static_cast<std::uint32_t>(materials_.size());
+}
+
+std::uint32_t MaterialCache::requests() const
+{
+    return requests_;
+}
+
+const iris::Sampler *MaterialCache::nearest_sampler()
+{
+    static const auto *sampler = iris::Root::texture_manager().create(iris::SamplerDescriptor{
+        .minification_filter = iris::SamplerFilter::NEAREST,
+        .magnification_filter = iris::SamplerFilter::NEAREST,
+        .uses_mips = false,
+        .mip_filter = iris::SamplerFilter::LINEAR});
+
+    return sampler;
+}
+
+}
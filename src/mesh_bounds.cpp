@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "mesh_bounds.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include "iris/core/vector3.h"
+#include "iris/graphics/mesh.h"
+#include "iris/graphics/vertex_data.h"
+
+namespace trinket
+{
+
+std::tuple<iris::Vector3, iris::Vector3> mesh_bounds(const iris::Mesh *mesh)
+{
+    const auto &vertices = mesh->vertices();
+    auto min_point = vertices.empty() ? iris::Vector3{} : vertices.front().position;
+    auto max_point = min_point;
+
+    for (const auto &vertex : vertices)
+    {
+        min_point = {
+            std::min(min_point.x, vertex.position.x),
+            std::min(min_point.y, vertex.position.y),
+            std::min(min_point.z, vertex.position.z)};
+        max_point = {
+            std::max(max_point.x, vertex.position.x),
+            std::max(max_point.y, vertex.position.y),
+            std::max(max_point.z, vertex.position.z)};
+    }
+
+    return {min_point, max_point};
+}
+
+}
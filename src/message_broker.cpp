@@ -6,21 +6,29 @@
 
 #include "message_broker.h"
 
-#include <any>
-#include <set>
-#include <unordered_map>
+#include <array>
+#include <cstddef>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-#include "iris/core/error_handling.h"
-
 #include "message_type.h"
-#include "subscriber.h"
+#include "subscription_channel.h"
 
 namespace trinket
 {
 
+thread_local CapturedMessages *MessageBroker::capture_ = nullptr;
+
 MessageBroker::MessageBroker()
     : subscriptions_()
+    , queues_()
+    , queued_(false)
+    , stats_()
+    , stats_enabled_(false)
+    , owner_(std::this_thread::get_id())
 {
 }
 
@@ -30,26 +38,148 @@ MessageBroker &MessageBroker::instance()
     return instance;
 }
 
-void MessageBroker::subscribe(Subscriber *subscriber, MessageType message_type)
+void MessageBroker::unsubscribe(const SubscriptionHandle &handle)
+{
+    // find the channel for the runtime message type and remove the subscription from it
+    std::apply(
+        [&handle](auto &...channels) {
+            const auto remove = [&handle](auto &channel) {
+                if (std::remove_cvref_t<decltype(channel)>::type == handle.type)
+                {
+                    channel.remove(handle);
+                }
+            };
+
+            (remove(channels), ...);
+        },
+        subscriptions_);
+}
+
+void MessageBroker::set_capture(CapturedMessages *captured)
 {
-    subscriptions_[message_type].emplace_back(subscriber);
+    capture_ = captured;
 }
 
-void MessageBroker::unsubscribe(Subscriber *subscriber, MessageType message_type)
+void MessageBroker::replay(CapturedMessages &captured)
 {
-    auto &subs = subscriptions_[message_type];
-    subs.erase(std::remove(std::begin(subs), std::end(subs), subscriber), std::end(subs));
+    // messages of each type are stored in order, so walking the recorded types and taking the next message of each
+    // publishes them in the order they were captured
+    std::array<std::size_t, message_type_count> next{};
+
+    for (const auto message_type : captured.order_)
+    {
+        std::apply(
+            [this, message_type, &next](auto &...buffers) {
+                const auto publish_next = [this, message_type, &next](auto &buffer) {
+                    constexpr auto type = std::remove_cvref_t<decltype(buffer)>::type;
+
+                    if (type == message_type)
+                    {
+                        const auto &[key, data] = buffer.messages[next[static_cast<std::size_t>(type)]++];
+                        publish<type>(key, data);
+                    }
+                };
+
+                (publish_next(buffers), ...);
+            },
+            captured.buffers_);
+    }
+
+    captured.clear();
 }
 
-void MessageBroker::publish(MessageType message_type, const std::any &data) const
+void MessageBroker::set_queued(bool queued)
 {
-    if (const auto subs = subscriptions_.find(message_type); subs != std::cend(subscriptions_))
+    // deliver anything outstanding so no messages are lost when switching to immediate mode
+    if (queued_ && !queued)
     {
-        for (auto *subscriber : subs->second)
-        {
-            subscriber->handle_message(message_type, data);
-        }
+        flush();
     }
+
+    queued_ = queued;
+}
+
+bool MessageBroker::is_queued() const
+{
+    return queued_;
+}
+
+void MessageBroker::flush()
+{
+    std::apply(
+        [this](auto &...queues) {
+            // swap all buffers before delivering anything, that way anything published by a subscriber lands in an
+            // empty pending buffer and gets delivered next flush (this also keeps both allocations around for the next
+            // frame)
+            (std::swap(queues.pending, queues.draining), ...);
+
+            // collect anything posted from other threads
+            const auto collect_posted = [](auto &queue) {
+                while (auto message = queue.posted.try_pop())
+                {
+                    queue.draining.push_back(std::move(*message));
+                }
+            };
+
+            (collect_posted(queues), ...);
+
+            auto *stats = stats_enabled_ ? &stats_ : nullptr;
+
+            const auto drain = [this, stats](auto &queue) {
+                constexpr auto type = std::remove_cvref_t<decltype(queue)>::type;
+
+                for (const auto &[key, data] : queue.draining)
+                {
+                    channel<type>().dispatch(key, data, stats);
+                }
+
+                queue.draining.clear();
+            };
+
+            (drain(queues), ...);
+        },
+        queues_);
+}
+
+void MessageBroker::clear()
+{
+    std::apply(
+        [](auto &...queues) {
+            (queues.pending.clear(), ...);
+            (queues.draining.clear(), ...);
+
+            const auto discard_posted = [](auto &queue) {
+                while (queue.posted.try_pop())
+                {
+                }
+            };
+
+            (discard_posted(queues), ...);
+        },
+        queues_);
+}
+
+void MessageBroker::set_stats_enabled(bool enabled)
+{
+    stats_enabled_ = enabled;
+}
+
+bool MessageBroker::stats_enabled() const
+{
+    return stats_enabled_;
+}
+
+void MessageBroker::end_frame()
+{
+    if (stats_enabled_)
+    {
+        stats_.end_frame();
+    }
+}
+
+const MessageStats &MessageBroker::stats() const
+{
+    return stats_;
 }
 
 }
@@ -0,0 +1,228 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "message_stats.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+
+#include "iris/core/error_handling.h"
+
+#include "message_type.h"
+#include "type_name.h"
+
+namespace
+{
+
+/**
+ * Combine a message type and class id into a single key.
+ *
+ * @param message_type
+ *   Type of message.
+ *
+ * @param class_id
+ *   Id of subscriber class.
+ *
+ * @returns
+ *   Key for handler statistics.
+ */
+std::uint64_t handler_key(trinket::MessageType message_type, std::uint32_t class_id)
+{
+    return (static_cast<std::uint64_t>(message_type) << 32u) | class_id;
+}
+
+/**
+ * Estimate a percentile from a latency histogram. As buckets are powers of two this returns the upper bound of the
+ * bucket the percentile falls in.
+ *
+ * @param buckets
+ *   Histogram buckets.
+ *
+ * @param calls
+ *   Total number of entries in histogram.
+ *
+ * @param percentile
+ *   Percentile to estimate, in range [0, 1].
+ *
+ * @returns
+ *   Estimated percentile in nanoseconds.
+ */
+template <class T>
+std::uint64_t percentile_ns(const T &buckets, std::uint64_t calls, double percentile)
+{
+    const auto target = static_cast<std::uint64_t>(static_cast<double>(calls) * percentile);
+    std::uint64_t seen = 0u;
+
+    for (std::size_t i = 0u; i < buckets.size(); ++i)
+    {
+        seen += buckets[i];
+        if (seen > target)
+        {
+            return std::uint64_t{1u} << (i + 1u);
+        }
+    }
+
+    return std::uint64_t{1u} << buckets.size();
+}
+
+}
+
+namespace trinket
+{
+
+MessageStats::MessageStats()
+    : types_()
+    , handlers_()
+    , class_ids_()
+    , class_names_()
+    , frames_(0u)
+{
+}
+
+std::uint32_t MessageStats::register_class(const std::type_info &type)
+{
+    const auto [id, inserted] = class_ids_.try_emplace(type, static_cast<std::uint32_t>(class_names_.size()));
+
+    if (inserted)
+    {
+        class_names_.emplace_back(type_name(type));
+    }
+
+    return id->second;
+}
+
+void MessageStats::record_dispatch(MessageType message_type, std::uint32_t fan_out)
+{
+    auto &stats = types_[static_cast<std::size_t>(message_type)];
+
+    ++stats.publishes;
+    ++stats.frame_publishes;
+    stats.total_fan_out += fan_out;
+    stats.max_fan_out = std::max(stats.max_fan_out, fan_out);
+}
+
+void MessageStats::record_handler(MessageType message_type, std::uint32_t class_id, std::chrono::nanoseconds duration)
+{
+    auto &stats = handlers_[handler_key(message_type, class_id)];
+
+    const auto ns = static_cast<std::uint64_t>(std::max(duration.count(), std::chrono::nanoseconds::rep{1}));
+    const auto bucket = std::min(static_cast<std::size_t>(std::bit_width(ns) - 1), histogram_buckets - 1u);
+
+    ++stats.buckets[bucket];
+    ++stats.calls;
+    stats.total += duration;
+    stats.max = std::max(stats.max, duration);
+}
+
+void MessageStats::end_frame()
+{
+    for (auto &stats : types_)
+    {
+        stats.max_frame_publishes = std::max(stats.max_frame_publishes, stats.frame_publishes);
+        stats.frame_publishes = 0u;
+    }
+
+    ++frames_;
+}
+
+void MessageStats::reset()
+{
+    types_ = {};
+    handlers_.clear();
+    frames_ = 0u;
+}
+
+void MessageStats::write_json(const std::string &path) const
+{
+    std::ofstream out{path};
+    iris::ensure(out.is_open(), "could not open message stats file");
+
+    const auto frames = std::max(frames_, std::uint64_t{1u});
+
+    out << "{\n";
+    out << "  \"frames\": " << frames_ << ",\n";
+    out << "  \"message_types\": [";
+
+    auto first_type = true;
+
+    for (std::size_t i = 0u; i < types_.size(); ++i)
+    {
+        const auto &stats = types_[i];
+        const auto message_type = static_cast<MessageType>(i);
+
+        out << (first_type ? "\n" : ",\n");
+        first_type = false;
+
+        out << "    {\n";
+        out << "      \"type\": \"" << to_string(message_type) << "\",\n";
+        out << "      \"publishes\": " << stats.publishes << ",\n";
+        out << "      \"publishes_per_frame\": " << static_cast<double>(stats.publishes) / static_cast<double>(frames)
+            << ",\n";
+        out << "      \"max_publishes_per_frame\": " << stats.max_frame_publishes << ",\n";
+        out << "      \"mean_fan_out\": "
+            << (stats.publishes == 0u
+                    ? 0.0
+                    : static_cast<double>(stats.total_fan_out) / static_cast<double>(stats.publishes))
+            << ",\n";
+        out << "      \"max_fan_out\": " << stats.max_fan_out << ",\n";
+        out << "      \"handlers\": [";
+
+        auto first_handler = true;
+
+        for (std::uint32_t class_id = 0u; class_id < class_names_.size(); ++class_id)
+        {
+            const auto handler = handlers_.find(handler_key(message_type, class_id));
+            if (handler == std::cend(handlers_))
+            {
+                continue;
+            }
+
+            const auto &[buckets, calls, total, max] = handler->second;
+
+            out << (first_handler ? "\n" : ",\n");
+            first_handler = false;
+
+            out << "        {\n";
+            out << "          \"subscriber\": \"" << class_names_[class_id] << "\",\n";
+            out << "          \"calls\": " << calls << ",\n";
+            out << "          \"mean_ns\": " << (total.count() / static_cast<std::int64_t>(calls)) << ",\n";
+            out << "          \"max_ns\": " << max.count() << ",\n";
+            out << "          \"p50_ns\": " << percentile_ns(buckets, calls, 0.5) << ",\n";
+            out << "          \"p99_ns\": " << percentile_ns(buckets, calls, 0.99) << ",\n";
+            out << "          \"histogram_ns\": {";
+
+            // only write populated buckets, keyed on their upper bound
+            auto first_bucket = true;
+            for (std::size_t bucket = 0u; bucket < buckets.size(); ++bucket)
+            {
+                if (buckets[bucket] != 0u)
+                {
+                    out << (first_bucket ? "" : ", ") << "\"" << (std::uint64_t{1u} << (bucket + 1u))
+                        << "\": " << buckets[bucket];
+                    first_bucket = false;
+                }
+            }
+
+            out << "}\n";
+            out << "        }";
+        }
+
+        out << (first_handler ? "]\n" : "\n      ]\n");
+        out << "    }";
+    }
+
+    out << "\n  ]\n";
+    out << "}\n";
+}
+
+}
@@ -0,0 +1,181 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+// Offline tool which stress tests the MpscQueue used to post messages across threads, and measures its throughput.
+//
+// usage: trinket_mpsc_bench
+//
+// First several producer threads push numbered values through a tiny queue, so it is constantly full and wrapping,
+// whilst the main thread pops them and checks none are lost, duplicated or reordered (values from a single producer
+// must arrive in the order they were pushed). Then, for each producer count, the number of messages per second that can
+// be pushed through a queue the size of the MessageBroker's posted queues is printed.
+//
+// This doesn't depend on iris, so it can be built with ThreadSanitizer (configure with -DTRINKET_TSAN=ON) to check the
+// queue's memory ordering. Exits with a non-zero code if the stress test fails.
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "mpsc_queue.h"
+
+namespace
+{
+
+/** Producer counts to measure. */
+constexpr std::array<std::uint32_t, 4u> producer_counts{1u, 2u, 4u, 8u};
+
+/** Number of producers for the stress test. */
+constexpr std::uint32_t stress_producer_count = 8u;
+
+/** Number of values each producer pushes in the stress test. */
+constexpr std::uint32_t stress_push_count = 200000u;
+
+/** Capacity of the stress test queue, small so producers regularly find it full. */
+constexpr std::size_t stress_capacity = 16u;
+
+/** Total number of values to push for each throughput run, split between the producers. */
+constexpr std::uint32_t throughput_push_count = 4000000u;
+
+/** Capacity of the throughput queue, the same as the MessageBroker's posted queues. */
+constexpr std::size_t throughput_capacity = 256u;
+
+/**
+ * Internal struct for a value pushed through the queue.
+ */
+struct Value
+{
+    /** Index of producer which pushed the value. */
+    std::uint32_t producer;
+
+    /** Number of values the producer had pushed before this one. */
+    std::uint32_t sequence;
+};
+
+/**
+ * Push values through a queue from several threads whilst popping them on the calling thread.
+ *
+ * @param producer_count
+ *   Number of producer threads.
+ *
+ * @param push_count
+ *   Number of values each producer pushes.
+ *
+ * @param on_pop
+ *   Called with every popped value.
+ */
+template <std::size_t Capacity, class F>
+void run(std::uint32_t producer_count, std::uint32_t push_count, F on_pop)
+{
+    trinket::MpscQueue<Value, Capacity> queue{};
+    std::vector<std::thread> producers{};
+
+    for (std::uint32_t producer = 0u; producer < producer_count; ++producer)
+    {
+        producers.emplace_back([&queue, producer, push_count] {
+            for (std::uint32_t sequence = 0u; sequence < push_count; ++sequence)
+            {
+                queue.push({.producer = producer, .sequence = sequence});
+            }
+        });
+    }
+
+    const auto total = static_cast<std::uint64_t>(producer_count) * push_count;
+
+    for (std::uint64_t popped = 0u; popped < total;)
+    {
+        if (const auto value = queue.try_pop(); value)
+        {
+            on_pop(*value);
+            ++popped;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    for (auto &producer : producers)
+    {
+        producer.join();
+    }
+}
+
+/**
+ * Run the stress test.
+ *
+ * @returns
+ *   True if every value was popped exactly once and in order for its producer, otherwise false.
+ */
+bool stress()
+{
+    std::vector<std::uint32_t> next(stress_producer_count, 0u);
+    auto passed = true;
+
+    run<stress_capacity>(stress_producer_count, stress_push_count, [&next, &passed](const Value &value) {
+        if ((value.producer >= next.size()) || (value.sequence != next[value.producer]))
+        {
+            passed = false;
+            return;
+        }
+
+        ++next[value.producer];
+    });
+
+    for (const auto count : next)
+    {
+        passed = passed && (count == stress_push_count);
+    }
+
+    return passed;
+}
+
+/**
+ * Measure the throughput of the queue.
+ *
+ * @param producer_count
+ *   Number of producer threads.
+ *
+ * @returns
+ *   Time taken to push and pop all values.
+ */
+std::chrono::steady_clock::duration throughput(std::uint32_t producer_count)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    run<throughput_capacity>(producer_count, throughput_push_count / producer_count, [](const Value &) {});
+
+    return std::chrono::steady_clock::now() - start;
+}
+
+}
+
+int main()
+{
+    const auto passed = stress();
+    std::cout << "stress " << stress_producer_count << " producers, " << stress_push_count << " values each: "
+              << (passed ? "passed" : "FAILED") << std::endl;
+
+    if (!passed)
+    {
+        return 1;
+    }
+
+    for (const auto producer_count : producer_counts)
+    {
+        const auto seconds = std::chrono::duration_cast<std::chrono::duration<double>>(throughput(producer_count));
+        const auto pushed = static_cast<double>((throughput_push_count / producer_count) * producer_count);
+
+        std::cout << producer_count << " producers: " << pushed / seconds.count() / 1000000.0
+                  << " million messages per second" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,388 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "native_ai.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string_view>
+
+#include "iris/core/error_handling.h"
+#include "iris/core/quaternion.h"
+#include "iris/core/vector3.h"
+
+#include "enemy_ai.h"
+#include "enemy_decision.h"
+#include "nav_grid.h"
+#include "profiler.h"
+
+using namespace std::literals::chrono_literals;
+
+namespace
+{
+
+/** Distance within which an enemy attacks the player. */
+constexpr float attack_distance = 2.5f;
+
+/** Time between attacks. */
+constexpr std::chrono::microseconds attack_rate = 500ms;
+
+/**
+ * Implementation of EnemyAi for a single enemy in a NativeAi.
+ */
+class NativeEnemyAi : public trinket::EnemyAi
+{
+  public:
+    /**
+     * Construct a new NativeEnemyAi.
+     *
+     * @param ai
+     *   Native AI enemy belongs to.
+     *
+     * @param index
+     *   Index of enemy.
+     */
+    NativeEnemyAi(trinket::NativeAi &ai, std::size_t index)
+        : ai_(ai)
+        , index_(index)
+    {
+    }
+
+    /**
+     * Decide what the enemy does this tick.
+     *
+     * @param position
+     *   Unused, positions are recorded by moved.
+     *
+     * @param player_position
+     *   Unused, the player is tested against at update.
+     *
+     * @param steering
+     *   Unused, the navigation grid is looked up at update.
+     *
+     * @param elapsed
+     *   Unused, time is only needed at update.
+     *
+     * @param health
+     *   Health of enemy.
+     *
+     * @returns
+     *   Decision made at last update.
+     */
+    trinket::EnemyDecision tick(
+        const iris::Vector3 &,
+        const iris::Vector3 &,
+        const iris::Vector3 &,
+        std::chrono::microseconds,
+        float health) override
+    {
+        return ai_.tick(index_, health);
+    }
+
+    /**
+     * Record where the enemy moved to.
+     *
+     * @param position
+     *   New position of enemy.
+     */
+    void moved(const iris::Vector3 &position) override
+    {
+        ai_.moved(index_, position);
+    }
+
+  private:
+    /** Native AI enemy belongs to. */
+    trinket::NativeAi &ai_;
+
+    /** Index of enemy. */
+    std::size_t index_;
+};
+
+/**
+ * Normalise a vector, leaving it unchanged if it has no length.
+ *
+ * @param x
+ *   X component.
+ *
+ * @param y
+ *   Y component.
+ *
+ * @param z
+ *   Z component.
+ *
+ * @returns
+ *   Normalised vector.
+ */
+iris::Vector3 normalise(float x, float y, float z)
+{
+    const auto length = std::sqrt((x * x) + (y * y) + (z * z));
+    return (length == 0.0f) ? iris::Vector3{x, y, z} : iris::Vector3{x / length, y / length, z / length};
+}
+
+}
+
+namespace trinket
+{
+
+NativeAi::NativeAi()
+    : generator_(std::random_device{}())
+    , x_()
+    , y_()
+    , z_()
+    , target_x_()
+    , target_z_()
+    , min_x_()
+    , max_x_()
+    , min_z_()
+    , max_z_()
+    , walk_x_()
+    , walk_y_()
+    , walk_z_()
+    , facing_x_()
+    , facing_z_()
+    , next_attack_()
+    , state_()
+    , next_animation_()
+    , find_target_()
+    , change_animation_()
+    , has_attacked_()
+    , moved_()
+    , sees_player_()
+    , near_target_()
+    , in_reach_()
+    , player_in_bounds_()
+{
+}
+
+std::unique_ptr<EnemyAi> NativeAi::create(
+    std::string_view script,
+    const iris::Vector3 &position,
+    const iris::Vector3 &bounds_min,
+    const iris::Vector3 &bounds_max)
+{
+    iris::expect(script == "native:basic", "unknown native ai");
+
+    const auto index = size();
+
+    x_.emplace_back(position.x);
+    y_.emplace_back(position.y);
+    z_.emplace_back(position.z);
+    target_x_.emplace_back(0.0f);
+    target_z_.emplace_back(0.0f);
+    min_x_.emplace_back(bounds_min.x);
+    max_x_.emplace_back(bounds_max.x);
+    min_z_.emplace_back(bounds_min.z);
+    max_z_.emplace_back(bounds_max.z);
+    walk_x_.emplace_back(-1.0f);
+    walk_y_.emplace_back(0.0f);
+    walk_z_.emplace_back(0.0f);
+    facing_x_.emplace_back(0.0f);
+    facing_z_.emplace_back(1.0f);
+    next_attack_.emplace_back(0us);
+
+    // enemies start out walking, so there's no need to enter the state and change animation
+    state_.emplace_back(State::ROAMING);
+    next_animation_.emplace_back(Animation::WALK);
+    find_target_.emplace_back(1u);
+    change_animation_.emplace_back(0u);
+    has_attacked_.emplace_back(0u);
+    moved_.emplace_back(1u);
+    sees_player_.emplace_back(0u);
+    near_target_.emplace_back(0u);
+    in_reach_.emplace_back(0u);
+    player_in_bounds_.emplace_back(0u);
+
+    return std::make_unique<NativeEnemyAi>(*this, index);
+}
+
+void NativeAi::update(const iris::Vector3 &player_position, const NavGrid &nav, std::chrono::microseconds elapsed)
+{
+    TRINKET_PROFILE_SCOPE("native_ai");
+
+    const auto count = size();
+
+    // pick new roaming targets first, so the tests below are against them
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        if ((moved_[i] != 0u) && (state_[i] == State::ROAMING) && (find_target_[i] != 0u))
+        {
+            target_x_[i] = std::uniform_real_distribution<float>{min_x_[i], max_x_[i]}(generator_);
+            target_z_[i] = std::uniform_real_distribution<float>{min_z_[i], max_z_[i]}(generator_);
+            facing_x_[i] = target_x_[i] - x_[i];
+            facing_z_[i] = target_z_[i] - z_[i];
+            find_target_[i] = 0u;
+        }
+    }
+
+    const auto player_x = player_position.x;
+    const auto player_y = player_position.y;
+    const auto player_z = player_position.z;
+
+    // distance and vision tests for every enemy at once, kept branch free (and working on squared values rather than
+    // taking roots and angles) so they vectorise, results are words rather than bytes as byte stores may alias the
+    // inputs
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        const auto to_player_x = player_x - x_[i];
+        const auto to_player_y = player_y - y_[i];
+        const auto to_player_z = player_z - z_[i];
+        const auto to_target_x = target_x_[i] - x_[i];
+        const auto to_target_y = -y_[i];
+        const auto to_target_z = target_z_[i] - z_[i];
+
+        const auto player_distance_sq =
+            (to_player_x * to_player_x) + (to_player_y * to_player_y) + (to_player_z * to_player_z);
+        const auto target_distance_sq =
+            (to_target_x * to_target_x) + (to_target_y * to_target_y) + (to_target_z * to_target_z);
+        const auto dot = (to_target_x * to_player_x) + (to_target_y * to_player_y) + (to_target_z * to_player_z);
+
+        // angle between the target and player directions is under 45 degrees, i.e. its cosine is over 1 / sqrt(2)
+        sees_player_[i] = static_cast<std::uint32_t>(
+            (dot > 0.0f) & ((dot * dot) > (0.5f * target_distance_sq * player_distance_sq)));
+        near_target_[i] = static_cast<std::uint32_t>(target_distance_sq < 1.0f);
+        in_reach_[i] = static_cast<std::uint32_t>(player_distance_sq < (attack_distance * attack_distance));
+        player_in_bounds_[i] = static_cast<std::uint32_t>(
+            (player_x >= min_x_[i]) & (player_x <= max_x_[i]) & (player_z >= min_z_[i]) & (player_z <= max_z_[i]));
+    }
+
+    // step the state machines, only enemies which moved (i.e. weren't culled) since the last update
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        if (moved_[i] == 0u)
+        {
+            continue;
+        }
+
+        moved_[i] = 0u;
+
+        if (state_[i] == State::ROAMING)
+        {
+            const auto walk = normalise(target_x_[i] - x_[i], -y_[i], target_z_[i] - z_[i]);
+            walk_x_[i] = walk.x;
+            walk_y_[i] = walk.y;
+            walk_z_[i] = walk.z;
+
+            if (near_target_[i] != 0u)
+            {
+                find_target_[i] = 1u;
+            }
+
+            if (sees_player_[i] != 0u)
+            {
+                enter(i, State::HUNTING, elapsed);
+            }
+        }
+        else if (state_[i] == State::HUNTING)
+        {
+            const auto walk = nav.direction({x_[i], y_[i], z_[i]}, player_position);
+            walk_x_[i] = walk.x;
+            walk_y_[i] = walk.y;
+            walk_z_[i] = walk.z;
+            facing_x_[i] = player_x - x_[i];
+            facing_z_[i] = player_z - z_[i];
+
+            if (player_in_bounds_[i] == 0u)
+            {
+                enter(i, State::ROAMING, elapsed);
+            }
+            else if (in_reach_[i] != 0u)
+            {
+                enter(i, State::ATTACKING, elapsed);
+            }
+        }
+        else
+        {
+            walk_x_[i] = 0.0f;
+            walk_y_[i] = 0.0f;
+            walk_z_[i] = 0.0f;
+            facing_x_[i] = player_x - x_[i];
+            facing_z_[i] = player_z - z_[i];
+
+            if (in_reach_[i] == 0u)
+            {
+                enter(i, State::HUNTING, elapsed);
+            }
+            else if (elapsed > next_attack_[i])
+            {
+                has_attacked_[i] = 1u;
+                next_attack_[i] = elapsed + attack_rate;
+            }
+        }
+    }
+}
+
+EnemyDecision NativeAi::tick(std::size_t index, float health)
+{
+    if (health <= 0.0f)
+    {
+        walk_x_[index] = 0.0f;
+        walk_y_[index] = 0.0f;
+        walk_z_[index] = 0.0f;
+
+        return {.walk_direction = {}, .orientation = orientation(index), .animation = "Death_Back", .attack = false};
+    }
+
+    EnemyDecision decision{
+        .walk_direction = {walk_x_[index], walk_y_[index], walk_z_[index]},
+        .orientation = orientation(index),
+        .animation = {},
+        .attack = has_attacked_[index] != 0u};
+
+    if (change_animation_[index] != 0u)
+    {
+        decision.animation = (next_animation_[index] == Animation::WALK) ? "Walk" : "Bite_Front";
+        change_animation_[index] = 0u;
+    }
+
+    has_attacked_[index] = 0u;
+
+    return decision;
+}
+
+void NativeAi::moved(std::size_t index, const iris::Vector3 &position)
+{
+    x_[index] = position.x;
+    y_[index] = position.y;
+    z_[index] = position.z;
+    moved_[index] = 1u;
+}
+
+std::size_t NativeAi::size() const
+{
+    return state_.size();
+}
+
+void NativeAi::enter(std::size_t index, State state, std::chrono::microseconds elapsed)
+{
+    state_[index] = state;
+
+    if (state == State::ROAMING)
+    {
+        next_animation_[index] = Animation::WALK;
+        change_animation_[index] = 1u;
+    }
+    else if (state == State::HUNTING)
+    {
+        find_target_[index] = 1u;
+    }
+    else
+    {
+        next_animation_[index] = Animation::BITE_FRONT;
+        change_animation_[index] = 1u;
+        next_attack_[index] = elapsed + attack_rate;
+    }
+}
+
+iris::Quaternion NativeAi::orientation(std::size_t index) const
+{
+    return {{0.0f, 1.0f, 0.0f}, std::atan2(facing_x_[index], facing_z_[index])};
+}
+
+}
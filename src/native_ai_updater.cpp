@@ -0,0 +1,41 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "native_ai_updater.h"
+
+#include <chrono>
+
+#include "native_ai.h"
+#include "nav_grid.h"
+#include "player.h"
+#include "update_phase.h"
+
+namespace trinket
+{
+
+NativeAiUpdater::NativeAiUpdater(const Player *player, const NavGrid &nav)
+    : ai_()
+    , player_(player)
+    , nav_(nav)
+{
+}
+
+void NativeAiUpdater::update(std::chrono::microseconds elapsed)
+{
+    ai_.update(player_->position(), nav_, elapsed);
+}
+
+UpdatePhase NativeAiUpdater::update_phase() const
+{
+    return UpdatePhase::AI;
+}
+
+NativeAi &NativeAiUpdater::ai()
+{
+    return ai_;
+}
+
+}
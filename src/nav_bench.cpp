@@ -0,0 +1,232 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+// Offline tool which measures the cost of navigation on a large dungeon.
+//
+// usage: trinket_nav_bench
+//
+// A square dungeon of rooms joined by doorways is generated and a navigation grid built from its walls (as a zone's
+// static bodies would be, see NavGrid). The player then walks across the dungeon one cell per tick, so every tick
+// searches a new flow field. The time taken to build the grid, the average cost of a search and of looking up a
+// direction are printed for each maximum search distance.
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "iris/core/quaternion.h"
+#include "iris/core/start.h"
+#include "iris/core/vector3.h"
+
+#include "nav_grid.h"
+
+namespace
+{
+
+/** Width and depth of the dungeon. */
+constexpr float dungeon_size = 1024.0f;
+
+/** Width and depth of a room, including its walls. */
+constexpr float room_size = 8.0f;
+
+/** Width of the doorway in the middle of each wall. */
+constexpr float doorway_width = 2.0f;
+
+/** Half the thickness of a wall. */
+constexpr float wall_half_thickness = 0.25f;
+
+/** Half the height of a wall. */
+constexpr float wall_half_height = 2.0f;
+
+/** Width and depth of a navigation cell. */
+constexpr float cell_size = 1.0f;
+
+/** Maximum search distances to measure, the last covers the whole dungeon. */
+constexpr std::array<float, 4u> max_distances{50.0f, 100.0f, 200.0f, dungeon_size * 4.0f};
+
+/** Number of cells the player walks, i.e. number of searches. */
+constexpr std::uint32_t search_count = 200u;
+
+/** Number of direction lookups to time. */
+constexpr std::size_t lookup_count = 1000000u;
+
+/**
+ * Internal struct for the results of a run.
+ */
+struct Result
+{
+    /** Time taken to add bodies and build the grid. */
+    std::chrono::steady_clock::duration build;
+
+    /** Time taken by all searches. */
+    std::chrono::steady_clock::duration searches;
+
+    /** Sum of cells reached by all searches. */
+    std::uint64_t reached;
+
+    /** Time taken by all lookups. */
+    std::chrono::steady_clock::duration lookups;
+};
+
+/**
+ * Add the walls of the dungeon to a grid. Every room has a wall along its minimum x and z edges (and the dungeon has
+ * walls along its maximum edges) with a doorway in the middle, so every room is reachable but paths have to wind.
+ *
+ * @param nav
+ *   Grid to add walls to.
+ */
+void add_walls(trinket::NavGrid &nav)
+{
+    const auto rooms = static_cast<std::size_t>(dungeon_size / room_size);
+    const auto segment = (room_size - doorway_width) * 0.5f;
+
+    for (std::size_t z = 0u; z <= rooms; ++z)
+    {
+        for (std::size_t x = 0u; x <= rooms; ++x)
+        {
+            const auto min_x = static_cast<float>(x) * room_size;
+            const auto min_z = static_cast<float>(z) * room_size;
+
+            // wall along x, either side of its doorway
+            if (x < rooms)
+            {
+                for (const auto offset : {segment * 0.5f, room_size - (segment * 0.5f)})
+                {
+                    nav.add(
+                        {min_x + offset, wall_half_height, min_z},
+                        {},
+                        {segment * 0.5f, wall_half_height, wall_half_thickness});
+                }
+            }
+
+            // wall along z
+            if (z < rooms)
+            {
+                for (const auto offset : {segment * 0.5f, room_size - (segment * 0.5f)})
+                {
+                    nav.add(
+                        {min_x, wall_half_height, min_z + offset},
+                        {},
+                        {wall_half_thickness, wall_half_height, segment * 0.5f});
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Build a grid for the dungeon, walk the player across it and look up directions.
+ *
+ * @param max_distance
+ *   Maximum search distance.
+ *
+ * @returns
+ *   Results of run.
+ */
+Result run(float max_distance)
+{
+    const auto build_start = std::chrono::steady_clock::now();
+
+    trinket::NavGrid nav{cell_size, max_distance, true};
+    add_walls(nav);
+    nav.build(1.0f);
+
+    const auto build_end = std::chrono::steady_clock::now();
+
+    // walk through the middle of the rooms, so the player never stands in a wall
+    const iris::Vector3 player_start{room_size * 0.5f, 1.0f, dungeon_size * 0.5f + room_size * 0.5f};
+    auto searches = std::chrono::steady_clock::duration{0};
+    std::uint64_t reached = 0u;
+
+    for (std::uint32_t i = 0u; i < search_count; ++i)
+    {
+        const auto player = player_start + iris::Vector3{static_cast<float>(i) * cell_size, 0.0f, 0.0f};
+
+        const auto search_start = std::chrono::steady_clock::now();
+        nav.update(player);
+        searches += std::chrono::steady_clock::now() - search_start;
+
+        reached += nav.reached();
+    }
+
+    // enemies anywhere in the dungeon, the random positions are made up front so only the lookups are timed
+    std::mt19937 generator{42u};
+    std::uniform_real_distribution<float> distribution{0.0f, dungeon_size};
+    std::vector<iris::Vector3> positions{};
+
+    for (std::size_t i = 0u; i < lookup_count; ++i)
+    {
+        positions.emplace_back(distribution(generator), 1.0f, distribution(generator));
+    }
+
+    const auto player = player_start + iris::Vector3{static_cast<float>(search_count - 1u) * cell_size, 0.0f, 0.0f};
+    iris::Vector3 sum{};
+
+    const auto lookup_start = std::chrono::steady_clock::now();
+
+    for (const auto &position : positions)
+    {
+        sum += nav.direction(position, player);
+    }
+
+    const auto lookup_end = std::chrono::steady_clock::now();
+
+    // use the result so the lookups can't be optimised away
+    if (sum.x == 12345.0f)
+    {
+        std::cout << std::endl;
+    }
+
+    return {
+        .build = build_end - build_start,
+        .searches = searches,
+        .reached = reached,
+        .lookups = lookup_end - lookup_start};
+}
+
+/**
+ * Print the results of a run.
+ *
+ * @param max_distance
+ *   Maximum search distance.
+ *
+ * @param result
+ *   Results of run.
+ */
+void print(float max_distance, const Result &result)
+{
+    std::cout << "max distance " << max_distance << ": built in "
+              << std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(result.build).count() << "ms, "
+              << std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(result.searches).count() /
+                     static_cast<double>(search_count)
+              << "ms per search (" << result.reached / search_count << " cells reached), "
+              << std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(result.lookups).count() /
+                     static_cast<double>(lookup_count)
+              << "ns per lookup" << std::endl;
+}
+
+void bench(int, char **)
+{
+    const auto cells = static_cast<std::size_t>(dungeon_size / cell_size);
+    std::cout << "dungeon: " << dungeon_size << "m square, " << cells << "x" << cells << " cells" << std::endl;
+
+    for (const auto max_distance : max_distances)
+    {
+        print(max_distance, run(max_distance));
+    }
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    iris::start(argc, argv, bench);
+    return 0;
+}
@@ -0,0 +1,391 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "nav_grid.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "iris/core/matrix4.h"
+#include "iris/core/quaternion.h"
+#include "iris/core/vector3.h"
+#include "iris/log/log.h"
+
+#include "profiler.h"
+
+namespace
+{
+
+/** Distance below the walk height a body must reach to block, so the ground doesn't. */
+constexpr float step_height = 0.5f;
+
+/** Distance above the walk height a body must start below to block, so anything overhead doesn't. */
+constexpr float clearance = 2.0f;
+
+/** Maximum number of cells along either side of the grid. */
+constexpr std::size_t max_cells = 4096u;
+
+/** Path cost of moving to an edge neighbour. */
+constexpr std::uint32_t straight_cost = 10u;
+
+/** Path cost of moving to a corner neighbour, straight_cost * sqrt(2) rounded. */
+constexpr std::uint32_t diagonal_cost = 14u;
+
+/** Flow of a cell with no path to the player. */
+constexpr std::uint8_t no_flow = 8u;
+
+/** Cost of a cell the search hasn't reached. */
+constexpr auto unreached = std::numeric_limits<std::uint32_t>::max();
+
+/** X offset of each neighbour, ordered around the cell so the opposite of neighbour i is (i + 4) % 8. */
+constexpr std::array<std::int32_t, 8u> neighbour_x{1, 1, 0, -1, -1, -1, 0, 1};
+
+/** Z offset of each neighbour. */
+constexpr std::array<std::int32_t, 8u> neighbour_z{0, 1, 1, 1, 0, -1, -1, -1};
+
+/** sqrt(2) / 2, for normalising the direction to a corner neighbour. */
+constexpr float half_root2 = 0.70710678f;
+
+/** X of the normalised direction to each neighbour, so lookups don't need a root. */
+constexpr std::array<float, 8u> direction_x{1.0f, half_root2, 0.0f, -half_root2, -1.0f, -half_root2, 0.0f, half_root2};
+
+/** Z of the normalised direction to each neighbour. */
+constexpr std::array<float, 8u> direction_z{0.0f, half_root2, 1.0f, half_root2, 0.0f, -half_root2, -1.0f, -half_root2};
+
+/**
+ * Normalise a vector, leaving it unchanged if it has no length.
+ *
+ * @param vector
+ *   Vector to normalise.
+ *
+ * @returns
+ *   Normalised vector.
+ */
+iris::Vector3 normalise(const iris::Vector3 &vector)
+{
+    const auto length = vector.magnitude();
+    return (length == 0.0f) ? vector : vector * (1.0f / length);
+}
+
+}
+
+namespace trinket
+{
+
+NavGrid::NavGrid(float cell_size, float max_distance, bool enabled)
+    : cell_size_(cell_size)
+    , max_cost_(static_cast<std::uint32_t>(std::ceil(max_distance / cell_size)) * straight_cost)
+    , enabled_(enabled)
+    , bodies_()
+    , min_x_(0.0f)
+    , min_z_(0.0f)
+    , width_(0u)
+    , depth_(0u)
+    , blocked_()
+    , cost_()
+    , flow_()
+    , visited_()
+    , buckets_()
+    , player_cell_()
+    , searches_(0u)
+    , search_time_(0)
+    , reached_total_(0u)
+{
+}
+
+bool NavGrid::enabled() const
+{
+    return enabled_;
+}
+
+void NavGrid::add(const iris::Vector3 &position, const iris::Quaternion &orientation, const iris::Vector3 &half_extents)
+{
+    if (!enabled_)
+    {
+        return;
+    }
+
+    // bounds of the rotated box are the bounds of its corners
+    const iris::Matrix4 rotation{orientation};
+    Bounds bounds{.min = position, .max = position};
+
+    for (auto corner = 0u; corner < 8u; ++corner)
+    {
+        const iris::Vector3 offset{
+            (corner & 1u) ? half_extents.x : -half_extents.x,
+            (corner & 2u) ? half_extents.y : -half_extents.y,
+            (corner & 4u) ? half_extents.z : -half_extents.z};
+        const auto point = position + (rotation * offset);
+
+        bounds.min = {
+            std::min(bounds.min.x, point.x),
+            std::min(bounds.min.y, point.y),
+            std::min(bounds.min.z, point.z)};
+        bounds.max = {
+            std::max(bounds.max.x, point.x),
+            std::max(bounds.max.y, point.y),
+            std::max(bounds.max.z, point.z)};
+    }
+
+    bodies_.emplace_back(bounds);
+}
+
+void NavGrid::build(float walk_height)
+{
+    TRINKET_PROFILE_SCOPE("nav_build");
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::erase_if(bodies_, [walk_height](const Bounds &bounds) {
+        return (bounds.max.y < (walk_height - step_height)) || (bounds.min.y > (walk_height + clearance));
+    });
+
+    player_cell_.reset();
+    visited_.clear();
+
+    if (bodies_.empty())
+    {
+        width_ = 0u;
+        depth_ = 0u;
+        return;
+    }
+
+    // size the grid to the blocking bodies, with a cell of space around them so enemies can walk round the outside
+    auto max_x = bodies_.front().max.x;
+    auto max_z = bodies_.front().max.z;
+    min_x_ = bodies_.front().min.x;
+    min_z_ = bodies_.front().min.z;
+
+    for (const auto &bounds : bodies_)
+    {
+        min_x_ = std::min(min_x_, bounds.min.x);
+        min_z_ = std::min(min_z_, bounds.min.z);
+        max_x = std::max(max_x, bounds.max.x);
+        max_z = std::max(max_z, bounds.max.z);
+    }
+
+    min_x_ -= cell_size_;
+    min_z_ -= cell_size_;
+    width_ = static_cast<std::size_t>(std::ceil((max_x - min_x_) / cell_size_)) + 1u;
+    depth_ = static_cast<std::size_t>(std::ceil((max_z - min_z_) / cell_size_)) + 1u;
+
+    if ((width_ > max_cells) || (depth_ > max_cells))
+    {
+        LOG_WARN("zone", "nav grid of {}x{} cells is too large, navigation disabled", width_, depth_);
+        width_ = 0u;
+        depth_ = 0u;
+        bodies_.clear();
+        return;
+    }
+
+    blocked_.assign(width_ * depth_, 0u);
+    cost_.assign(width_ * depth_, unreached);
+    flow_.assign(width_ * depth_, no_flow);
+
+    auto blocked = 0u;
+
+    for (const auto &bounds : bodies_)
+    {
+        const auto x0 = static_cast<std::size_t>((bounds.min.x - min_x_) / cell_size_);
+        const auto z0 = static_cast<std::size_t>((bounds.min.z - min_z_) / cell_size_);
+        const auto x1 = std::min(static_cast<std::size_t>((bounds.max.x - min_x_) / cell_size_), width_ - 1u);
+        const auto z1 = std::min(static_cast<std::size_t>((bounds.max.z - min_z_) / cell_size_), depth_ - 1u);
+
+        for (auto z = z0; z <= z1; ++z)
+        {
+            for (auto x = x0; x <= x1; ++x)
+            {
+                blocked += (blocked_[(z * width_) + x] == 0u) ? 1u : 0u;
+                blocked_[(z * width_) + x] = 1u;
+            }
+        }
+    }
+
+    LOG_INFO(
+        "zone",
+        "nav grid: {}x{} cells ({} blocked by {} bodies) in {}ms",
+        width_,
+        depth_,
+        blocked,
+        bodies_.size(),
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+
+    bodies_.clear();
+}
+
+void NavGrid::update(const iris::Vector3 &player_position)
+{
+    if (width_ == 0u)
+    {
+        return;
+    }
+
+    // the flow field only depends on the player's cell, so moving within it costs nothing, and a blocked cell (the
+    // player is up against a wall) keeps the last field which leads to where they just were
+    const auto cell = cell_index(player_position);
+    if ((cell == player_cell_) || (cell && (blocked_[*cell] != 0u)))
+    {
+        return;
+    }
+
+    player_cell_ = cell;
+
+    TRINKET_PROFILE_SCOPE("nav_search");
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // only cells the last search reached have anything to reset, so a search costs the cells in range of the player
+    // rather than the whole grid
+    for (const auto index : visited_)
+    {
+        cost_[index] = unreached;
+        flow_[index] = no_flow;
+    }
+
+    visited_.clear();
+
+    if (cell)
+    {
+        search(*cell);
+    }
+
+    ++searches_;
+    search_time_ += std::chrono::steady_clock::now() - start;
+    reached_total_ += visited_.size();
+}
+
+iris::Vector3 NavGrid::direction(const iris::Vector3 &position, const iris::Vector3 &player_position) const
+{
+    if (const auto cell = cell_index(position); cell && (flow_[*cell] != no_flow))
+    {
+        const auto neighbour = flow_[*cell];
+        return {direction_x[neighbour], 0.0f, direction_z[neighbour]};
+    }
+
+    return normalise(player_position - position);
+}
+
+std::size_t NavGrid::reached() const
+{
+    return visited_.size();
+}
+
+void NavGrid::log_stats() const
+{
+    if (searches_ == 0u)
+    {
+        return;
+    }
+
+    const auto searches = static_cast<double>(searches_);
+
+    LOG_INFO(
+        "zone",
+        "nav: {} searches, {:.3f}ms and {:.1f} cells reached per search (averages)",
+        searches_,
+        std::chrono::duration<double, std::milli>(search_time_).count() / searches,
+        static_cast<double>(reached_total_) / searches);
+}
+
+std::optional<std::size_t> NavGrid::cell_index(const iris::Vector3 &position) const
+{
+    const auto x = std::floor((position.x - min_x_) / cell_size_);
+    const auto z = std::floor((position.z - min_z_) / cell_size_);
+
+    if ((x < 0.0f) || (z < 0.0f) || (x >= static_cast<float>(width_)) || (z >= static_cast<float>(depth_)))
+    {
+        return std::nullopt;
+    }
+
+    return (static_cast<std::size_t>(z) * width_) + static_cast<std::size_t>(x);
+}
+
+void NavGrid::search(std::size_t target)
+{
+    // dijkstra with a bucket queue: edge costs are small integers so a ring of buckets (one more than the largest edge
+    // cost) replaces the heap, and each cell is only pushed when its cost improves
+    const auto bucket_count = static_cast<std::uint32_t>(buckets_.size());
+    const auto width = static_cast<std::int32_t>(width_);
+    const auto depth = static_cast<std::int32_t>(depth_);
+
+    // anything outside the grid counts as blocked
+    const auto is_blocked = [this, width, depth](std::int32_t x, std::int32_t z) {
+        return (x < 0) || (z < 0) || (x >= width) || (z >= depth) ||
+               (blocked_[(static_cast<std::size_t>(z) * width_) + static_cast<std::size_t>(x)] != 0u);
+    };
+
+    cost_[target] = 0u;
+    visited_.emplace_back(static_cast<std::uint32_t>(target));
+    buckets_[0u].emplace_back(static_cast<std::uint32_t>(target));
+    std::size_t pending = 1u;
+
+    for (std::uint32_t cost = 0u; pending != 0u; ++cost)
+    {
+        auto &bucket = buckets_[cost % bucket_count];
+
+        while (!bucket.empty())
+        {
+            const auto index = bucket.back();
+            bucket.pop_back();
+            --pending;
+
+            // cells are left in older buckets when a cheaper path is found, rather than removed
+            if (cost_[index] != cost)
+            {
+                continue;
+            }
+
+            const auto x = static_cast<std::int32_t>(index % width_);
+            const auto z = static_cast<std::int32_t>(index / width_);
+
+            for (auto i = 0u; i < neighbour_x.size(); ++i)
+            {
+                const auto nx = x + neighbour_x[i];
+                const auto nz = z + neighbour_z[i];
+
+                if (is_blocked(nx, nz))
+                {
+                    continue;
+                }
+
+                // corner neighbours are only reachable if neither edge neighbour next to them is blocked, so paths
+                // don't cut through the corners of walls
+                const auto diagonal = (i % 2u) == 1u;
+                if (diagonal && (is_blocked(nx, z) || is_blocked(x, nz)))
+                {
+                    continue;
+                }
+
+                const auto neighbour = (static_cast<std::size_t>(nz) * width_) + static_cast<std::size_t>(nx);
+                const auto new_cost = cost + (diagonal ? diagonal_cost : straight_cost);
+                if ((new_cost > max_cost_) || (new_cost >= cost_[neighbour]))
+                {
+                    continue;
+                }
+
+                if (cost_[neighbour] == unreached)
+                {
+                    visited_.emplace_back(static_cast<std::uint32_t>(neighbour));
+                }
+
+                // the neighbour flows back along the edge it was reached by
+                cost_[neighbour] = new_cost;
+                flow_[neighbour] = static_cast<std::uint8_t>((i + 4u) % 8u);
+                buckets_[new_cost % bucket_count].emplace_back(static_cast<std::uint32_t>(neighbour));
+                ++pending;
+            }
+        }
+    }
+}
+
+}
@@ -6,9 +6,7 @@
 
 #include "player.h"
 
-#include <any>
 #include <chrono>
-#include <tuple>
 
 #include "iris/core/error_handling.h"
 #include "iris/core/matrix4.h"
@@ -30,80 +28,208 @@
 #include "iris/physics/rigid_body.h"
 #include "iris/physics/rigid_body_type.h"
 
+#include "asset_cache.h"
 #include "character_controller.h"
 #include "maths.h"
+#include "message_data.h"
 #include "message_type.h"
+#include "transform_interpolator.h"
 
 using namespace std::literals::chrono_literals;
 
+namespace
+{
+
+/** Health of player when spawned. */
+constexpr auto max_health = 100.0f;
+
+}
+
 namespace trinket
 {
 
-Player::Player(
-    iris::Scene *scene,
-    iris::PhysicsSystem *ps,
-    const iris::Vector3 &start_position,
-    iris::RenderPipeline &render_pipeline)
+Player::Player(bool headless)
     : render_entities_()
     , character_controller_(nullptr)
     , sword_body_(nullptr)
     , attacking_(false)
     , attack_stop_()
     , attack_duration_(800ms)
-    , ps_(ps)
+    , ps_(nullptr)
     , blend_stop_()
     , blend_time_(500ms)
     , blending_(false)
+    , sim_time_()
+    , facing_(0.0f, 0.0f, 1.0f)
+    , tick_position_()
     , animation_controller_()
     , move_key_pressed_(0u)
-    , health_(100.0f)
+    , health_(max_health)
     , skeleton_(nullptr)
+    , rig_()
     , sub_meshes_()
     , sword_entity_(nullptr)
     , xp_(0u)
     , next_level_(100u)
 {
-    auto &mesh_manager = iris::Root::mesh_manager();
+    // nothing to render if headless
+    if (!headless)
+    {
+        load_rig();
+    }
 
-    auto meshes = mesh_manager.load_mesh("Warrior.fbx");
-    auto animations = std::move(meshes.animations);
-    skeleton_ = meshes.skeleton;
+    subscribe<MessageType::MOUSE_BUTTON_PRESS>(this);
+    subscribe<MessageType::KEY_PRESS>(this);
+    subscribe<MessageType::ENEMY_ATTACK>(this);
+    subscribe<MessageType::KILLED_ENEMY>(this);
+    subscribe<MessageType::QUEST_COMPLETE>(this);
+}
 
-    auto *render_graph = render_pipeline.create_render_graph();
-    auto *texture = render_graph->create<iris::TextureNode>("Warrior_Texture.png");
-    render_graph->render_node()->set_colour_input(texture);
+void Player::bind(
+    iris::Scene *scene,
+    iris::PhysicsSystem *ps,
+    const iris::Vector3 &start_position,
+    iris::RenderPipeline *render_pipeline)
+{
+    // everything from the previous zone has already been destroyed along with its scene and physics system
+    render_entities_.clear();
+    sub_meshes_.clear();
+    sword_entity_ = nullptr;
 
-    render_entities_.emplace_back(scene->create_entity<iris::SingleEntity>(
-        render_graph, meshes.mesh_data.front().mesh, iris::Transform{start_position, {}, {0.01f}}, skeleton_));
+    if (scene != nullptr)
+    {
+        create_render_entities(scene, start_position, *render_pipeline);
+    }
 
-    // load submeshes based on known offsets into mesh data
+    ps_ = ps;
 
-    auto *hair = render_entities_.emplace_back(scene->create_entity<iris::SingleEntity>(
-        render_graph, meshes.mesh_data[4].mesh, iris::Transform{{}, {}, {1.01f}}, skeleton_));
+    sword_body_ =
+        ps->create_rigid_body({}, ps->create_box_collision_shape({0.1f, 0.1f, 1.0f}), iris::RigidBodyType::GHOST);
+    sword_body_->set_name("sword");
 
-    sub_meshes_[hair] = SubMesh{
-        .bone_attach = "Neck",
-        .transform = iris::Matrix4::make_translate({0.0f, -2.0f, 0.0f}) *
-                     iris::Matrix4(iris::Quaternion{{1.0f, 0.0f, 0.0f}, -pi_2}),
-        .offset = {0.0f, 0.0f, 0.0f}};
+    character_controller_ = ps->create_character_controller<CharacterController>(ps, 12.0f, 0.5f, 1.7f, 2.0f);
+    character_controller_->reposition(start_position, {});
+    tick_position_ = start_position;
 
-    auto *left_shoulder = render_entities_.emplace_back(scene->create_entity<iris::SingleEntity>(
-        render_graph, meshes.mesh_data[2].mesh, iris::Transform{{}, {}, {10.01f}}, skeleton_));
+    // simulation time restarts with each zone and any held keys were released whilst loading
+    attacking_ = false;
+    blending_ = false;
+    sim_time_ = {};
+    move_key_pressed_ = 0u;
 
-    sub_meshes_[left_shoulder] = SubMesh{
-        .bone_attach = "UpperArm.R",
-        .transform = iris::Matrix4(iris::Quaternion{{0.0f, 0.0f, 1.0f}, -pi_2}) *
-                     iris::Matrix4::make_translate({0.0f, 0.0f, 0.1f}),
-        .offset = {0.0f, 0.0f, 0.0f}};
+    if (animation_controller_ != nullptr)
+    {
+        animation_controller_->play(0u, "CharacterArmature|Idle_Weapon");
+    }
+}
 
-    auto *right_shoulder = render_entities_.emplace_back(scene->create_entity<iris::SingleEntity>(
-        render_graph, meshes.mesh_data[3].mesh, iris::Transform{{}, {}, {10.01f}}, skeleton_));
+void Player::respawn()
+{
+    health_ = max_health;
+    publish<MessageType::PLAYER_HEALTH_CHANGE>(health_);
+}
 
-    sub_meshes_[right_shoulder] = SubMesh{
-        .bone_attach = "UpperArm.L",
-        .transform = iris::Matrix4(iris::Quaternion{{0.0f, 0.0f, 1.0f}, pi_2}) *
-                     iris::Matrix4::make_translate({0.0f, 0.0f, 0.1f}),
-        .offset = {0.0f, 0.0f, 0.0f}};
+void Player::update(std::chrono::microseconds elapsed)
+{
+    sim_time_ = elapsed;
+
+    // physics has already stepped this tick, so the player won't move again until the next one
+    tick_position_ = position();
+
+    // handle attack logic if player is attacking
+    if (attacking_)
+    {
+        if (sim_time_ >= attack_stop_)
+        {
+            // attack has completed so reset state
+            attacking_ = false;
+        }
+
+        // get all contact points the sword is making (ignoring the player) and publish a message to whatever was hit
+        for (auto &contact : ps_->contacts(sword_body_))
+        {
+            if (contact.contact != character_controller_->rigid_body())
+            {
+                publish<MessageType::WEAPON_COLLISION>(contact.contact, {contact.contact, contact.position});
+            }
+        }
+    }
+
+    // offset of player in world space
+    static constexpr iris::Vector3 player_world_offset{0.0f, -2.0f, 0.0f};
+    static constexpr auto player_world_offset_transform = iris::Matrix4::make_translate(player_world_offset);
+
+    if (render_entities_.empty())
+    {
+        // headless so there's no skeleton to attach the sword to, instead hold it in front of the player
+        sword_body_->reposition(position() + facing_, {});
+    }
+    else
+    {
+        animation_controller_->update();
+
+        render_entities_.front()->set_position(character_controller_->position() + player_world_offset);
+
+        for (auto &[entity, sub_mesh] : sub_meshes_)
+        {
+            // bone to attach sword to
+            const auto bone_index = skeleton_->bone_index(sub_mesh.bone_attach);
+            const auto bone_transform = skeleton_->transform(bone_index);
+            const auto &bone = skeleton_->bone(bone_index);
+
+            // get bone transform in world space
+            const auto bone_to_world_space = render_entities_.front()->transform() * bone_transform *
+                                             iris::Matrix4::invert(bone.offset()) * sub_mesh.transform;
+
+            entity->set_transform(bone_to_world_space);
+
+            if (entity == sword_entity_)
+            {
+                const iris::Transform sword_body_transform{
+                    bone_to_world_space *
+                    iris::Matrix4::make_translate(sub_mesh.offset + iris::Vector3{0.0f, 0.0f, 1.0f})};
+                const iris::Transform sword_body_transform2{
+                    bone_to_world_space * iris::Matrix4::make_translate(sub_mesh.offset)};
+                sword_body_->reposition(sword_body_transform.translation(), sword_body_transform.rotation());
+                entity->set_position(sword_body_transform2.translation());
+                entity->set_orientation(sword_body_transform2.rotation());
+            }
+        }
+    }
+
+    for (const auto &contact : ps_->contacts(character_controller_->rigid_body()))
+    {
+        if (contact.contact != sword_body_)
+        {
+            publish<MessageType::OBJECT_COLLISION>(contact.contact, {contact.contact, contact.position});
+        }
+    }
+
+    if (health_ <= 0.0f)
+    {
+        publish<MessageType::PLAYER_DIED>();
+        health_ = 1.0f;
+    }
+}
+
+UpdatePhase Player::update_phase() const
+{
+    return UpdatePhase::PLAYER;
+}
+
+void Player::add_interpolated(TransformInterpolator &interpolator)
+{
+    for (auto *entity : render_entities_)
+    {
+        interpolator.add(entity);
+    }
+}
+
+void Player::load_rig()
+{
+    rig_ = iris::Root::mesh_manager().load_mesh("Warrior.fbx");
+    auto animations = std::move(rig_.animations);
+    skeleton_ = rig_.skeleton;
 
     // set sword attack animation to not loop
     auto sword_attack_animation =
@@ -140,15 +266,57 @@ Player::Player(
              },
              "CharacterArmature|Sword_AttackFast"}},
         skeleton_);
+}
+
+void Player::create_render_entities(
+    iris::Scene *scene,
+    const iris::Vector3 &start_position,
+    iris::RenderPipeline &render_pipeline)
+{
+    auto *render_graph = render_pipeline.create_render_graph();
+    auto *texture = render_graph->create<iris::TextureNode>(AssetCache::instance().texture("Warrior_Texture.png"));
+    render_graph->render_node()->set_colour_input(texture);
+
+    render_entities_.emplace_back(scene->create_entity<iris::SingleEntity>(
+        render_graph, rig_.mesh_data.front().mesh, iris::Transform{start_position, {}, {0.01f}}, skeleton_));
+
+    // load submeshes based on known offsets into mesh data
+
+    auto *hair = render_entities_.emplace_back(scene->create_entity<iris::SingleEntity>(
+        render_graph, rig_.mesh_data[4].mesh, iris::Transform{{}, {}, {1.01f}}, skeleton_));
+
+    sub_meshes_[hair] = SubMesh{
+        .bone_attach = "Neck",
+        .transform = iris::Matrix4::make_translate({0.0f, -2.0f, 0.0f}) *
+                     iris::Matrix4(iris::Quaternion{{1.0f, 0.0f, 0.0f}, -pi_2}),
+        .offset = {0.0f, 0.0f, 0.0f}};
+
+    auto *left_shoulder = render_entities_.emplace_back(scene->create_entity<iris::SingleEntity>(
+        render_graph, rig_.mesh_data[2].mesh, iris::Transform{{}, {}, {10.01f}}, skeleton_));
+
+    sub_meshes_[left_shoulder] = SubMesh{
+        .bone_attach = "UpperArm.R",
+        .transform = iris::Matrix4(iris::Quaternion{{0.0f, 0.0f, 1.0f}, -pi_2}) *
+                     iris::Matrix4::make_translate({0.0f, 0.0f, 0.1f}),
+        .offset = {0.0f, 0.0f, 0.0f}};
 
-    const auto sword_meshes = mesh_manager.load_mesh("Sword.fbx");
+    auto *right_shoulder = render_entities_.emplace_back(scene->create_entity<iris::SingleEntity>(
+        render_graph, rig_.mesh_data[3].mesh, iris::Transform{{}, {}, {10.01f}}, skeleton_));
+
+    sub_meshes_[right_shoulder] = SubMesh{
+        .bone_attach = "UpperArm.L",
+        .transform = iris::Matrix4(iris::Quaternion{{0.0f, 0.0f, 1.0f}, pi_2}) *
+                     iris::Matrix4::make_translate({0.0f, 0.0f, 0.1f}),
+        .offset = {0.0f, 0.0f, 0.0f}};
+
+    const auto sword_meshes = AssetCache::instance().mesh("Sword.fbx");
     iris::expect(sword_meshes.mesh_data.size() == 1u, "expecting only one mesh");
 
     // load sword and attach to hand
 
     auto *render_graph2 = render_pipeline.create_render_graph();
     render_graph2->render_node()->set_colour_input(render_graph2->create<iris::ArithmeticNode>(
-        render_graph2->create<iris::TextureNode>("Sword_Texture.png"),
+        render_graph2->create<iris::TextureNode>(AssetCache::instance().texture("Sword_Texture.png")),
         render_graph2->create<iris::ValueNode<iris::Colour>>(iris::Colour{1.0f, 1.0f, 1.0f, 1.0f}),
         iris::ArithmeticOperator::MULTIPLY));
 
@@ -160,100 +328,25 @@ Player::Player(
         .transform =
             iris::Matrix4(iris::Quaternion{{0.0f, 1.0f, 0.0f}, -pi_2} * iris::Quaternion{{0.0f, 0.0f, 1.0f}, pi_2}),
         .offset = {0.0f, 0.07f, 0.0f}};
-
-    sword_body_ =
-        ps->create_rigid_body({}, ps->create_box_collision_shape({0.1f, 0.1f, 1.0f}), iris::RigidBodyType::GHOST);
-    sword_body_->set_name("sword");
-
-    character_controller_ = ps->create_character_controller<CharacterController>(ps, 12.0f, 0.5f, 1.7f, 2.0f);
-    character_controller_->reposition(render_entities_.front()->position(), {});
-
-    subscribe(MessageType::MOUSE_BUTTON_PRESS);
-    subscribe(MessageType::KEY_PRESS);
-    subscribe(MessageType::ENEMY_ATTACK);
-    subscribe(MessageType::KILLED_ENEMY);
-    subscribe(MessageType::QUEST_COMPLETE);
 }
 
-void Player::update(std::chrono::microseconds)
+void Player::set_orientation(const iris::Quaternion &orientation)
 {
-    const auto now = std::chrono::system_clock::now();
-
-    // handle attack logic if player is attacking
-    if (attacking_)
-    {
-        if (now >= attack_stop_)
-        {
-            // attack has completed so reset state
-            attacking_ = false;
-        }
-
-        // get all contact points the sword is making (ignoring the player) and publish a message
-        for (auto &contact : ps_->contacts(sword_body_))
-        {
-            if (contact.contact != character_controller_->rigid_body())
-            {
-                publish(MessageType::WEAPON_COLLISION, std::make_tuple(contact.contact, contact.position));
-            }
-        }
-    }
-
-    animation_controller_->update();
-
-    // offset of player in world space
-    static constexpr iris::Vector3 player_world_offset{0.0f, -2.0f, 0.0f};
-    static constexpr auto player_world_offset_transform = iris::Matrix4::make_translate(player_world_offset);
-
-    render_entities_.front()->set_position(character_controller_->position() + player_world_offset);
-
-    for (auto &[entity, sub_mesh] : sub_meshes_)
+    if (!render_entities_.empty())
     {
-        // bone to attach sword to
-        const auto bone_index = skeleton_->bone_index(sub_mesh.bone_attach);
-        const auto bone_transform = skeleton_->transform(bone_index);
-        const auto &bone = skeleton_->bone(bone_index);
-
-        // get bone transform in world space
-        const auto bone_to_world_space = render_entities_.front()->transform() * bone_transform *
-                                         iris::Matrix4::invert(bone.offset()) * sub_mesh.transform;
-
-        entity->set_transform(bone_to_world_space);
-
-        if (entity == sword_entity_)
-        {
-            const iris::Transform sword_body_transform{
-                bone_to_world_space * iris::Matrix4::make_translate(sub_mesh.offset + iris::Vector3{0.0f, 0.0f, 1.0f})};
-            const iris::Transform sword_body_transform2{
-                bone_to_world_space * iris::Matrix4::make_translate(sub_mesh.offset)};
-            sword_body_->reposition(sword_body_transform.translation(), sword_body_transform.rotation());
-            entity->set_position(sword_body_transform2.translation());
-            entity->set_orientation(sword_body_transform2.rotation());
-        }
-    }
-
-    for (const auto &contact : ps_->contacts(character_controller_->rigid_body()))
-    {
-        if (contact.contact != sword_body_)
-        {
-            publish(MessageType::OBJECT_COLLISION, std::make_tuple(contact.contact, contact.position));
-        }
-    }
-
-    if (health_ <= 0.0f)
-    {
-        publish(MessageType::PLAYER_DIED, {});
-        health_ = 1.0f;
+        render_entities_.front()->set_orientation(orientation * iris::Quaternion{{0.0f, 1.0f, 0.0f}, -M_PI_2});
     }
 }
 
-void Player::set_orientation(const iris::Quaternion &orientation)
-{
-    render_entities_.front()->set_orientation(orientation * iris::Quaternion{{0.0f, 1.0f, 0.0f}, -M_PI_2});
-}
-
 void Player::set_walk_direction(const iris::Vector3 &direction)
 {
     character_controller_->set_movement_direction(direction);
+
+    // remember which way we were last moving, so we know which way we are facing when we stop
+    if (direction.magnitude() > 0.0f)
+    {
+        facing_ = direction;
+    }
 }
 
 iris::Vector3 Player::position() const
@@ -261,95 +354,95 @@ iris::Vector3 Player::position() const
     return character_controller_->position();
 }
 
+iris::Vector3 Player::tick_position() const
+{
+    return tick_position_;
+}
+
 const iris::RigidBody *Player::rigid_body() const
 {
     return character_controller_->rigid_body();
 }
 
-void Player::handle_message(MessageType message_type, const std::any &data)
+void Player::handle_message(const Message<MessageType::MOUSE_BUTTON_PRESS> &message)
 {
-    switch (message_type)
-    {
-        case MessageType::MOUSE_BUTTON_PRESS:
-        {
-            const auto mouse_button = std::any_cast<iris::MouseButtonEvent>(data);
-            if (!attacking_)
-            {
-                // player can only attack if not attacking
-                if ((mouse_button.button == iris::MouseButton::LEFT) &&
-                    (mouse_button.state == iris::MouseButtonState::DOWN))
-                {
-                    attacking_ = true;
-                    attack_stop_ = std::chrono::system_clock::now() + attack_duration_;
-
-                    animation_controller_->play(1u, "CharacterArmature|Sword_AttackFast");
-                }
-            }
+    const auto &mouse_button = message.data;
 
-            break;
-        }
-        case MessageType::KEY_PRESS:
+    // player can only attack if not attacking
+    if (!attacking_)
+    {
+        if ((mouse_button.button == iris::MouseButton::LEFT) && (mouse_button.state == iris::MouseButtonState::DOWN))
         {
-            const auto key = std::any_cast<iris::KeyboardEvent>(data);
+            attacking_ = true;
+            attack_stop_ = sim_time_ + attack_duration_;
 
-            // update player animation to running
-            if ((key.key == iris::Key::W) || (key.key == iris::Key::A) || (key.key == iris::Key::S) ||
-                (key.key == iris::Key::D))
+            if (animation_controller_ != nullptr)
             {
-                blend_stop_ = std::chrono::system_clock::now() + blend_time_;
-                blending_ = true;
-                if (key.state == iris::KeyState::DOWN)
-                {
-                    animation_controller_->play(0u, "CharacterArmature|Run");
-                    ++move_key_pressed_;
-                }
-                else
-                {
-                    if (move_key_pressed_ != 0u)
-                    {
-                        --move_key_pressed_;
-                        if (move_key_pressed_ == 0u)
-                        {
-                            animation_controller_->play(0u, "CharacterArmature|Idle_Weapon");
-                        }
-                    }
-                }
+                animation_controller_->play(1u, "CharacterArmature|Sword_AttackFast");
             }
-
-            break;
         }
-        case MessageType::ENEMY_ATTACK:
-        {
-            health_ -= 10.0f;
-            publish(MessageType::PLAYER_HEALTH_CHANGE, health_);
+    }
+}
 
-            break;
-        }
-        case MessageType::KILLED_ENEMY:
+void Player::handle_message(const Message<MessageType::KEY_PRESS> &message)
+{
+    const auto &key = message.data;
+
+    // update player animation to running
+    if ((key.key == iris::Key::W) || (key.key == iris::Key::A) || (key.key == iris::Key::S) ||
+        (key.key == iris::Key::D))
+    {
+        blend_stop_ = sim_time_ + blend_time_;
+        blending_ = true;
+        if (key.state == iris::KeyState::DOWN)
         {
-            xp_ += 30u;
-            if (xp_ >= next_level_)
+            if (animation_controller_ != nullptr)
             {
-                xp_ %= next_level_;
+                animation_controller_->play(0u, "CharacterArmature|Run");
             }
 
-            publish(MessageType::LEVEL_PROGRESS, static_cast<float>(xp_) / static_cast<float>(next_level_));
-
-            break;
+            ++move_key_pressed_;
         }
-        case MessageType::QUEST_COMPLETE:
+        else
         {
-            xp_ += std::any_cast<std::uint32_t>(data);
-            if (xp_ >= next_level_)
+            if (move_key_pressed_ != 0u)
             {
-                xp_ %= next_level_;
+                --move_key_pressed_;
+                if ((move_key_pressed_ == 0u) && (animation_controller_ != nullptr))
+                {
+                    animation_controller_->play(0u, "CharacterArmature|Idle_Weapon");
+                }
             }
+        }
+    }
+}
 
-            publish(MessageType::LEVEL_PROGRESS, static_cast<float>(xp_) / static_cast<float>(next_level_));
+void Player::handle_message(const Message<MessageType::ENEMY_ATTACK> &)
+{
+    health_ -= 10.0f;
+    publish<MessageType::PLAYER_HEALTH_CHANGE>(health_);
+}
 
-            break;
-        }
-        default: break;
+void Player::handle_message(const Message<MessageType::KILLED_ENEMY> &)
+{
+    xp_ += 30u;
+    if (xp_ >= next_level_)
+    {
+        xp_ %= next_level_;
     }
+
+    publish<MessageType::LEVEL_PROGRESS>(static_cast<float>(xp_) / static_cast<float>(next_level_));
 }
+
+void Player::handle_message(const Message<MessageType::QUEST_COMPLETE> &message)
+{
+    xp_ += message.data;
+    if (xp_ >= next_level_)
+    {
+        xp_ %= next_level_;
+    }
+
+    publish<MessageType::LEVEL_PROGRESS>(static_cast<float>(xp_) / static_cast<float>(next_level_));
+}
+
 }
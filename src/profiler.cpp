@@ -0,0 +1,341 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+#include "iris/core/error_handling.h"
+#include "iris/log/log.h"
+
+#include "type_name.h"
+
+namespace
+{
+
+/**
+ * Get a percentile from a collection of samples.
+ *
+ * @param samples
+ *   Samples, will be partially reordered.
+ *
+ * @param percentile
+ *   Percentile to get, in range [0, 1].
+ *
+ * @returns
+ *   Sample at percentile, 0 if there are no samples.
+ */
+float percentile(std::vector<float> &samples, float percentile)
+{
+    if (samples.empty())
+    {
+        return 0.0f;
+    }
+
+    const auto index = static_cast<std::size_t>(static_cast<float>(samples.size() - 1u) * percentile);
+    std::nth_element(std::begin(samples), std::begin(samples) + index, std::end(samples));
+
+    return samples[index];
+}
+
+/**
+ * Convert a duration to fractional microseconds (the unit of trace_event timestamps).
+ *
+ * @param duration
+ *   Duration to convert.
+ *
+ * @returns
+ *   Duration in microseconds.
+ */
+double to_us(std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+}
+
+namespace trinket
+{
+
+thread_local Profiler::ThreadBuffer *Profiler::buffer_ = nullptr;
+thread_local std::uint32_t ScopedTimer::depth_ = 0u;
+
+Profiler::Profiler()
+    : enabled_(false)
+    , epoch_(std::chrono::steady_clock::now())
+    , last_frame_(epoch_)
+    , buffers_mutex_()
+    , buffers_()
+    , phases_()
+{
+}
+
+Profiler &Profiler::instance()
+{
+    static Profiler instance{};
+    return instance;
+}
+
+void Profiler::set_enabled(bool enabled)
+{
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::enabled() const
+{
+    return enabled_.load(std::memory_order_relaxed);
+}
+
+void Profiler::record(
+    const char *name,
+    const std::type_info *type,
+    std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::time_point end,
+    std::uint32_t depth)
+{
+    auto &buffer = thread_buffer();
+
+    buffer.events[buffer.count % buffer_capacity] = {
+        .name = name,
+        .type = type,
+        .start = start - epoch_,
+        .duration = end - start,
+        .depth = depth,
+        .is_counter = false,
+        .value = 0};
+    ++buffer.count;
+}
+
+void Profiler::counter(const char *name, std::int64_t value)
+{
+    if (!enabled())
+    {
+        return;
+    }
+
+    auto &buffer = thread_buffer();
+
+    buffer.events[buffer.count % buffer_capacity] = {
+        .name = name,
+        .type = nullptr,
+        .start = std::chrono::steady_clock::now() - epoch_,
+        .duration = std::chrono::nanoseconds{0},
+        .depth = 0u,
+        .is_counter = true,
+        .value = value};
+    ++buffer.count;
+}
+
+void Profiler::end_frame()
+{
+    const auto now = std::chrono::steady_clock::now();
+    const auto frame_time = now - last_frame_;
+    last_frame_ = now;
+
+    if (buffer_ == nullptr)
+    {
+        return;
+    }
+
+    auto &buffer = *buffer_;
+
+    if (enabled())
+    {
+        add_sample("frame", frame_time);
+
+        // sum outermost scopes by name, a phase may run more than once a frame (e.g. several fixed ticks)
+        std::unordered_map<std::string, std::chrono::nanoseconds> frame_phases{};
+        const auto first = std::max(buffer.frame_start, buffer.count - std::min(buffer.count, buffer_capacity));
+
+        for (auto i = first; i < buffer.count; ++i)
+        {
+            const auto &event = buffer.events[i % buffer_capacity];
+            if ((event.depth == 0u) && (event.name != nullptr) && !event.is_counter)
+            {
+                frame_phases[event.name] += event.duration;
+            }
+        }
+
+        for (const auto &[name, duration] : frame_phases)
+        {
+            add_sample(name, duration);
+        }
+    }
+
+    buffer.frame_start = buffer.count;
+}
+
+void Profiler::write_trace(const std::string &path) const
+{
+    std::ofstream out{path};
+    iris::ensure(out.is_open(), "could not open profiler trace file");
+
+    // demangling is slow so only do it once per type
+    std::unordered_map<const std::type_info *, std::string> type_names{};
+
+    out << "{\"traceEvents\": [";
+
+    auto first = true;
+
+    std::scoped_lock lock{buffers_mutex_};
+    for (const auto &buffer : buffers_)
+    {
+        out << (first ? "\n" : ",\n");
+        first = false;
+
+        out << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << buffer->thread_id
+            << ", \"args\": {\"name\": \"thread " << buffer->thread_id << "\"}}";
+
+        for (auto i = buffer->count - std::min(buffer->count, buffer_capacity); i < buffer->count; ++i)
+        {
+            const auto &event = buffer->events[i % buffer_capacity];
+
+            if (event.is_counter)
+            {
+                out << ",\n  {\"name\": \"" << event.name << "\", \"cat\": \"trinket\", \"ph\": \"C\", \"ts\": "
+                    << to_us(event.start) << ", \"pid\": 0, \"tid\": " << buffer->thread_id
+                    << ", \"args\": {\"value\": " << event.value << "}}";
+                continue;
+            }
+
+            std::string name{};
+            if (event.name != nullptr)
+            {
+                name = event.name;
+            }
+            else
+            {
+                auto [type_name_entry, inserted] = type_names.try_emplace(event.type);
+                if (inserted)
+                {
+                    type_name_entry->second = type_name(*event.type);
+                }
+
+                name = type_name_entry->second;
+            }
+
+            out << ",\n  {\"name\": \"" << name << "\", \"cat\": \"trinket\", \"ph\": \"X\", \"ts\": "
+                << to_us(event.start) << ", \"dur\": " << to_us(event.duration)
+                << ", \"pid\": 0, \"tid\": " << buffer->thread_id << "}";
+        }
+    }
+
+    out << "\n]}\n";
+}
+
+void Profiler::log_summary() const
+{
+    for (const auto &phase : phases_)
+    {
+        auto samples = phase.samples;
+
+        const auto p50 = percentile(samples, 0.5f);
+        const auto p95 = percentile(samples, 0.95f);
+        const auto p99 = percentile(samples, 0.99f);
+
+        LOG_INFO(
+            "profiler",
+            "{}: p50 {}ms p95 {}ms p99 {}ms ({} frames)",
+            phase.name,
+            p50,
+            p95,
+            p99,
+            samples.size());
+    }
+}
+
+Profiler::ThreadBuffer &Profiler::thread_buffer()
+{
+    if (buffer_ == nullptr)
+    {
+        std::scoped_lock lock{buffers_mutex_};
+
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->events.resize(buffer_capacity);
+        buffer->count = 0u;
+        buffer->frame_start = 0u;
+        buffer->thread_id = static_cast<std::uint32_t>(buffers_.size());
+
+        buffer_ = buffer.get();
+        buffers_.emplace_back(std::move(buffer));
+    }
+
+    return *buffer_;
+}
+
+void Profiler::add_sample(const std::string &name, std::chrono::nanoseconds duration)
+{
+    auto phase = std::find_if(
+        std::begin(phases_), std::end(phases_), [&name](const auto &element) { return element.name == name; });
+
+    if (phase == std::end(phases_))
+    {
+        phase = phases_.insert(phases_.end(), {.name = name, .samples = {}, .next = 0u});
+        phase->samples.reserve(history_frames);
+    }
+
+    const auto sample = std::chrono::duration<float, std::milli>(duration).count();
+
+    if (phase->samples.size() < history_frames)
+    {
+        phase->samples.emplace_back(sample);
+    }
+    else
+    {
+        phase->samples[phase->next] = sample;
+    }
+
+    phase->next = (phase->next + 1u) % history_frames;
+}
+
+ScopedTimer::ScopedTimer(const char *name)
+    : name_(name)
+    , type_(nullptr)
+    , active_(Profiler::instance().enabled())
+    , start_()
+{
+    if (active_)
+    {
+        ++depth_;
+        start_ = std::chrono::steady_clock::now();
+    }
+}
+
+ScopedTimer::ScopedTimer(const std::type_info &type)
+    : name_(nullptr)
+    , type_(&type)
+    , active_(Profiler::instance().enabled())
+    , start_()
+{
+    if (active_)
+    {
+        ++depth_;
+        start_ = std::chrono::steady_clock::now();
+    }
+}
+
+ScopedTimer::~ScopedTimer()
+{
+    if (active_)
+    {
+        const auto end = std::chrono::steady_clock::now();
+        --depth_;
+
+        Profiler::instance().record(name_, type_, start_, end, depth_);
+    }
+}
+
+}
@@ -21,10 +21,15 @@ void QuestManager::update(std::chrono::microseconds)
         std::remove_if(std::begin(quests_), std::end(quests_), [](const auto &quest) { return quest->is_complete(); });
 
     std::for_each(iter, std::end(quests_), [&](const auto &quest) {
-        publish(MessageType::QUEST_COMPLETE, {quest->completion_xp()});
+        publish<MessageType::QUEST_COMPLETE>(quest->completion_xp());
     });
 
     quests_.erase(iter, std::end(quests_));
 }
 
+UpdatePhase QuestManager::update_phase() const
+{
+    return UpdatePhase::PRESENTATION;
+}
+
 }
@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "script_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "iris/core/error_handling.h"
+#include "iris/core/resource_loader.h"
+#include "iris/core/vector3.h"
+#include "iris/log/log.h"
+#include "iris/scripting/lua/lua_script.h"
+#include "iris/scripting/script_runner.h"
+
+#include "enemy_ai.h"
+#include "enemy_decision.h"
+#include "job_system.h"
+#include "native_ai.h"
+#include "profiler.h"
+
+namespace trinket
+{
+
+EnemyScript::EnemyScript(
+    iris::ScriptRunner &script,
+    std::mutex &mutex,
+    std::int32_t id,
+    const iris::Vector3 &bounds_min,
+    const iris::Vector3 &bounds_max)
+    : script_(script)
+    , mutex_(mutex)
+    , id_(id)
+{
+    std::scoped_lock lock{mutex_};
+    script_.execute("init", id_, bounds_min, bounds_max);
+}
+
+EnemyScript::~EnemyScript()
+{
+    std::scoped_lock lock{mutex_};
+    script_.execute("release", id_);
+}
+
+EnemyDecision EnemyScript::tick(
+    const iris::Vector3 &position,
+    const iris::Vector3 &player_position,
+    const iris::Vector3 &steering,
+    std::chrono::microseconds elapsed,
+    float health)
+{
+    std::scoped_lock lock{mutex_};
+    return tick_script(script_, id_, position, player_position, steering, elapsed, health);
+}
+
+ScriptPool::ScriptPool(std::uint32_t state_count)
+    : state_count_(std::max(state_count, 1u))
+    , scripts_()
+    , next_id_(0)
+{
+}
+
+void ScriptPool::load(const std::vector<std::string> &script_files, JobSystem &jobs)
+{
+    std::vector<std::string> sources{};
+    std::vector<std::vector<std::unique_ptr<State>> *> states{};
+
+    for (const auto &script_file : script_files)
+    {
+        if (is_native_ai(script_file))
+        {
+            continue;
+        }
+
+        auto [script, inserted] = scripts_.try_emplace(script_file);
+        if (!inserted)
+        {
+            continue;
+        }
+
+        const auto &data = iris::ResourceLoader::instance().load(script_file);
+        sources.emplace_back(reinterpret_cast<const char *>(data.data()), data.size());
+
+        for (auto i = 0u; i < state_count_; ++i)
+        {
+            script->second.emplace_back(std::make_unique<State>());
+        }
+
+        states.emplace_back(&script->second);
+    }
+
+    // every lua state is independent, so they can all be compiled at once
+    jobs.parallel_for(sources.size() * state_count_, 1u, [this, &sources, &states](std::size_t index) {
+        TRINKET_PROFILE_SCOPE("compile_script");
+        const auto source = index / state_count_;
+        (*states[source])[index % state_count_]->script =
+            std::make_unique<iris::ScriptRunner>(std::make_unique<iris::LuaScript>(sources[source]));
+    });
+
+    if (!sources.empty())
+    {
+        LOG_INFO("script", "compiled {} scripts into {} states each", sources.size(), state_count_);
+    }
+}
+
+std::unique_ptr<EnemyAi> ScriptPool::create(
+    const std::string &script_file,
+    const iris::Vector3 &bounds_min,
+    const iris::Vector3 &bounds_max)
+{
+    const auto script = scripts_.find(script_file);
+    iris::expect(script != std::cend(scripts_), "script not loaded");
+
+    const auto id = next_id_++;
+    auto &state = *script->second[static_cast<std::size_t>(id) % script->second.size()];
+
+    return std::make_unique<EnemyScript>(*state.script, state.mutex, id, bounds_min, bounds_max);
+}
+
+}
@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "stage_timer.h"
+
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#include "iris/log/log.h"
+
+namespace trinket
+{
+
+StageTimer::StageTimer(const std::string &name, std::uint32_t thread_count)
+    : name_(name)
+    , thread_count_(thread_count)
+    , stages_()
+    , current_()
+    , current_start_()
+{
+}
+
+void StageTimer::start(const std::string &stage)
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    if (!current_.empty())
+    {
+        stages_.emplace_back(current_, now - current_start_);
+    }
+
+    current_ = stage;
+    current_start_ = now;
+}
+
+void StageTimer::log()
+{
+    start({});
+
+    std::stringstream strm{};
+    std::chrono::steady_clock::duration total{};
+
+    for (const auto &[stage, duration] : stages_)
+    {
+        strm << " " << stage << " "
+             << std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(duration).count() << "ms";
+        total += duration;
+    }
+
+    LOG_INFO(
+        "zone",
+        "{}:{} (total {}ms, {} threads)",
+        name_,
+        strm.str(),
+        std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(total).count(),
+        thread_count_);
+
+    stages_.clear();
+}
+
+}
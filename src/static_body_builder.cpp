@@ -0,0 +1,329 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "static_body_builder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "iris/core/matrix4.h"
+#include "iris/core/quaternion.h"
+#include "iris/core/vector3.h"
+#include "iris/graphics/mesh.h"
+#include "iris/log/log.h"
+#include "iris/physics/collision_shape.h"
+#include "iris/physics/physics_system.h"
+#include "iris/physics/rigid_body.h"
+#include "iris/physics/rigid_body_type.h"
+
+#include "job_system.h"
+#include "mesh_bounds.h"
+#include "nav_grid.h"
+
+namespace
+{
+
+/** Tolerance when comparing positions of boxes to merge. */
+constexpr auto merge_epsilon = 0.01f;
+
+/**
+ * Get a component of a vector by index.
+ *
+ * @param vector
+ *   Vector to get component of.
+ *
+ * @param axis
+ *   Index of component, 0 = x, 1 = y, 2 = z.
+ *
+ * @returns
+ *   Reference to component.
+ */
+float &component(iris::Vector3 &vector, std::size_t axis)
+{
+    switch (axis)
+    {
+        case 0u: return vector.x;
+        case 1u: return vector.y;
+        default: return vector.z;
+    }
+}
+
+}
+
+namespace trinket
+{
+
+StaticBodyBuilder::StaticBodyBuilder(iris::PhysicsSystem *ps, bool merge_boxes)
+    : ps_(ps)
+    , merge_boxes_(merge_boxes)
+    , boxes_()
+    , meshes_()
+    , mesh_bounds_()
+    , box_shapes_()
+    , mesh_shapes_()
+    , shapes_reused_(0u)
+{
+}
+
+void StaticBodyBuilder::add_box(
+    const std::string &name,
+    const iris::Vector3 &position,
+    const iris::Quaternion &orientation,
+    const iris::Vector3 &half_extents)
+{
+    boxes_.push_back(
+        {.name = name,
+         .position = position,
+         .orientation = orientation,
+         .half_extents = half_extents,
+         .mesh = nullptr});
+}
+
+void StaticBodyBuilder::add_bounding_box(
+    const std::string &name,
+    const iris::Mesh *mesh,
+    const iris::Vector3 &position,
+    const iris::Quaternion &orientation,
+    const iris::Vector3 &scale)
+{
+    // bounds are computed by build, so each mesh is only walked once (and in parallel with other meshes)
+    boxes_.push_back(
+        {.name = name, .position = position, .orientation = orientation, .half_extents = scale, .mesh = mesh});
+}
+
+void StaticBodyBuilder::add_mesh(
+    const std::string &name,
+    const iris::Mesh *mesh,
+    const iris::Vector3 &position,
+    const iris::Quaternion &orientation,
+    const iris::Vector3 &scale)
+{
+    meshes_.push_back(
+        {.name = name, .mesh = mesh, .position = position, .orientation = orientation, .scale = scale});
+}
+
+void StaticBodyBuilder::set_mesh_bounds(const iris::Mesh *mesh, const iris::Vector3 &min, const iris::Vector3 &max)
+{
+    mesh_bounds_[mesh] = (max - min) * 0.5f;
+}
+
+void StaticBodyBuilder::build(JobSystem &jobs, NavGrid &nav)
+{
+    const auto added = boxes_.size() + meshes_.size();
+
+    resolve_bounds(jobs, nav.enabled());
+
+    if (merge_boxes_)
+    {
+        for (auto axis = 0u; axis < 3u; ++axis)
+        {
+            merge(jobs, axis);
+        }
+    }
+
+    for (const auto &box : boxes_)
+    {
+        auto [shape, inserted] = box_shapes_.try_emplace(
+            {box.half_extents.x, box.half_extents.y, box.half_extents.z}, nullptr);
+
+        if (inserted)
+        {
+            shape->second = ps_->create_box_collision_shape(box.half_extents);
+        }
+        else
+        {
+            ++shapes_reused_;
+        }
+
+        create_body(box.name, box.position, box.orientation, shape->second);
+        nav.add(box.position, box.orientation, box.half_extents);
+    }
+
+    for (const auto &mesh : meshes_)
+    {
+        auto [shape, inserted] =
+            mesh_shapes_.try_emplace({mesh.mesh, mesh.scale.x, mesh.scale.y, mesh.scale.z}, nullptr);
+
+        if (inserted)
+        {
+            shape->second = ps_->create_mesh_collision_shape(mesh.mesh, mesh.scale);
+        }
+        else
+        {
+            ++shapes_reused_;
+        }
+
+        create_body(mesh.name, mesh.position, mesh.orientation, shape->second);
+
+        if (nav.enabled())
+        {
+            nav.add(mesh.position, mesh.orientation, mesh_bounds_[mesh.mesh] * mesh.scale);
+        }
+    }
+
+    LOG_INFO(
+        "zone",
+        "{} static bodies created from {}, {} collision shapes ({} reused)",
+        boxes_.size() + meshes_.size(),
+        added,
+        box_shapes_.size() + mesh_shapes_.size(),
+        shapes_reused_);
+
+    boxes_.clear();
+    meshes_.clear();
+}
+
+void StaticBodyBuilder::resolve_bounds(JobSystem &jobs, bool mesh_bodies)
+{
+    std::vector<const iris::Mesh *> pending{};
+
+    for (const auto &box : boxes_)
+    {
+        if ((box.mesh != nullptr) && mesh_bounds_.try_emplace(box.mesh).second)
+        {
+            pending.emplace_back(box.mesh);
+        }
+    }
+
+    if (mesh_bodies)
+    {
+        for (const auto &mesh : meshes_)
+        {
+            if (mesh_bounds_.try_emplace(mesh.mesh).second)
+            {
+                pending.emplace_back(mesh.mesh);
+            }
+        }
+    }
+
+    std::vector<iris::Vector3> bounds(pending.size());
+
+    jobs.parallel_for(pending.size(), 1u, [&pending, &bounds](std::size_t index) {
+        const auto [min_point, max_point] = mesh_bounds(pending[index]);
+        bounds[index] = (max_point - min_point) * 0.5f;
+    });
+
+    for (std::size_t i = 0u; i < pending.size(); ++i)
+    {
+        mesh_bounds_[pending[i]] = bounds[i];
+    }
+
+    for (auto &box : boxes_)
+    {
+        if (box.mesh != nullptr)
+        {
+            box.half_extents = mesh_bounds_[box.mesh] * box.half_extents;
+            box.mesh = nullptr;
+        }
+    }
+}
+
+void StaticBodyBuilder::merge(JobSystem &jobs, std::size_t axis)
+{
+    // only boxes which are identical apart from position can merge, group them and work in their local space so the
+    // merge axis is one of the box's own axes
+    std::map<std::tuple<std::string, float, float, float, float, float, float, float>, std::vector<Box>> groups{};
+
+    for (auto &box : boxes_)
+    {
+        const auto &o = box.orientation;
+        const auto &h = box.half_extents;
+        groups[{box.name, o.x, o.y, o.z, o.w, h.x, h.y, h.z}].emplace_back(std::move(box));
+    }
+
+    boxes_.clear();
+
+    const auto other1 = (axis + 1u) % 3u;
+    const auto other2 = (axis + 2u) % 3u;
+
+    std::vector<std::vector<Box> *> inputs{};
+    for (auto &[key, group] : groups)
+    {
+        inputs.emplace_back(&group);
+    }
+
+    // groups are independent, so each one is merged into its own output
+    std::vector<std::vector<Box>> outputs(inputs.size());
+
+    jobs.parallel_for(inputs.size(), 1u, [&](std::size_t index) {
+        const auto &group = *inputs[index];
+        auto &merged = outputs[index];
+
+        const iris::Matrix4 rotation{group.front().orientation};
+        const auto inverse_rotation = iris::Matrix4::invert(rotation);
+
+        std::vector<iris::Vector3> local{};
+        for (const auto &box : group)
+        {
+            local.emplace_back(inverse_rotation * box.position);
+        }
+
+        // sort into rows along the merge axis
+        std::sort(std::begin(local), std::end(local), [&](iris::Vector3 a, iris::Vector3 b) {
+            return std::make_tuple(component(a, other1), component(a, other2), component(a, axis)) <
+                   std::make_tuple(component(b, other1), component(b, other2), component(b, axis));
+        });
+
+        auto half_extents = group.front().half_extents;
+        const auto extent = component(half_extents, axis);
+
+        auto run_start = std::begin(local);
+        while (run_start != std::end(local))
+        {
+            // extend run whilst the next box is in the same row and touches or overlaps the last one
+            auto run_end = std::next(run_start);
+            while ((run_end != std::end(local)) &&
+                   (std::abs(component(*run_end, other1) - component(*run_start, other1)) < merge_epsilon) &&
+                   (std::abs(component(*run_end, other2) - component(*run_start, other2)) < merge_epsilon) &&
+                   ((component(*run_end, axis) - component(*std::prev(run_end), axis)) <=
+                    (extent * 2.0f + merge_epsilon)))
+            {
+                ++run_end;
+            }
+
+            auto first = *run_start;
+            auto last = *std::prev(run_end);
+            auto centre = (first + last) * 0.5f;
+
+            auto merged_extents = half_extents;
+            component(merged_extents, axis) = (component(last, axis) - component(first, axis)) * 0.5f + extent;
+
+            merged.push_back(
+                {.name = group.front().name,
+                 .position = rotation * centre,
+                 .orientation = group.front().orientation,
+                 .half_extents = merged_extents,
+                 .mesh = nullptr});
+
+            run_start = run_end;
+        }
+    });
+
+    for (auto &merged : outputs)
+    {
+        std::move(std::begin(merged), std::end(merged), std::back_inserter(boxes_));
+    }
+}
+
+void StaticBodyBuilder::create_body(
+    const std::string &name,
+    const iris::Vector3 &position,
+    const iris::Quaternion &orientation,
+    const iris::CollisionShape *shape)
+{
+    auto *body = ps_->create_rigid_body(position, shape, iris::RigidBodyType::STATIC);
+    body->reposition(position, orientation);
+    body->set_name(name);
+}
+
+}
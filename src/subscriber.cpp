@@ -6,26 +6,18 @@
 
 #include "subscriber.h"
 
-#include <set>
-
 #include "message_broker.h"
-#include "message_type.h"
+#include "subscription_channel.h"
 
 namespace trinket
 {
 
 Subscriber::~Subscriber()
 {
-    for (const auto message_type : subscribed_)
+    for (const auto &handle : subscriptions_)
     {
-        MessageBroker::instance().unsubscribe(this, message_type);
+        MessageBroker::instance().unsubscribe(handle);
     }
 }
 
-void Subscriber::subscribe(MessageType message_type)
-{
-    MessageBroker::instance().subscribe(this, message_type);
-    subscribed_.emplace(message_type);
-}
-
 }
@@ -6,7 +6,6 @@
 
 #include "third_person_camera.h"
 
-#include <any>
 #include <cstdint>
 
 #include "iris/core/camera_type.h"
@@ -20,33 +19,42 @@
 #include "iris/physics/ray_cast_result.h"
 
 #include "maths.h"
+#include "message_data.h"
+#include "message_type.h"
 #include "player.h"
+#include "transform_interpolator.h"
 
 namespace trinket
 {
 
-ThirdPersonCamera::ThirdPersonCamera(Player *player, std::uint32_t width, std::uint32_t height, iris::PhysicsSystem *ps)
+ThirdPersonCamera::ThirdPersonCamera(Player *player, std::uint32_t width, std::uint32_t height)
     : player_(player)
     , camera_(iris::CameraType::PERSPECTIVE, width, height, 10000u)
     , key_map_()
     , azimuth_(pi_2)
     , altitude_(pi_4 / 2.0f)
     , camera_distance_(20.0f)
-    , ps_(ps)
+    , ps_(nullptr)
 {
+    camera_.set_position({0.0f, 0.0f, 800.0f});
+    camera_.set_pitch(-altitude_);
+
+    subscribe<MessageType::MOUSE_MOVE>(this);
+    subscribe<MessageType::KEY_PRESS>(this);
+    subscribe<MessageType::SCROLL_WHEEL>(this);
+}
+
+void ThirdPersonCamera::bind(iris::PhysicsSystem *ps)
+{
+    ps_ = ps;
+
+    // any held keys were released whilst loading
     key_map_ = {
         {iris::Key::W, iris::KeyState::UP},
         {iris::Key::A, iris::KeyState::UP},
         {iris::Key::S, iris::KeyState::UP},
         {iris::Key::D, iris::KeyState::UP},
     };
-
-    camera_.set_position({0.0f, 0.0f, 800.0f});
-    camera_.set_pitch(-altitude_);
-
-    subscribe(MessageType::MOUSE_MOVE);
-    subscribe(MessageType::KEY_PRESS);
-    subscribe(MessageType::SCROLL_WHEEL);
 }
 
 void ThirdPersonCamera::update(std::chrono::microseconds)
@@ -138,6 +146,16 @@ void ThirdPersonCamera::update(std::chrono::microseconds)
     }
 }
 
+UpdatePhase ThirdPersonCamera::update_phase() const
+{
+    return UpdatePhase::CAMERA;
+}
+
+void ThirdPersonCamera::add_interpolated(TransformInterpolator &interpolator)
+{
+    interpolator.add(&camera_);
+}
+
 iris::Camera *ThirdPersonCamera::camera()
 {
     return &camera_;
@@ -148,48 +166,39 @@ const iris::Camera *ThirdPersonCamera::camera() const
     return &camera_;
 }
 
-void ThirdPersonCamera::handle_message(MessageType message_type, const std::any &data)
+void ThirdPersonCamera::handle_message(const Message<MessageType::MOUSE_MOVE> &message)
 {
-    switch (message_type)
-    {
-        case MessageType::MOUSE_MOVE:
-        {
-            static const auto sensitivity = 0.0025f;
-            const auto mouse = std::any_cast<iris::MouseEvent>(data);
+    static const auto sensitivity = 0.0025f;
+    const auto &mouse = message.data;
 
-            //  adjust camera azimuth and ensure we are still pointing at the player
-            azimuth_ += mouse.delta_x * sensitivity;
-            camera_.adjust_yaw(mouse.delta_x * sensitivity);
+    //  adjust camera azimuth and ensure we are still pointing at the player
+    azimuth_ += mouse.delta_x * sensitivity;
+    camera_.adjust_yaw(mouse.delta_x * sensitivity);
 
-            static constexpr auto offset = 0.01f;
+    static constexpr auto offset = 0.01f;
 
-            // adjust camera altitude and ensure we are still pointing at the player
-            // we clamp the altitude [0, pi/2] to ensure no weirdness happens
-            altitude_ += mouse.delta_y * sensitivity;
-            altitude_ = std::clamp(altitude_, 0.0f, pi_2 - offset);
+    // adjust camera altitude and ensure we are still pointing at the player
+    // we clamp the altitude [0, pi/2] to ensure no weirdness happens
+    altitude_ += mouse.delta_y * sensitivity;
+    altitude_ = std::clamp(altitude_, 0.0f, pi_2 - offset);
 
-            camera_.set_pitch(-altitude_);
+    camera_.set_pitch(-altitude_);
+}
 
-            break;
-        }
-        case MessageType::KEY_PRESS:
-        {
-            const auto key = std::any_cast<iris::KeyboardEvent>(data);
-            key_map_.insert_or_assign(key.key, key.state);
+void ThirdPersonCamera::handle_message(const Message<MessageType::KEY_PRESS> &message)
+{
+    const auto &key = message.data;
+    key_map_.insert_or_assign(key.key, key.state);
+}
 
-            break;
-        }
-        case MessageType::SCROLL_WHEEL:
-        {
-            const auto scroll = std::any_cast<iris::ScrollWheelEvent>(data);
-            camera_distance_ += scroll.delta_y * -1.5f;
+void ThirdPersonCamera::handle_message(const Message<MessageType::SCROLL_WHEEL> &message)
+{
+    const auto &scroll = message.data;
+    camera_distance_ += scroll.delta_y * -1.5f;
 
-            static constexpr auto max_distance = 100.0f;
-            static constexpr auto min_distance = 5.0f;
-            camera_distance_ = std::clamp(camera_distance_, min_distance, max_distance);
-        }
-        default: break;
-    }
+    static constexpr auto max_distance = 100.0f;
+    static constexpr auto min_distance = 5.0f;
+    camera_distance_ = std::clamp(camera_distance_, min_distance, max_distance);
 }
 
 }
@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "transform_interpolator.h"
+
+#include "iris/core/camera.h"
+#include "iris/core/transform.h"
+#include "iris/core/vector3.h"
+#include "iris/graphics/render_entity.h"
+
+namespace
+{
+
+/**
+ * Get the transform of an entity.
+ *
+ * @param entity
+ *   Entity to get transform of.
+ *
+ * @returns
+ *   Transform of entity.
+ */
+iris::Transform transform_of(const iris::RenderEntity *entity)
+{
+    return {entity->position(), entity->orientation(), entity->scale()};
+}
+
+/**
+ * Set the transform of an entity.
+ *
+ * @param entity
+ *   Entity to set transform of.
+ *
+ * @param transform
+ *   New transform.
+ */
+void set_transform_of(iris::RenderEntity *entity, const iris::Transform &transform)
+{
+    entity->set_position(transform.translation());
+    entity->set_orientation(transform.rotation());
+    entity->set_scale(transform.scale());
+}
+
+}
+
+namespace trinket
+{
+
+TransformInterpolator::TransformInterpolator()
+    : entities_()
+    , cameras_()
+{
+}
+
+void TransformInterpolator::add(iris::RenderEntity *entity)
+{
+    const auto transform = transform_of(entity);
+    entities_.push_back({entity, transform, transform});
+}
+
+void TransformInterpolator::add(iris::Camera *camera)
+{
+    const auto position = camera->position();
+    cameras_.push_back({camera, position, position});
+}
+
+void TransformInterpolator::begin_tick()
+{
+    for (const auto &[entity, previous, current] : entities_)
+    {
+        set_transform_of(entity, current);
+    }
+
+    for (const auto &[camera, previous, current] : cameras_)
+    {
+        camera->set_position(current);
+    }
+}
+
+void TransformInterpolator::end_tick()
+{
+    for (auto &[entity, previous, current] : entities_)
+    {
+        previous = current;
+        current = transform_of(entity);
+    }
+
+    for (auto &[camera, previous, current] : cameras_)
+    {
+        previous = current;
+        current = camera->position();
+    }
+}
+
+void TransformInterpolator::interpolate(float alpha)
+{
+    for (const auto &[entity, previous, current] : entities_)
+    {
+        auto transform = previous;
+        transform.interpolate(current, alpha);
+        set_transform_of(entity, transform);
+    }
+
+    for (const auto &[camera, previous, current] : cameras_)
+    {
+        camera->set_position(previous + ((current - previous) * alpha));
+    }
+}
+
+}
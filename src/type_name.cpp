@@ -0,0 +1,38 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "type_name.h"
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <typeinfo>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+namespace trinket
+{
+
+std::string type_name(const std::type_info &type)
+{
+#if defined(__GNUG__)
+    // gcc and clang return mangled names
+    auto status = 0;
+    std::unique_ptr<char, decltype(&std::free)> demangled{
+        abi::__cxa_demangle(type.name(), nullptr, nullptr, &status), &std::free};
+
+    if ((status == 0) && (demangled != nullptr))
+    {
+        return demangled.get();
+    }
+#endif
+
+    return type.name();
+}
+
+}
@@ -7,6 +7,7 @@
 #include "yaml_config.h"
 
 #include <cstdint>
+#include <map>
 #include <string>
 #include <variant>
 #include <vector>
@@ -47,8 +48,30 @@ YamlConfig::YamlConfig(const std::string &config_file)
     options_[ConfigOption::SCREEN_HEIGHT] = yaml_config["screen_height"].as<std::uint32_t>();
     options_[ConfigOption::GRAPHICS_API] = yaml_config["graphics_api"].as<std::string>();
     options_[ConfigOption::PHYSICS_DEBUG_DRAW] = yaml_config["physics_debug_draw"].as<bool>();
-    options_[ConfigOption::ZONE_LOADERS] = yaml_config["zones"].as<std::vector<std::string>>();
+    options_[ConfigOption::ZONE_LOADERS] = yaml_config["zones"].as<std::map<std::string, std::string>>();
     options_[ConfigOption::STARTING_ZONE] = yaml_config["starting_zone"].as<std::string>();
+    options_[ConfigOption::QUEUED_MESSAGES] = yaml_config["queued_messages"].as<bool>();
+    options_[ConfigOption::MESSAGE_STATS] = yaml_config["message_stats"].as<bool>();
+    options_[ConfigOption::COALESCE_INPUT] = yaml_config["coalesce_input"].as<bool>();
+    options_[ConfigOption::WORKER_THREADS] = yaml_config["worker_threads"].as<std::uint32_t>();
+    options_[ConfigOption::TICK_RATE] = yaml_config["tick_rate"].as<std::uint32_t>();
+    options_[ConfigOption::HEADLESS] = yaml_config["headless"].as<bool>();
+    options_[ConfigOption::HEADLESS_REALTIME] = yaml_config["headless_realtime"].as<bool>();
+    options_[ConfigOption::HEADLESS_TICKS] = yaml_config["headless_ticks"].as<std::uint32_t>();
+    options_[ConfigOption::PROFILER] = yaml_config["profiler"].as<bool>();
+    options_[ConfigOption::ASSET_CACHE_MB] = yaml_config["asset_cache_mb"].as<std::uint32_t>();
+    options_[ConfigOption::MERGE_STATIC_BODIES] = yaml_config["merge_static_bodies"].as<bool>();
+    options_[ConfigOption::CELL_CULLING] = yaml_config["cell_culling"].as<bool>();
+    options_[ConfigOption::CELL_SIZE] = yaml_config["cell_size"].as<std::uint32_t>();
+    options_[ConfigOption::ACTIVE_CELL_RADIUS] = yaml_config["active_cell_radius"].as<std::uint32_t>();
+    options_[ConfigOption::AI_LOD] = yaml_config["ai_lod"].as<bool>();
+    options_[ConfigOption::AI_NEAR_DISTANCE] = yaml_config["ai_near_distance"].as<std::uint32_t>();
+    options_[ConfigOption::AI_FAR_DISTANCE] = yaml_config["ai_far_distance"].as<std::uint32_t>();
+    options_[ConfigOption::AI_MID_INTERVAL] = yaml_config["ai_mid_interval"].as<std::uint32_t>();
+    options_[ConfigOption::AI_FAR_BUDGET_US] = yaml_config["ai_far_budget_us"].as<std::uint32_t>();
+    options_[ConfigOption::NAVIGATION] = yaml_config["navigation"].as<bool>();
+    options_[ConfigOption::NAV_CELL_SIZE] = yaml_config["nav_cell_size"].as<std::uint32_t>();
+    options_[ConfigOption::NAV_MAX_DISTANCE] = yaml_config["nav_max_distance"].as<std::uint32_t>();
 }
 
 std::string YamlConfig::string_option(ConfigOption option)
@@ -66,9 +89,19 @@ bool YamlConfig::bool_option(ConfigOption option)
     return get_config_option<bool>(options_, option);
 }
 
+void YamlConfig::set_bool_option(ConfigOption option, bool value)
+{
+    options_[option] = value;
+}
+
 std::vector<std::string> YamlConfig::string_array_option(ConfigOption option)
 {
     return get_config_option<std::vector<std::string>>(options_, option);
 }
 
+std::map<std::string, std::string> YamlConfig::string_map_option(ConfigOption option)
+{
+    return get_config_option<std::map<std::string, std::string>>(options_, option);
+}
+
 }
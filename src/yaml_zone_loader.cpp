@@ -7,37 +7,49 @@
 #include "yaml_zone_loader.h"
 
 #include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "iris/core/error_handling.h"
 #include "iris/core/quaternion.h"
 #include "iris/core/resource_loader.h"
 #include "iris/core/root.h"
+#include "iris/core/transform.h"
 #include "iris/core/vector3.h"
 #include "iris/graphics/mesh_manager.h"
-#include "iris/graphics/render_graph/arithmetic_node.h"
 #include "iris/graphics/render_graph/render_graph.h"
 #include "iris/graphics/render_graph/texture_node.h"
-#include "iris/graphics/render_graph/value_node.h"
-#include "iris/graphics/render_graph/vertex_node.h"
 #include "iris/graphics/scene.h"
 #include "iris/graphics/single_entity.h"
 #include "iris/graphics/skeleton.h"
 #include "iris/graphics/texture_manager.h"
-#include "iris/graphics/vertex_data.h"
 #include "iris/log/log.h"
-#include "iris/physics/collision_shape.h"
 #include "iris/physics/physics_manager.h"
 #include "iris/physics/physics_system.h"
 
 #include "yaml-cpp/yaml.h"
 
+#include "asset_cache.h"
 #include "enemy.h"
 #include "game_object.h"
+#include "job_system.h"
+#include "material_cache.h"
+#include "native_ai.h"
+#include "native_ai_updater.h"
+#include "nav_grid.h"
 #include "player.h"
+#include "script_pool.h"
+#include "stage_timer.h"
+#include "static_body_builder.h"
 #include "third_person_camera.h"
+#include "zone_cells.h"
 
 namespace
 {
@@ -52,48 +64,61 @@ iris::Quaternion get_quaternion(const YAML::Node &node)
     return {node[0].as<float>(), node[1].as<float>(), node[2].as<float>()};
 }
 
-iris::Vector3 bounding_box(const iris::Mesh *mesh, const iris::Vector3 &scale)
+/**
+ * Static geometry entry parsed out of the zone file, so the YAML walk is separate from loading.
+ */
+struct StaticGeometry
 {
-    const auto min_max_x = std::minmax_element(
-        std::cbegin(mesh->vertices()),
-        std::cend(mesh->vertices()),
-        [](const iris::VertexData &a, const iris::VertexData &b) { return a.position.x < b.position.x; });
-
-    const auto min_max_y = std::minmax_element(
-        std::cbegin(mesh->vertices()),
-        std::cend(mesh->vertices()),
-        [](const iris::VertexData &a, const iris::VertexData &b) { return a.position.y < b.position.y; });
-
-    const auto min_max_z = std::minmax_element(
-        std::cbegin(mesh->vertices()),
-        std::cend(mesh->vertices()),
-        [](const iris::VertexData &a, const iris::VertexData &b) { return a.position.z < b.position.z; });
-
-    const iris::Vector3 min_point{
-        min_max_x.first->position.x, min_max_y.first->position.y, min_max_z.first->position.z};
-    const iris::Vector3 max_point{
-        min_max_x.second->position.x, min_max_y.second->position.y, min_max_z.second->position.z};
-
-    return (max_point - min_point) * 0.5f * scale;
-}
+    /** Mesh resource name, or "cube". */
+    std::string mesh_type;
+
+    /** World position. */
+    iris::Vector3 position;
+
+    /** Orientation. */
+    iris::Quaternion orientation;
+
+    /** Scale. */
+    iris::Vector3 scale;
+
+    /** Colour texture for each mesh part, empty if untextured. */
+    std::vector<std::string> textures;
+
+    /** Normal texture, empty if none. */
+    std::string normal;
+
+    /** UV scale of colour textures, 0 if unscaled. */
+    float texture_scale;
+
+    /** Flag indicating if geometry has a rigid body. */
+    bool rigid_body;
+
+    /** Flag indicating if rigid body is the mesh's bounding box, rather than the mesh itself. */
+    bool bounding_box;
+};
 
 }
 
 namespace trinket
 {
 
-YamlZoneLoader::YamlZoneLoader(const std::string &zone_file)
+YamlZoneLoader::YamlZoneLoader(const std::string &zone_file, bool merge_static_bodies)
     : yaml_file_()
+    , name_()
+    , merge_static_bodies_(merge_static_bodies)
+    , preload_steps_()
+    , next_preload_step_(0u)
 {
     const auto config_file_data = iris::ResourceLoader::instance().load(zone_file);
     std::string config_file_str(reinterpret_cast<const char *>(config_file_data.data()), config_file_data.size());
 
     yaml_file_ = ::YAML::Load(config_file_str);
+    name_ = yaml_file_["name"].as<std::string>();
 }
 
 std::string YamlZoneLoader::name()
 {
-    return yaml_file_["name"].as<std::string>();
+    return name_;
 }
 
 iris::Vector3 YamlZoneLoader::player_start_position()
@@ -104,136 +129,194 @@ iris::Vector3 YamlZoneLoader::player_start_position()
 void YamlZoneLoader::load_static_geometry(
     iris::PhysicsSystem *ps,
     iris::Scene *scene,
-    iris::RenderPipeline &render_pipeline)
+    iris::RenderPipeline *render_pipeline,
+    ZoneCells &cells,
+    NavGrid &nav,
+    JobSystem &jobs)
 {
-    std::unordered_map<const iris::Mesh *, std::vector<iris::Transform>> instances{};
-    std::unordered_map<const iris::Mesh *, iris::RenderGraph *> render_graphs{};
+    // if headless then we have no mesh data, so only geometry with a collision shape we can create without a mesh can
+    // be loaded
+    if (scene == nullptr)
+    {
+        load_headless_geometry(ps, nav, jobs);
+        return;
+    }
+
+    StageTimer timer{name_ + " static geometry", jobs.worker_count() + 1u};
+    timer.start("parse");
+
+    // yaml-cpp isn't thread safe, so the zone file is walked once up front
+    std::vector<StaticGeometry> entries{};
 
     for (const auto &geometry : yaml_file_["static_geometry"])
     {
-        const auto position = get_vector3(geometry["position"]);
-        const auto orientation = get_quaternion(geometry["orientation"]);
-        const auto scale = get_vector3(geometry["scale"]);
-        const auto mesh_type = geometry["mesh_type"].as<std::string>();
+        auto &entry = entries.emplace_back(StaticGeometry{
+            .mesh_type = geometry["mesh_type"].as<std::string>(),
+            .position = get_vector3(geometry["position"]),
+            .orientation = get_quaternion(geometry["orientation"]),
+            .scale = get_vector3(geometry["scale"]),
+            .textures = {},
+            .normal = geometry["normal"] ? geometry["normal"].as<std::string>() : std::string{},
+            .texture_scale = geometry["texture_scale"] ? geometry["texture_scale"].as<float>() : 0.0f,
+            .rigid_body = geometry["rigid_body"].as<bool>(),
+            .bounding_box = false});
+
+        for (const auto &texture : geometry["texture"])
+        {
+            entry.textures.emplace_back(texture.as<std::string>());
+        }
+
+        if (entry.rigid_body)
+        {
+            entry.bounding_box = geometry["rigid_body_type"].as<std::string>() == "bounding_box";
+        }
+    }
 
+    timer.start("upload");
+
+    // instances are collected as (mesh, material, transform), so they can be grouped into as few entities as possible
+    std::vector<std::tuple<const iris::Mesh *, iris::RenderGraph *, iris::Transform>> instances{};
+    MaterialCache materials{render_pipeline};
+    StaticBodyBuilder bodies{ps, merge_static_bodies_};
+
+    // the engine decodes and uploads assets in one step and isn't thread safe, so this has to be on the main thread
+    for (const auto &entry : entries)
+    {
         std::vector<const iris::Mesh *> meshes{};
 
-        if (mesh_type == "cube")
+        if (entry.mesh_type == "cube")
         {
             meshes.push_back(iris::Root::mesh_manager().cube({}));
         }
         else
         {
-            const auto mesh_data = iris::Root::mesh_manager().load_mesh(mesh_type).mesh_data;
+            const auto mesh_data = AssetCache::instance().mesh(entry.mesh_type).mesh_data;
             std::transform(
                 std::begin(mesh_data), std::end(mesh_data), std::back_inserter(meshes), [](const auto &element) {
                     return element.mesh;
                 });
         }
 
-        int tex_count = 0u;
-
-        for (const auto *mesh : meshes)
+        for (std::size_t i = 0u; i < meshes.size(); ++i)
         {
-            instances[mesh].emplace_back(position, orientation, scale);
-            render_graphs.try_emplace(mesh, nullptr);
+            const auto *mesh = meshes[i];
+            iris::RenderGraph *render_graph = nullptr;
 
-            if (geometry["texture"])
+            if (!entry.textures.empty())
             {
-                const auto texture_name = geometry["texture"][tex_count].as<std::string>();
-                ++tex_count;
-
-                render_graphs[mesh] = render_pipeline.create_render_graph();
-                iris::TextureNode *texture_node = nullptr;
-
-                if (geometry["texture_scale"])
-                {
-                    auto *rg = render_graphs[mesh];
-                    texture_node = rg->create<iris::TextureNode>(
-                        texture_name,
-                        iris::TextureUsage::IMAGE,
-                        nullptr,
-                        iris::UVSource::NODE,
-                        rg->create<iris::ArithmeticNode>(
-                            rg->create<iris::VertexNode>(iris::VertexDataType::UV),
-                            rg->create<iris::ValueNode<iris::Vector3>>(
-                                iris::Vector3{geometry["texture_scale"].as<float>()}),
-                            iris::ArithmeticOperator::MULTIPLY));
-                }
-                else
-                {
-                    const auto *sampler = iris::Root::texture_manager().create(iris::SamplerDescriptor{
-                        .minification_filter = iris::SamplerFilter::NEAREST,
-                        .magnification_filter = iris::SamplerFilter::NEAREST,
-                        .uses_mips = false,
-                        .mip_filter = iris::SamplerFilter::LINEAR});
-                    texture_node = render_graphs[mesh]->create<iris::TextureNode>(
-                        texture_name, iris::TextureUsage::IMAGE, sampler);
-                }
-
-                render_graphs[mesh]->render_node()->set_colour_input(texture_node);
-
-                if (geometry["normal"])
-                {
-                    const auto normal_name = geometry["normal"].as<std::string>();
-                    auto *normal_node = render_graphs[mesh]->create<iris::TextureNode>(normal_name);
-                    render_graphs[mesh]->render_node()->set_normal_input(normal_node);
-                }
+                render_graph = materials.material(entry.textures.at(i), entry.texture_scale, entry.normal, true);
             }
 
-            if (geometry["rigid_body"].as<bool>())
+            instances.emplace_back(
+                mesh, render_graph, iris::Transform{entry.position, entry.orientation, entry.scale});
+
+            if (!entry.rigid_body)
             {
-                const auto *collision_shape = geometry["rigid_body_type"].as<std::string>() == "bounding_box"
-                                                  ? ps->create_box_collision_shape(bounding_box(mesh, scale))
-                                                  : ps->create_mesh_collision_shape(mesh, scale);
-                auto *body = ps->create_rigid_body(position, collision_shape, iris::RigidBodyType::STATIC);
-                body->reposition(position, orientation);
-                body->set_name(mesh_type);
+                continue;
+            }
+
+            if (entry.bounding_box)
+            {
+                bodies.add_bounding_box(entry.mesh_type, mesh, entry.position, entry.orientation, entry.scale);
+            }
+            else
+            {
+                bodies.add_mesh(entry.mesh_type, mesh, entry.position, entry.orientation, entry.scale);
             }
         }
     }
 
-    for (const auto &[mesh, transforms] : instances)
+    timer.start("shapes");
+    bodies.build(jobs, nav);
+
+    timer.start("cells");
+
+    for (const auto &[mesh, render_graph, transform] : instances)
     {
-        if (transforms.size() == 1)
-        {
-            scene->create_entity<iris::SingleEntity>(render_graphs[mesh], mesh, transforms.front());
-        }
-        else
-        {
-            scene->create_entity<iris::InstancedEntity>(render_graphs[mesh], mesh, transforms);
-        }
+        cells.add(render_graph, mesh, transform);
     }
+
+    timer.log();
+
+    LOG_INFO(
+        "zone",
+        "{}: {} render graphs for {} textured mesh parts, {} static instances",
+        name_,
+        materials.graphs(),
+        materials.requests(),
+        instances.size());
 }
 
 void YamlZoneLoader::load_enemies(
     iris::PhysicsSystem *ps,
     iris::Scene *scene,
-    iris::RenderPipeline &render_pipeline,
+    iris::RenderPipeline *render_pipeline,
     std::vector<std::unique_ptr<GameObject>> &game_objects,
     Player *player,
-    ThirdPersonCamera *camera)
+    ThirdPersonCamera *camera,
+    const NavGrid &nav,
+    ScriptPool &scripts,
+    JobSystem &jobs)
 {
+    StageTimer timer{name_ + " enemies", jobs.worker_count() + 1u};
+    timer.start("scripts");
+
+    std::vector<std::string> script_files{};
+    for (const auto &enemy : yaml_file_["enemies"])
+    {
+        script_files.emplace_back(enemy["script"].as<std::string>());
+    }
+
+    scripts.load(script_files, jobs);
+
+    // native enemies are decided for in a single batch, which has to be updated before any of them
+    NativeAi *native_ai = nullptr;
+    if (std::ranges::any_of(script_files, [](const std::string &file) { return is_native_ai(file); }))
+    {
+        auto updater = std::make_unique<NativeAiUpdater>(player, nav);
+        native_ai = &updater->ai();
+        game_objects.emplace_back(std::move(updater));
+    }
+
+    timer.start("create");
+
     for (const auto &enemy : yaml_file_["enemies"])
     {
         const auto position = get_vector3(enemy["position"]);
         const auto orientation = get_quaternion(enemy["orientation"]);
         const auto scale = get_vector3(enemy["scale"]);
 
+        const auto script_file = enemy["script"].as<std::string>();
         const auto bounds_min = get_vector3(enemy["bounds_min"]);
         const auto bounds_max = get_vector3(enemy["bounds_max"]);
+        auto ai = is_native_ai(script_file) ? native_ai->create(script_file, position, bounds_min, bounds_max)
+                                            : scripts.create(script_file, bounds_min, bounds_max);
+
+        if (scene == nullptr)
+        {
+            // headless so no render entities or animations
+            game_objects.emplace_back(std::make_unique<Enemy>(
+                ps,
+                std::move(ai),
+                position,
+                nullptr,
+                nullptr,
+                std::vector<iris::Animation>{},
+                player,
+                nav,
+                camera));
+            continue;
+        }
 
         const auto mesh_name = enemy["mesh"].as<std::string>();
-        const auto mesh_data = iris::Root::mesh_manager().load_mesh(mesh_name);
+        const auto mesh_data = AssetCache::instance().mesh(mesh_name);
         iris::expect(mesh_data.mesh_data.size() == 1u, "expecting only one mesh");
         const auto texture_name = enemy["texture"].as<std::string>();
 
-        auto render_graph = render_pipeline.create_render_graph();
-        auto *texture_node = render_graph->create<iris::TextureNode>(texture_name);
+        auto render_graph = render_pipeline->create_render_graph();
+        auto *texture_node = render_graph->create<iris::TextureNode>(AssetCache::instance().texture(texture_name));
         render_graph->render_node()->set_colour_input(texture_node);
 
-        const auto script_file = enemy["script"].as<std::string>();
-
         auto *health_bar = scene->create_entity<iris::SingleEntity>(
             nullptr,
             iris::Root::mesh_manager().sprite({1.0f, 0.0f, 0.0f}),
@@ -245,17 +328,168 @@ void YamlZoneLoader::load_enemies(
             iris::Transform(position, orientation, scale),
             mesh_data.skeleton);
         game_objects.emplace_back(std::make_unique<Enemy>(
-            ps, script_file, entity, health_bar, mesh_data.animations, bounds_min, bounds_max, player, camera));
+            ps,
+            std::move(ai),
+            position,
+            entity,
+            health_bar,
+            mesh_data.animations,
+            player,
+            nav,
+            camera));
+    }
+
+    timer.log();
+}
+
+void YamlZoneLoader::load_headless_geometry(iris::PhysicsSystem *ps, NavGrid &nav, JobSystem &jobs)
+{
+    StaticBodyBuilder bodies{ps, merge_static_bodies_};
+    auto needs_mesh = 0u;
+
+    for (const auto &geometry : yaml_file_["static_geometry"])
+    {
+        if (geometry["rigid_body"].as<bool>() && (geometry["mesh_type"].as<std::string>() != "cube"))
+        {
+            ++needs_mesh;
+        }
+    }
+
+    // a cube's collision shape is just its scale, anything else needs the vertices of its mesh, without those walls
+    // would be missing from physics and navigation and the simulation wouldn't be representative of the real game
+    iris::ensure(
+        needs_mesh == 0u,
+        name_ + ": " + std::to_string(needs_mesh) +
+            " rigid bodies need mesh data, headless mode needs cooked zones (run trinket_zone_cook)");
+
+    for (const auto &geometry : yaml_file_["static_geometry"])
+    {
+        if (!geometry["rigid_body"].as<bool>())
+        {
+            continue;
+        }
+
+        const auto mesh_type = geometry["mesh_type"].as<std::string>();
+
+        const auto position = get_vector3(geometry["position"]);
+        const auto orientation = get_quaternion(geometry["orientation"]);
+        const auto scale = get_vector3(geometry["scale"]);
+
+        bodies.add_box(mesh_type, position, orientation, scale);
+    }
+
+    bodies.build(jobs, nav);
+}
+
+std::vector<std::string> YamlZoneLoader::resource_files()
+{
+    std::set<std::string> files{};
+
+    for (const auto &geometry : yaml_file_["static_geometry"])
+    {
+        if (const auto mesh_type = geometry["mesh_type"].as<std::string>(); mesh_type != "cube")
+        {
+            files.emplace(mesh_type);
+        }
+
+        for (const auto &texture : geometry["texture"])
+        {
+            files.emplace(texture.as<std::string>());
+        }
+
+        if (geometry["normal"])
+        {
+            files.emplace(geometry["normal"].as<std::string>());
+        }
     }
+
+    for (const auto &enemy : yaml_file_["enemies"])
+    {
+        files.emplace(enemy["mesh"].as<std::string>());
+        files.emplace(enemy["texture"].as<std::string>());
+        if (const auto script = enemy["script"].as<std::string>(); !is_native_ai(script))
+        {
+            files.emplace(script);
+        }
+    }
+
+    return {std::cbegin(files), std::cend(files)};
+}
+
+void YamlZoneLoader::begin_preload()
+{
+    // the steps only depend on zone data so are kept, but every one is run again
+    next_preload_step_ = 0u;
+}
+
+bool YamlZoneLoader::preload_step()
+{
+    if (preload_steps_.empty())
+    {
+        // work out everything that needs loading, textures have to be loaded with the same sampler that
+        // load_static_geometry will use as the texture manager caches by name
+        std::set<std::string> meshes{};
+        std::map<std::string, bool> textures{};
+        std::set<std::string> scripts{};
+
+        for (const auto &geometry : yaml_file_["static_geometry"])
+        {
+            if (const auto mesh_type = geometry["mesh_type"].as<std::string>(); mesh_type != "cube")
+            {
+                meshes.emplace(mesh_type);
+            }
+
+            for (const auto &texture : geometry["texture"])
+            {
+                textures.emplace(texture.as<std::string>(), !geometry["texture_scale"]);
+            }
+
+            if (geometry["normal"])
+            {
+                textures.emplace(geometry["normal"].as<std::string>(), false);
+            }
+        }
+
+        for (const auto &enemy : yaml_file_["enemies"])
+        {
+            meshes.emplace(enemy["mesh"].as<std::string>());
+            textures.emplace(enemy["texture"].as<std::string>(), false);
+            if (const auto script = enemy["script"].as<std::string>(); !is_native_ai(script))
+            {
+                scripts.emplace(script);
+            }
+        }
+
+        for (const auto &mesh : meshes)
+        {
+            preload_steps_.emplace_back([mesh] { AssetCache::instance().mesh(mesh); });
+        }
+
+        for (const auto &[texture, nearest] : textures)
+        {
+            preload_steps_.emplace_back([texture, nearest] {
+                AssetCache::instance().texture(texture, nearest ? MaterialCache::nearest_sampler() : nullptr);
+            });
+        }
+
+        for (const auto &script : scripts)
+        {
+            preload_steps_.emplace_back([script] { iris::ResourceLoader::instance().load(script); });
+        }
+    }
+
+    if (next_preload_step_ < preload_steps_.size())
+    {
+        preload_steps_[next_preload_step_]();
+        ++next_preload_step_;
+    }
+
+    return next_preload_step_ < preload_steps_.size();
 }
 
 std::tuple<iris::Transform, std::string> YamlZoneLoader::portal()
 {
-    const auto n = yaml_file_["name"].as<std::string>();
     const auto &portal = yaml_file_["portal"];
-    const auto p = portal["position"];
-    const auto s = portal["scale"];
-    const auto d = portal["destination"];
 
     return {
         iris::Transform{get_vector3(portal["position"]), {}, get_vector3(portal["scale"])},
@@ -0,0 +1,331 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "zone_cells.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "iris/core/camera.h"
+#include "iris/core/matrix4.h"
+#include "iris/core/transform.h"
+#include "iris/core/vector3.h"
+#include "iris/graphics/instanced_entity.h"
+#include "iris/graphics/mesh.h"
+#include "iris/graphics/render_entity.h"
+#include "iris/graphics/scene.h"
+#include "iris/graphics/single_entity.h"
+#include "iris/log/log.h"
+
+#include "mesh_bounds.h"
+#include "profiler.h"
+
+namespace
+{
+
+/** Number of updates a cell stays in the scene after it was last visible. */
+constexpr std::uint64_t hide_delay = 60u;
+
+/**
+ * Get the absolute value of each component of a vector.
+ *
+ * @param vector
+ *   Vector to get absolute value of.
+ *
+ * @returns
+ *   Absolute vector.
+ */
+iris::Vector3 abs(const iris::Vector3 &vector)
+{
+    return {std::abs(vector.x), std::abs(vector.y), std::abs(vector.z)};
+}
+
+/**
+ * Get the furthest any point in a box can be from the origin, whatever the box's orientation.
+ *
+ * @param min
+ *   Minimum corner of box.
+ *
+ * @param max
+ *   Maximum corner of box.
+ *
+ * @returns
+ *   Radius of box about the origin.
+ */
+float radius(const iris::Vector3 &min, const iris::Vector3 &max)
+{
+    const auto furthest = abs(min);
+    const auto other = abs(max);
+
+    return iris::Vector3{std::max(furthest.x, other.x), std::max(furthest.y, other.y), std::max(furthest.z, other.z)}
+        .magnitude();
+}
+
+}
+
+namespace trinket
+{
+
+ZoneCells::ZoneCells(iris::Scene *scene, float cell_size, std::uint32_t active_radius, bool enabled)
+    : scene_(scene)
+    , cell_size_(cell_size)
+    , active_radius_(static_cast<std::int32_t>(active_radius))
+    , enabled_(enabled)
+    , cells_()
+    , global_instances_()
+    , global_entities_()
+    , mesh_radii_()
+    , player_cell_()
+    , frustum_()
+    , has_frustum_(false)
+    , updates_(0u)
+    , visible_cells_total_(0u)
+    , visible_entities_total_(0u)
+    , active_objects_total_(0u)
+    , objects_total_(0u)
+    , cells_shown_(0u)
+{
+}
+
+void ZoneCells::add(iris::RenderGraph *render_graph, const iris::Mesh *mesh, const iris::Transform &transform)
+{
+    auto [mesh_radius, inserted] = mesh_radii_.try_emplace(mesh, 0.0f);
+    if (inserted)
+    {
+        const auto [min_point, max_point] = mesh_bounds(mesh);
+        mesh_radius->second = radius(min_point, max_point);
+    }
+
+    const auto scale = abs(transform.scale());
+    const auto instance_radius = mesh_radius->second * std::max({scale.x, scale.y, scale.z});
+
+    if (!enabled_ || (instance_radius > cell_size_))
+    {
+        global_instances_[{mesh, render_graph}].emplace_back(transform);
+        return;
+    }
+
+    const auto position = transform.translation();
+    auto [cell, created] = cells_.try_emplace(cell_key(position));
+    if (created)
+    {
+        cell->second.min_y = position.y;
+        cell->second.max_y = position.y;
+        cell->second.max_radius = 0.0f;
+        cell->second.last_visible = 0u;
+    }
+
+    cell->second.instances[{mesh, render_graph}].emplace_back(transform);
+    cell->second.min_y = std::min(cell->second.min_y, position.y);
+    cell->second.max_y = std::max(cell->second.max_y, position.y);
+    cell->second.max_radius = std::max(cell->second.max_radius, instance_radius);
+}
+
+void ZoneCells::set_mesh_bounds(const iris::Mesh *mesh, const iris::Vector3 &min, const iris::Vector3 &max)
+{
+    mesh_radii_[mesh] = radius(min, max);
+}
+
+void ZoneCells::build()
+{
+    create_entities(global_instances_, global_entities_);
+
+    std::size_t instances = 0u;
+    for (const auto &[key, cell] : cells_)
+    {
+        for (const auto &[group, transforms] : cell.instances)
+        {
+            instances += transforms.size();
+        }
+    }
+
+    LOG_INFO(
+        "zone",
+        "{} cells with {} static instances, {} always visible entities",
+        cells_.size(),
+        instances,
+        global_entities_.size());
+}
+
+void ZoneCells::update(const iris::Vector3 &player_position, const iris::Camera *camera)
+{
+    TRINKET_PROFILE_SCOPE("cull");
+
+    ++updates_;
+    player_cell_ = cell_key(player_position);
+    has_frustum_ = false;
+
+    if (!enabled_)
+    {
+        visible_entities_total_ += global_entities_.size();
+        return;
+    }
+
+    if (camera != nullptr)
+    {
+        // extract planes from the combined matrix (Gribb & Hartmann), iris matrices are row major
+        const auto clip = camera->projection() * camera->view();
+        const auto row = [&clip](std::size_t index, float sign) {
+            return std::array<float, 4u>{
+                clip[12u] + sign * clip[index * 4u],
+                clip[13u] + sign * clip[index * 4u + 1u],
+                clip[14u] + sign * clip[index * 4u + 2u],
+                clip[15u] + sign * clip[index * 4u + 3u]};
+        };
+
+        for (std::size_t i = 0u; i < frustum_.size(); ++i)
+        {
+            const auto [a, b, c, d] = row(i / 2u, (i % 2u == 0u) ? 1.0f : -1.0f);
+            const iris::Vector3 normal{a, b, c};
+            const auto length = normal.magnitude();
+            frustum_[i] = {.normal = normal / length, .distance = d / length};
+        }
+
+        has_frustum_ = true;
+    }
+
+    const auto half_cell = cell_size_ * 0.5f;
+    std::size_t visible_cells = 0u;
+    std::size_t visible_entities = global_entities_.size();
+
+    for (auto &[key, cell] : cells_)
+    {
+        const auto &[x, z] = key;
+        const auto half_height = (cell.max_y - cell.min_y) * 0.5f;
+        const iris::Vector3 centre{
+            (static_cast<float>(x) + 0.5f) * cell_size_,
+            cell.min_y + half_height,
+            (static_cast<float>(z) + 0.5f) * cell_size_};
+        const auto radius =
+            std::sqrt((2.0f * half_cell * half_cell) + (half_height * half_height)) + cell.max_radius;
+
+        if (is_near_player(key) || in_frustum(centre, radius))
+        {
+            cell.last_visible = updates_;
+
+            if (cell.entities.empty())
+            {
+                create_entities(cell.instances, cell.entities);
+                ++cells_shown_;
+            }
+        }
+        else if (!cell.entities.empty() && ((updates_ - cell.last_visible) > hide_delay))
+        {
+            for (auto *entity : cell.entities)
+            {
+                scene_->remove(entity);
+            }
+
+            cell.entities.clear();
+        }
+
+        if (!cell.entities.empty())
+        {
+            ++visible_cells;
+            visible_entities += cell.entities.size();
+        }
+    }
+
+    visible_cells_total_ += visible_cells;
+    visible_entities_total_ += visible_entities;
+}
+
+bool ZoneCells::is_active(const iris::Vector3 &position) const
+{
+    if (!enabled_)
+    {
+        return true;
+    }
+
+    return is_near_player(cell_key(position)) || in_frustum(position, cell_size_ * 0.5f);
+}
+
+void ZoneCells::record_objects(std::size_t active, std::size_t total)
+{
+    active_objects_total_ += active;
+    objects_total_ += total;
+}
+
+void ZoneCells::log_stats() const
+{
+    if (updates_ == 0u)
+    {
+        return;
+    }
+
+    const auto average = [this](std::uint64_t total) {
+        return static_cast<double>(total) / static_cast<double>(updates_);
+    };
+
+    LOG_INFO(
+        "zone",
+        "cells: {:.1f}/{} visible, {:.1f} entities, {:.1f}/{:.1f} objects updated (averages), {} cells shown",
+        average(visible_cells_total_),
+        cells_.size(),
+        average(visible_entities_total_),
+        average(active_objects_total_),
+        average(objects_total_),
+        cells_shown_);
+}
+
+std::tuple<std::int32_t, std::int32_t> ZoneCells::cell_key(const iris::Vector3 &position) const
+{
+    return {
+        static_cast<std::int32_t>(std::floor(position.x / cell_size_)),
+        static_cast<std::int32_t>(std::floor(position.z / cell_size_))};
+}
+
+bool ZoneCells::is_near_player(const std::tuple<std::int32_t, std::int32_t> &key) const
+{
+    const auto &[x, z] = key;
+    const auto &[player_x, player_z] = player_cell_;
+
+    return (std::abs(x - player_x) <= active_radius_) && (std::abs(z - player_z) <= active_radius_);
+}
+
+bool ZoneCells::in_frustum(const iris::Vector3 &centre, float radius) const
+{
+    if (!has_frustum_)
+    {
+        return false;
+    }
+
+    return std::ranges::all_of(
+        frustum_, [&](const Plane &plane) { return (plane.normal.dot(centre) + plane.distance) >= -radius; });
+}
+
+void ZoneCells::create_entities(
+    const std::map<std::tuple<const iris::Mesh *, iris::RenderGraph *>, std::vector<iris::Transform>> &instances,
+    std::vector<iris::RenderEntity *> &entities)
+{
+    if (scene_ == nullptr)
+    {
+        return;
+    }
+
+    for (const auto &[key, transforms] : instances)
+    {
+        const auto &[mesh, render_graph] = key;
+
+        if (transforms.size() == 1u)
+        {
+            entities.emplace_back(scene_->create_entity<iris::SingleEntity>(render_graph, mesh, transforms.front()));
+        }
+        else
+        {
+            entities.emplace_back(scene_->create_entity<iris::InstancedEntity>(render_graph, mesh, transforms));
+        }
+    }
+}
+
+}
@@ -0,0 +1,495 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+// Offline tool which cooks zone YAML files into the binary format loaded by BinaryZoneLoader.
+//
+// usage: trinket_zone_cook <resource root> <zone file>...
+//
+// Each zone file (relative to the resource root) is written alongside itself with a .zone extension. Meshes are loaded
+// so their bounding boxes can be precomputed, so this has to be run with the same assets the game uses.
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "iris/core/error_handling.h"
+#include "iris/core/quaternion.h"
+#include "iris/core/resource_loader.h"
+#include "iris/core/root.h"
+#include "iris/core/start.h"
+#include "iris/core/vector3.h"
+#include "iris/graphics/mesh_manager.h"
+
+#include "yaml-cpp/yaml.h"
+
+#include "mesh_bounds.h"
+#include "native_ai.h"
+#include "zone_format.h"
+
+namespace
+{
+
+trinket::ZoneVector3 get_vector3(const YAML::Node &node)
+{
+    return {node[0].as<float>(), node[1].as<float>(), node[2].as<float>()};
+}
+
+trinket::ZoneQuaternion get_quaternion(const YAML::Node &node)
+{
+    // zone files store euler angles, convert once here rather than every load
+    const iris::Quaternion quaternion{node[0].as<float>(), node[1].as<float>(), node[2].as<float>()};
+    return {quaternion.x, quaternion.y, quaternion.z, quaternion.w};
+}
+
+/**
+ * Compute the bounding box of a mesh.
+ *
+ * @param mesh
+ *   Mesh to compute bounds of.
+ *
+ * @returns
+ *   Bounding box in mesh space.
+ */
+trinket::ZoneMeshPart bounding_box(const iris::Mesh *mesh)
+{
+    const auto [min, max] = trinket::mesh_bounds(mesh);
+    return {.min = {min.x, min.y, min.z}, .max = {max.x, max.y, max.z}};
+}
+
+/**
+ * Accumulates the records for a zone and writes them in the cooked format.
+ */
+class ZoneWriter
+{
+  public:
+    /**
+     * Cook a zone.
+     *
+     * @param zone
+     *   Parsed zone YAML.
+     */
+    explicit ZoneWriter(const YAML::Node &zone)
+        : header_()
+        , meshes_()
+        , parts_()
+        , textures_()
+        , groups_()
+        , bodies_()
+        , enemies_()
+        , resource_files_()
+        , strings_()
+        , string_lookup_()
+        , mesh_lookup_()
+        , texture_lookup_()
+    {
+        header_.magic = trinket::zone_file_magic;
+        header_.version = trinket::zone_file_version;
+        header_.name = add_string(zone["name"].as<std::string>());
+        header_.player_start_position = get_vector3(zone["player_start_position"]);
+        header_.portal_position = get_vector3(zone["portal"]["position"]);
+        header_.portal_scale = get_vector3(zone["portal"]["scale"]);
+        header_.portal_destination = add_string(zone["portal"]["destination"].as<std::string>());
+
+        std::set<std::string> files{};
+
+        for (const auto &geometry : zone["static_geometry"])
+        {
+            add_geometry(geometry, files);
+        }
+
+        for (const auto &enemy : zone["enemies"])
+        {
+            add_enemy(enemy, files);
+        }
+
+        for (const auto &file : files)
+        {
+            resource_files_.emplace_back(add_string(file));
+        }
+    }
+
+    /**
+     * Write the cooked zone.
+     *
+     * @param path
+     *   File to write to.
+     */
+    void write(const std::filesystem::path &path)
+    {
+        // flatten instance groups, std::map ordering means the same YAML always cooks to the same file
+        std::vector<trinket::ZoneInstanceGroup> groups{};
+        std::vector<trinket::ZoneInstance> instances{};
+
+        for (const auto &[key, group_instances] : groups_)
+        {
+            const auto &[mesh, part, texture, normal, texture_scale] = key;
+            groups.push_back(
+                {.mesh = mesh,
+                 .part = part,
+                 .texture = texture,
+                 .normal = normal,
+                 .texture_scale = texture_scale,
+                 .first_instance = static_cast<std::uint32_t>(instances.size()),
+                 .instance_count = static_cast<std::uint32_t>(group_instances.size())});
+            instances.insert(std::end(instances), std::cbegin(group_instances), std::cend(group_instances));
+        }
+
+        // every record is a multiple of 4 bytes, so laying sections out back to back keeps them aligned
+        std::uint32_t offset = sizeof(trinket::ZoneFileHeader);
+        header_.meshes = place(meshes_, offset);
+        header_.parts = place(parts_, offset);
+        header_.textures = place(textures_, offset);
+        header_.instance_groups = place(groups, offset);
+        header_.instances = place(instances, offset);
+        header_.bodies = place(bodies_, offset);
+        header_.enemies = place(enemies_, offset);
+        header_.resource_files = place(resource_files_, offset);
+        header_.strings = {.offset = offset, .count = static_cast<std::uint32_t>(strings_.size())};
+        header_.file_size = offset + static_cast<std::uint32_t>(strings_.size());
+
+        std::ofstream out{path, std::ios::binary};
+        iris::ensure(out.is_open(), "could not open output file");
+
+        out.write(reinterpret_cast<const char *>(&header_), sizeof(header_));
+        write_section(out, meshes_);
+        write_section(out, parts_);
+        write_section(out, textures_);
+        write_section(out, groups);
+        write_section(out, instances);
+        write_section(out, bodies_);
+        write_section(out, enemies_);
+        write_section(out, resource_files_);
+        out.write(strings_.data(), strings_.size());
+
+        iris::ensure(out.good(), "failed to write zone file");
+
+        std::cout << path.string() << ": " << meshes_.size() << " meshes, " << textures_.size() << " textures, "
+                  << groups.size() << " instance groups (" << instances.size() << " instances), " << bodies_.size()
+                  << " bodies, " << enemies_.size() << " enemies, " << header_.file_size << " bytes" << std::endl;
+    }
+
+  private:
+    /** Key for instance groups: mesh, part, texture, normal, texture scale. */
+    using GroupKey = std::tuple<std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t, float>;
+
+    /**
+     * Add a static geometry node.
+     *
+     * @param geometry
+     *   Geometry YAML node.
+     *
+     * @param files
+     *   Collection of resource files to add to.
+     */
+    void add_geometry(const YAML::Node &geometry, std::set<std::string> &files)
+    {
+        const auto position = get_vector3(geometry["position"]);
+        const auto orientation = get_quaternion(geometry["orientation"]);
+        const auto scale = get_vector3(geometry["scale"]);
+        const auto mesh_type = geometry["mesh_type"].as<std::string>();
+
+        if (mesh_type != "cube")
+        {
+            files.emplace(mesh_type);
+        }
+
+        const auto mesh_index = add_mesh(mesh_type);
+        const auto &mesh = meshes_[mesh_index];
+
+        // scaled textures are loaded by name (i.e. with the default sampler), others are sampled nearest
+        const auto texture_scale = geometry["texture_scale"] ? geometry["texture_scale"].as<float>() : 0.0f;
+        const auto sampler = geometry["texture_scale"] ? trinket::ZoneSampler::DEFAULT : trinket::ZoneSampler::NEAREST;
+
+        auto normal = trinket::zone_no_texture;
+        if (geometry["normal"])
+        {
+            const auto normal_name = geometry["normal"].as<std::string>();
+            files.emplace(normal_name);
+            normal = add_texture(normal_name, trinket::ZoneSampler::DEFAULT);
+        }
+
+        const auto rigid_body = geometry["rigid_body"].as<bool>();
+        const auto bounding_box_body =
+            rigid_body && (geometry["rigid_body_type"].as<std::string>() == "bounding_box");
+
+        for (auto part = 0u; part < mesh.part_count; ++part)
+        {
+            // there is a texture per part
+            auto texture = trinket::zone_no_texture;
+            auto part_normal = trinket::zone_no_texture;
+            if (geometry["texture"])
+            {
+                const auto texture_name = geometry["texture"][part].as<std::string>();
+                files.emplace(texture_name);
+                texture = add_texture(texture_name, sampler);
+                part_normal = normal;
+            }
+
+            groups_[{mesh_index, part, texture, part_normal, texture_scale}].push_back(
+                {.position = position, .orientation = orientation, .scale = scale});
+
+            if (rigid_body)
+            {
+                const auto &bounds = parts_[mesh.first_part + part];
+
+                bodies_.push_back(
+                    {.name = add_string(mesh_type),
+                     .shape = bounding_box_body ? trinket::ZoneShape::BOX : trinket::ZoneShape::MESH,
+                     .mesh = mesh_index,
+                     .part = part,
+                     .position = position,
+                     .orientation = orientation,
+                     .scale = scale,
+                     .half_extents = {
+                         (bounds.max.x - bounds.min.x) * 0.5f * scale.x,
+                         (bounds.max.y - bounds.min.y) * 0.5f * scale.y,
+                         (bounds.max.z - bounds.min.z) * 0.5f * scale.z}});
+            }
+        }
+    }
+
+    /**
+     * Add an enemy node.
+     *
+     * @param enemy
+     *   Enemy YAML node.
+     *
+     * @param files
+     *   Collection of resource files to add to.
+     */
+    void add_enemy(const YAML::Node &enemy, std::set<std::string> &files)
+    {
+        const auto mesh_name = enemy["mesh"].as<std::string>();
+        const auto texture_name = enemy["texture"].as<std::string>();
+        const auto script_name = enemy["script"].as<std::string>();
+
+        files.emplace(mesh_name);
+        files.emplace(texture_name);
+
+        if (!trinket::is_native_ai(script_name))
+        {
+            files.emplace(script_name);
+        }
+
+        enemies_.push_back(
+            {.position = get_vector3(enemy["position"]),
+             .orientation = get_quaternion(enemy["orientation"]),
+             .scale = get_vector3(enemy["scale"]),
+             .bounds_min = get_vector3(enemy["bounds_min"]),
+             .bounds_max = get_vector3(enemy["bounds_max"]),
+             .mesh = add_string(mesh_name),
+             .texture = add_texture(texture_name, trinket::ZoneSampler::DEFAULT),
+             .script = add_string(script_name)});
+    }
+
+    /**
+     * Add a mesh (if not already added), loading it to compute the bounds of its parts.
+     *
+     * @param mesh_type
+     *   Mesh resource name, or "cube".
+     *
+     * @returns
+     *   Index of mesh.
+     */
+    std::uint32_t add_mesh(const std::string &mesh_type)
+    {
+        if (const auto mesh = mesh_lookup_.find(mesh_type); mesh != std::cend(mesh_lookup_))
+        {
+            return mesh->second;
+        }
+
+        trinket::ZoneMesh mesh{
+            .name = {},
+            .kind = trinket::ZoneMeshKind::CUBE,
+            .first_part = static_cast<std::uint32_t>(parts_.size()),
+            .part_count = 1u};
+
+        if (mesh_type == "cube")
+        {
+            parts_.emplace_back(bounding_box(iris::Root::mesh_manager().cube({})));
+        }
+        else
+        {
+            mesh.name = add_string(mesh_type);
+            mesh.kind = trinket::ZoneMeshKind::FILE;
+
+            const auto mesh_data = iris::Root::mesh_manager().load_mesh(mesh_type);
+            mesh.part_count = static_cast<std::uint32_t>(mesh_data.mesh_data.size());
+
+            for (const auto &part : mesh_data.mesh_data)
+            {
+                parts_.emplace_back(bounding_box(part.mesh));
+            }
+        }
+
+        const auto index = static_cast<std::uint32_t>(meshes_.size());
+        meshes_.emplace_back(mesh);
+        mesh_lookup_.emplace(mesh_type, index);
+
+        return index;
+    }
+
+    /**
+     * Add a texture (if not already added).
+     *
+     * @param name
+     *   Texture resource name.
+     *
+     * @param sampler
+     *   Sampler texture is loaded with.
+     *
+     * @returns
+     *   Index of texture.
+     */
+    std::uint32_t add_texture(const std::string &name, trinket::ZoneSampler sampler)
+    {
+        const auto [texture, inserted] =
+            texture_lookup_.try_emplace({name, sampler}, static_cast<std::uint32_t>(textures_.size()));
+
+        if (inserted)
+        {
+            textures_.push_back({.name = add_string(name), .sampler = sampler});
+        }
+
+        return texture->second;
+    }
+
+    /**
+     * Add a string (if not already added).
+     *
+     * @param str
+     *   String to add.
+     *
+     * @returns
+     *   Reference to string.
+     */
+    trinket::ZoneString add_string(const std::string &str)
+    {
+        const auto [entry, inserted] = string_lookup_.try_emplace(
+            str,
+            trinket::ZoneString{
+                .offset = static_cast<std::uint32_t>(strings_.size()),
+                .length = static_cast<std::uint32_t>(str.size())});
+
+        if (inserted)
+        {
+            strings_.append(str);
+        }
+
+        return entry->second;
+    }
+
+    /**
+     * Assign a section its place in the file.
+     *
+     * @param records
+     *   Records in section.
+     *
+     * @param offset
+     *   Offset of section, will be advanced past it.
+     *
+     * @returns
+     *   Section.
+     */
+    template <class T>
+    static trinket::ZoneSection place(const std::vector<T> &records, std::uint32_t &offset)
+    {
+        const trinket::ZoneSection section{.offset = offset, .count = static_cast<std::uint32_t>(records.size())};
+        offset += static_cast<std::uint32_t>(records.size() * sizeof(T));
+
+        return section;
+    }
+
+    /**
+     * Write the records of a section.
+     *
+     * @param out
+     *   Stream to write to.
+     *
+     * @param records
+     *   Records to write.
+     */
+    template <class T>
+    static void write_section(std::ofstream &out, const std::vector<T> &records)
+    {
+        out.write(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(T));
+    }
+
+    /** Header, sections are filled in when writing. */
+    trinket::ZoneFileHeader header_;
+
+    /** Mesh records. */
+    std::vector<trinket::ZoneMesh> meshes_;
+
+    /** Mesh part records. */
+    std::vector<trinket::ZoneMeshPart> parts_;
+
+    /** Texture records. */
+    std::vector<trinket::ZoneTexture> textures_;
+
+    /** Instances, grouped by mesh part and material. */
+    std::map<GroupKey, std::vector<trinket::ZoneInstance>> groups_;
+
+    /** Body records. */
+    std::vector<trinket::ZoneBody> bodies_;
+
+    /** Enemy records. */
+    std::vector<trinket::ZoneEnemy> enemies_;
+
+    /** Resource file records. */
+    std::vector<trinket::ZoneString> resource_files_;
+
+    /** String data. */
+    std::string strings_;
+
+    /** Map of added strings to their reference. */
+    std::unordered_map<std::string, trinket::ZoneString> string_lookup_;
+
+    /** Map of mesh type to mesh index. */
+    std::unordered_map<std::string, std::uint32_t> mesh_lookup_;
+
+    /** Map of texture name and sampler to texture index. */
+    std::map<std::tuple<std::string, trinket::ZoneSampler>, std::uint32_t> texture_lookup_;
+};
+
+void cook(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "usage: trinket_zone_cook <resource root> <zone file>..." << std::endl;
+        return;
+    }
+
+    const std::filesystem::path resource_root{argv[1]};
+    iris::ResourceLoader::instance().set_root_directory(resource_root.string());
+
+    for (auto i = 2; i < argc; ++i)
+    {
+        const std::filesystem::path zone_file{argv[i]};
+
+        const auto zone_data = iris::ResourceLoader::instance().load(zone_file.string());
+        const std::string zone_str(reinterpret_cast<const char *>(zone_data.data()), zone_data.size());
+
+        ZoneWriter writer{::YAML::Load(zone_str)};
+        writer.write(resource_root / std::filesystem::path{zone_file}.replace_extension(".zone"));
+    }
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    iris::start(argc, argv, cook);
+    return 0;
+}
@@ -0,0 +1,249 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "zone_preloader.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "iris/log/log.h"
+
+#include "job_system.h"
+#include "profiler.h"
+#include "zone_loader.h"
+
+namespace
+{
+
+/** Size of chunks files are read in. */
+constexpr std::size_t read_chunk_size = 64u * 1024u;
+
+/**
+ * Read a file, we don't keep the data as reading it is enough to get it into the OS file cache.
+ *
+ * @param path
+ *   Path of file to read.
+ *
+ * @param buffer
+ *   Buffer to read chunks into.
+ *
+ * @returns
+ *   Number of bytes read.
+ */
+std::uint64_t read_file(const std::filesystem::path &path, std::span<char> buffer)
+{
+    std::uint64_t bytes_read = 0u;
+
+    std::ifstream in{path, std::ios::binary};
+    while (in.read(buffer.data(), buffer.size()) || (in.gcount() != 0))
+    {
+        bytes_read += static_cast<std::uint64_t>(in.gcount());
+    }
+
+    return bytes_read;
+}
+
+}
+
+namespace trinket
+{
+
+ZonePreloader::ZonePreloader(const std::filesystem::path &resource_root)
+    : resource_root_(resource_root)
+    , zone_(nullptr)
+    , warmed_(false)
+    , start_()
+    , frames_(0u)
+    , mutex_()
+    , wake_()
+    , pending_files_()
+    , generation_(0u)
+    , files_read_(false)
+    , bytes_read_(0u)
+    , read_end_()
+    , stop_(false)
+    , thread_()
+{
+    // start thread last, so it only sees a fully constructed object
+    thread_ = std::thread{[this] { read_loop(); }};
+}
+
+ZonePreloader::~ZonePreloader()
+{
+    {
+        std::scoped_lock lock{mutex_};
+        stop_ = true;
+    }
+
+    wake_.notify_one();
+    thread_.join();
+}
+
+void ZonePreloader::preload(ZoneLoader *zone)
+{
+    zone_ = zone;
+    zone_->begin_preload();
+    warmed_ = false;
+    start_ = std::chrono::steady_clock::now();
+    frames_ = 0u;
+
+    auto files = zone_->resource_files();
+
+    {
+        std::scoped_lock lock{mutex_};
+
+        ++generation_;
+        files_read_ = files.empty();
+        bytes_read_ = 0u;
+        read_end_ = start_;
+        pending_files_ = std::move(files);
+    }
+
+    wake_.notify_one();
+}
+
+void ZonePreloader::update(std::chrono::microseconds budget)
+{
+    if ((zone_ == nullptr) || warmed_)
+    {
+        return;
+    }
+
+    std::uint64_t bytes_read = 0u;
+    std::chrono::steady_clock::time_point read_end{};
+
+    {
+        std::scoped_lock lock{mutex_};
+
+        // wait for files to be read, engine loading would otherwise block on the disk
+        if (!files_read_)
+        {
+            return;
+        }
+
+        bytes_read = bytes_read_;
+        read_end = read_end_;
+    }
+
+    ++frames_;
+
+    const auto start = std::chrono::steady_clock::now();
+    auto more = true;
+
+    do
+    {
+        TRINKET_PROFILE_SCOPE("preload_step");
+        more = zone_->preload_step();
+    } while (more && ((std::chrono::steady_clock::now() - start) < budget));
+
+    if (!more)
+    {
+        warmed_ = true;
+
+        const auto now = std::chrono::steady_clock::now();
+        LOG_INFO(
+            "zone",
+            "preloaded {}: read {} bytes in {}ms, warmed caches over {} frames, ready after {}ms",
+            zone_->name(),
+            bytes_read,
+            std::chrono::duration_cast<std::chrono::milliseconds>(read_end - start_).count(),
+            frames_,
+            std::chrono::duration_cast<std::chrono::milliseconds>(now - start_).count());
+    }
+}
+
+void ZonePreloader::read_now(ZoneLoader *zone, JobSystem &jobs)
+{
+    const auto files = zone->resource_files();
+    const auto start = std::chrono::steady_clock::now();
+    std::atomic<std::uint64_t> bytes_read{0u};
+
+    jobs.parallel_for(files.size(), 1u, [this, &files, &bytes_read](std::size_t index) {
+        TRINKET_PROFILE_SCOPE("zone_read");
+        std::vector<char> buffer(read_chunk_size);
+        bytes_read += read_file(resource_root_ / files[index], buffer);
+    });
+
+    LOG_INFO(
+        "zone",
+        "{}: read {} bytes from {} files in {}ms ({} threads)",
+        zone->name(),
+        bytes_read.load(),
+        files.size(),
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count(),
+        jobs.worker_count() + 1u);
+}
+
+bool ZonePreloader::is_preloaded(const ZoneLoader *zone) const
+{
+    return (zone == zone_) && warmed_;
+}
+
+void ZonePreloader::read_loop()
+{
+    std::array<char, read_chunk_size> buffer{};
+
+    for (;;)
+    {
+        std::vector<std::string> files{};
+        std::uint64_t generation = 0u;
+
+        {
+            std::unique_lock lock{mutex_};
+            wake_.wait(lock, [this] { return stop_ || !pending_files_.empty(); });
+
+            if (stop_)
+            {
+                return;
+            }
+
+            files = std::move(pending_files_);
+            pending_files_.clear();
+            generation = generation_;
+        }
+
+        std::uint64_t bytes_read = 0u;
+        auto abandoned = false;
+
+        for (const auto &file : files)
+        {
+            {
+                // stop early if we are shutting down or a different zone has been requested
+                std::scoped_lock lock{mutex_};
+                if (stop_ || (generation != generation_))
+                {
+                    abandoned = true;
+                    break;
+                }
+            }
+
+            TRINKET_PROFILE_SCOPE("preload_read");
+            bytes_read += read_file(resource_root_ / file, buffer);
+        }
+
+        if (!abandoned)
+        {
+            std::scoped_lock lock{mutex_};
+            if (generation == generation_)
+            {
+                files_read_ = true;
+                bytes_read_ = bytes_read;
+                read_end_ = std::chrono::steady_clock::now();
+            }
+        }
+    }
+}
+
+}
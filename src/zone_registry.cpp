@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////
+//         Distributed under the Boost Software License, Version 1.0.         //
+//            (See accompanying file LICENSE or copy at                       //
+//                 https://www.boost.org/LICENSE_1_0.txt)                     //
+////////////////////////////////////////////////////////////////////////////////
+
+#include "zone_registry.h"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "iris/core/error_handling.h"
+#include "iris/log/log.h"
+
+#include "binary_zone_loader.h"
+#include "yaml_zone_loader.h"
+#include "zone_loader.h"
+
+namespace trinket
+{
+
+ZoneRegistry::ZoneRegistry(
+    const std::filesystem::path &resource_root,
+    const std::map<std::string, std::string> &zone_files,
+    bool merge_static_bodies)
+    : resource_root_(resource_root)
+    , merge_static_bodies_(merge_static_bodies)
+    , zones_()
+{
+    for (const auto &[name, file] : zone_files)
+    {
+        zones_.emplace(name, Entry{.file = file, .loader = nullptr});
+    }
+}
+
+ZoneLoader *ZoneRegistry::zone(const std::string &name)
+{
+    const auto entry = zones_.find(name);
+    iris::ensure(entry != std::end(zones_), "missing zone");
+
+    auto &[file, loader] = entry->second;
+
+    if (loader == nullptr)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        if (std::filesystem::path{file}.extension() == ".zone")
+        {
+            loader = std::make_unique<BinaryZoneLoader>(resource_root_ / file, merge_static_bodies_);
+        }
+        else
+        {
+            loader = std::make_unique<YamlZoneLoader>(file, merge_static_bodies_);
+        }
+
+        iris::ensure(loader->name() == name, "zone name does not match manifest");
+
+        LOG_INFO(
+            "zone",
+            "opened {} ({}) in {}us",
+            name,
+            file,
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    return loader.get();
+}
+
+std::size_t ZoneRegistry::size() const
+{
+    return zones_.size();
+}
+
+}